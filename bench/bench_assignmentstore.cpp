@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include <memory>
+#include <vector>
+
+// Build and tear down a plan in the arena-backed store
+static void BM_StoreBuildAndRelease(benchmark::State& state) {
+    const auto source = makeSyntheticAssignments(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        Planner::AssignmentStore store;
+        for (Planner::AssignmentHandle handle : source.handles())
+            store.emplace(source[handle]);
+        benchmark::DoNotOptimize(store.size());
+    }
+}
+BENCHMARK(BM_StoreBuildAndRelease)->Arg(10000)->Arg(100000);
+
+// The same plan as individually allocated shared_ptrs, as used previously
+static void BM_SharedPtrBuildAndRelease(benchmark::State& state) {
+    const auto source = makeSyntheticAssignments(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        std::vector<std::shared_ptr<Assignment>> assignments;
+        for (Planner::AssignmentHandle handle : source.handles())
+            assignments.push_back(std::make_shared<Assignment>(source[handle]));
+        benchmark::DoNotOptimize(assignments.size());
+    }
+}
+BENCHMARK(BM_SharedPtrBuildAndRelease)->Arg(10000)->Arg(100000);
+
+// Queue churn per scheduled hour: handles versus shared_ptr copies
+static void BM_HandleQueueChurn(benchmark::State& state) {
+    const auto store = makeSyntheticAssignments(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        std::vector<Planner::AssignmentHandle> copy(store.handles());
+        benchmark::DoNotOptimize(copy.data());
+    }
+}
+BENCHMARK(BM_HandleQueueChurn)->Arg(10000);
+
+static void BM_SharedPtrQueueChurn(benchmark::State& state) {
+    const auto store = makeSyntheticAssignments(static_cast<int>(state.range(0)));
+    std::vector<std::shared_ptr<Assignment>> assignments;
+    for (Planner::AssignmentHandle handle : store.handles())
+        assignments.push_back(std::make_shared<Assignment>(store[handle]));
+
+    for (auto _ : state) {
+        std::vector<std::shared_ptr<Assignment>> copy(assignments);
+        benchmark::DoNotOptimize(copy.data());
+    }
+}
+BENCHMARK(BM_SharedPtrQueueChurn)->Arg(10000);
@@ -0,0 +1,55 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "../include/availability.hpp"
+#include "../include/calendar.hpp"
+#include "../include/simulation.hpp"
+#include <random>
+#include <vector>
+
+// A semester of recurring commitments: short classes and shifts spread over the week
+static Planner::Availability makeSemester(int commitments, int firstDay) {
+    Planner::Availability availability;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> weekday(0, 6);
+    std::uniform_int_distribution<int> start(8 * 60, 22 * 60);
+    std::uniform_int_distribution<int> length(30, 180);
+
+    for (int i = 0; i < commitments; ++i) {
+        int from = start(rng);
+        availability.addWeekly(weekday(rng), from, from + length(rng), firstDay, firstDay + 120);
+    }
+    return availability;
+}
+
+// Free study hours for every day of a semester
+static void BM_FreeStudyHours(benchmark::State& state) {
+    const int firstDay = Planner::today();
+    auto availability = makeSemester(static_cast<int>(state.range(0)), firstDay);
+    std::vector<int> hours;
+
+    for (auto _ : state) {
+        int total = 0;
+        for (int day = 0; day < 120; ++day)
+            total += availability.freeStudyHours(firstDay + day, 6, hours);
+        benchmark::DoNotOptimize(total);
+    }
+}
+BENCHMARK(BM_FreeStudyHours)->Arg(10)->Arg(300)->Arg(3000);
+
+// Full simulation planning around a semester of commitments
+static void BM_SimulateWithAvailability(benchmark::State& state) {
+    auto assignments = makeSyntheticAssignments(1000);
+    auto availability = makeSemester(static_cast<int>(state.range(0)), Planner::today());
+
+    Planner::ScheduleOptions options;
+    options.weekdayStudyHours = 8;
+    options.weekendStudyHours = 10;
+    options.availability = &availability;
+    options.startDay = Planner::today();
+
+    for (auto _ : state) {
+        auto items = Planner::makeWorkItems(assignments);
+        benchmark::DoNotOptimize(Planner::simulate(items, options));
+    }
+}
+BENCHMARK(BM_SimulateWithAvailability)->Arg(0)->Arg(300);
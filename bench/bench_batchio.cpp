@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "../include/batchio.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+    const char* BatchDirectory = "bench_batchio";
+    constexpr int UserCount = 1000;
+
+    std::vector<std::string> userPaths() {
+        std::vector<std::string> paths;
+        for (int user = 0; user < UserCount; ++user)
+            paths.push_back(std::string(BatchDirectory) + "/user_" + std::to_string(user) + ".json");
+        return paths;
+    }
+
+    // Write the users once, flushed so their pages can be dropped
+    std::vector<std::string> writeUsers() {
+        std::filesystem::create_directory(BatchDirectory);
+        std::vector<std::string> paths = userPaths();
+        for (std::size_t user = 0; user < paths.size(); ++user)
+            Planner::saveToFile(paths[user], makeSyntheticAssignments(25, static_cast<unsigned>(user)));
+        sync();
+        return paths;
+    }
+
+    // Drop the files from the page cache so the next read goes to the disk
+    void evict(const std::vector<std::string>& paths) {
+        for (const std::string& path : paths) {
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd >= 0) {
+                posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+                close(fd);
+            }
+        }
+    }
+
+    Planner::IoBackend backendOf(int mode) {
+        return mode == 2 ? Planner::IoBackend::Uring : Planner::IoBackend::Stream;
+    }
+}
+
+// Load every user: loadFromFile per file (0), batched over iostreams (1)
+// or batched over io_uring (2), from a warm or cold (1) page cache
+static void BM_LoadUsers(benchmark::State& state) {
+    const int mode = static_cast<int>(state.range(0));
+    if (mode == 2 && !Planner::uringAvailable()) {
+        state.SkipWithError("io_uring is not available");
+        return;
+    }
+    std::vector<std::string> paths = writeUsers();
+
+    for (auto _ : state) {
+        if (state.range(1)) {
+            state.PauseTiming();
+            evict(paths);
+            state.ResumeTiming();
+        }
+
+        std::size_t loaded = 0;
+        if (mode == 0) {
+            for (const std::string& path : paths)
+                loaded += Planner::loadFromFile(path).size();
+        } else {
+            Planner::BatchReader reader(paths, backendOf(mode));
+            Planner::FileData file;
+            while (reader.next(file))
+                loaded += Planner::parsePlanFile(file.data).size();
+        }
+        benchmark::DoNotOptimize(loaded);
+    }
+
+    state.counters["files_per_second"] = benchmark::Counter(UserCount, benchmark::Counter::kIsIterationInvariantRate);
+    std::filesystem::remove_all(BatchDirectory);
+}
+BENCHMARK(BM_LoadUsers)->ArgsProduct({{0, 1, 2}, {0, 1}})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Save every user: saveToFile per file (0), batched over iostreams (1) or
+// batched over io_uring (2)
+static void BM_SaveUsers(benchmark::State& state) {
+    const int mode = static_cast<int>(state.range(0));
+    if (mode == 2 && !Planner::uringAvailable()) {
+        state.SkipWithError("io_uring is not available");
+        return;
+    }
+    std::filesystem::create_directory(BatchDirectory);
+    std::vector<std::string> paths = userPaths();
+    auto assignments = makeSyntheticAssignments(25);
+
+    for (auto _ : state) {
+        if (mode == 0) {
+            for (const std::string& path : paths)
+                Planner::saveToFile(path, assignments);
+        } else {
+            Planner::BatchWriter writer(backendOf(mode));
+            for (const std::string& path : paths)
+                writer.add(path, Planner::formatPlanFile(assignments));
+            benchmark::DoNotOptimize(writer.finish());
+        }
+    }
+
+    state.counters["files_per_second"] = benchmark::Counter(UserCount, benchmark::Counter::kIsIterationInvariantRate);
+    std::filesystem::remove_all(BatchDirectory);
+}
+BENCHMARK(BM_SaveUsers)->DenseRange(0, 2)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,44 @@
+#include <benchmark/benchmark.h>
+#include "../include/capacity.hpp"
+#include "../include/calendar.hpp"
+#include "../include/simulation.hpp"
+#include <random>
+
+// Capacity between two days of a year-long plan: prefix sums (0) against
+// adding up the day-counter rule (1)
+static void BM_HoursBetween(benchmark::State& state) {
+    auto table = Planner::calendarCapacity(Planner::today(), 3, 6, {}, 365);
+    std::mt19937 rng(42);
+    std::vector<std::pair<int, int>> ranges(1024);
+    for (auto& range : ranges) {
+        range.first = 1 + static_cast<int>(rng() % 365);
+        range.second = range.first + static_cast<int>(rng() % 120);
+    }
+
+    std::size_t next = 0;
+    for (auto _ : state) {
+        const auto& range = ranges[next++ % ranges.size()];
+        long long hours = 0;
+        if (state.range(0)) {
+            for (int day = range.first; day <= range.second; ++day)
+                hours += Planner::studyHoursForDay(day, 3, 6);
+        } else {
+            hours = table.hoursBetween(range.first, range.second);
+        }
+        benchmark::DoNotOptimize(hours);
+    }
+}
+BENCHMARK(BM_HoursBetween)->Arg(0)->Arg(1);
+
+// Building a year of capacities with a term's worth of holidays
+static void BM_BuildCalendarCapacity(benchmark::State& state) {
+    std::vector<Planner::Holiday> holidays;
+    for (int i = 0; i < 20; ++i)
+        holidays.push_back({Planner::today() + 1 + i * 17, 0});
+
+    for (auto _ : state) {
+        auto table = Planner::calendarCapacity(Planner::today(), 3, 6, holidays, 365);
+        benchmark::DoNotOptimize(table.hoursThrough(365));
+    }
+}
+BENCHMARK(BM_BuildCalendarCapacity);
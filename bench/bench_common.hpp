@@ -0,0 +1,32 @@
+#ifndef BENCH_COMMON_HPP
+#define BENCH_COMMON_HPP
+
+#include "../include/planner.hpp"
+#include <random>
+#include <string>
+
+// Deterministic synthetic cohort of assignments for benchmarks
+inline Planner::AssignmentStore makeSyntheticAssignments(int count, unsigned seed = 42, int maxDeadline = 60) {
+    static const char* subjects[] = {"Math", "Physics", "Chemistry", "History", "Programming", "Literature"};
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> subjectDist(0, 5);
+    std::uniform_int_distribution<int> deadlineDist(1, maxDeadline);
+    std::uniform_int_distribution<int> durationDist(1, 20);
+    std::uniform_real_distribution<float> weightDist(5.0f, 30.0f);
+    std::uniform_int_distribution<int> sizeDist(1, 3);
+    std::uniform_int_distribution<int> groupDist(0, 4);
+    std::uniform_int_distribution<int> groupSizeDist(2, 5);
+
+    Planner::AssignmentStore assignments;
+    for (int i = 0; i < count; ++i) {
+        bool groupWork = groupDist(rng) == 0;
+        assignments.emplace(subjects[subjectDist(rng)], "Assignment " + std::to_string(i), deadlineDist(rng),
+                            durationDist(rng), weightDist(rng), sizeDist(rng), groupWork,
+                            groupWork ? groupSizeDist(rng) : 1);
+    }
+
+    return assignments;
+}
+
+#endif // BENCH_COMMON_HPP
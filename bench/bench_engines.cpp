@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "../include/simulation.hpp"
+
+// Runtime and plan quality of each engine on the same synthetic cohort.
+// Arguments are {assignments, latest deadline in days, daily study hours};
+// missed deadlines, lateness hours and the worst lateness in days are
+// reported as counters.
+static void runEngine(benchmark::State& state, Planner::SchedulerEngine engine) {
+    const int count = static_cast<int>(state.range(0));
+    auto assignments = makeSyntheticAssignments(count, 7, static_cast<int>(state.range(1)));
+    const auto baseItems = Planner::makeWorkItems(assignments);
+    const int studyHours = static_cast<int>(state.range(2));
+
+    Planner::ScheduleStats stats;
+    for (auto _ : state) {
+        auto items = baseItems;
+        stats = Planner::simulate(items, studyHours, studyHours, engine);
+        benchmark::DoNotOptimize(stats);
+    }
+
+    state.counters["missed"] = stats.missedDeadlines;
+    state.counters["missed_pct"] = 100.0 * stats.missedDeadlines / count;
+    state.counters["lateness_h"] = stats.totalLateness;
+    state.counters["max_late_days"] = stats.maxLateness;
+}
+
+static void BM_PriorityEngine(benchmark::State& state) {
+    runEngine(state, Planner::SchedulerEngine::Priority);
+}
+
+static void BM_EarliestDeadlineEngine(benchmark::State& state) {
+    runEngine(state, Planner::SchedulerEngine::EarliestDeadline);
+}
+
+// A semester-long student plan from comfortable to overloaded, then a large cohort
+#define ENGINE_COHORTS(bench)                                                        \
+    BENCHMARK(bench)->Args({100, 120, 10})->Args({100, 120, 8})->Args({100, 120, 6}) \
+        ->Args({2000, 3650, 8})
+
+ENGINE_COHORTS(BM_PriorityEngine);
+ENGINE_COHORTS(BM_EarliestDeadlineEngine);
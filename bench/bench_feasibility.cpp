@@ -0,0 +1,35 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "../include/feasibility.hpp"
+#include "../include/simulation.hpp"
+
+// Feasibility oracle for one budget
+static void BM_IsFeasible(benchmark::State& state) {
+    auto assignments = makeSyntheticAssignments(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Planner::isFeasible(assignments, 8, 10));
+    }
+}
+BENCHMARK(BM_IsFeasible)->Arg(1000)->Arg(10000);
+
+// Full simulation answering the same question for comparison
+static void BM_SimulateForFeasibility(benchmark::State& state) {
+    auto assignments = makeSyntheticAssignments(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        auto items = Planner::makeWorkItems(assignments);
+        benchmark::DoNotOptimize(Planner::simulate(items, 8, 10).missedDeadlines == 0);
+    }
+}
+BENCHMARK(BM_SimulateForFeasibility)->Arg(1000)->Arg(10000);
+
+// Binary search for the smallest daily budget
+static void BM_MinimalBudget(benchmark::State& state) {
+    auto assignments = makeSyntheticAssignments(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Planner::minimalBudget(assignments));
+    }
+}
+BENCHMARK(BM_MinimalBudget)->Arg(1000)->Arg(10000);
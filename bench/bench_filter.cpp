@@ -0,0 +1,37 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "../include/filter.hpp"
+
+// A compound filter over a large store: the compiled program over columns
+// (0) against testing each assignment object in turn (1)
+static void BM_FilterScan(benchmark::State& state) {
+    auto assignments = makeSyntheticAssignments(static_cast<int>(state.range(1)), 42, 120);
+    auto columns = Planner::makeAssignmentColumns(assignments);
+    Planner::AssignmentFilter filter("deadline < 30 && weight >= 15 && size != 2");
+    const int elapsed = Planner::today() - assignments.epochDay();
+
+    for (auto _ : state) {
+        std::size_t matches = 0;
+        if (state.range(0)) {
+            for (Planner::AssignmentHandle handle : assignments.handles()) {
+                const Assignment& assignment = assignments[handle];
+                matches += assignment.getDeadline() - elapsed < 30 && assignment.getWeight() >= 15 && assignment.getSize() != 2;
+            }
+        } else {
+            matches = filter.select(columns).size();
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+}
+BENCHMARK(BM_FilterScan)->ArgsProduct({{0, 1}, {100000, 1000000}})->Unit(benchmark::kMillisecond);
+
+// A filter narrowed by the deadline index
+static void BM_FilterIndexed(benchmark::State& state) {
+    auto assignments = makeSyntheticAssignments(1000000, 42, 120);
+    auto columns = Planner::makeAssignmentColumns(assignments);
+    Planner::AssignmentFilter filter("deadline == 3 && weight >= 15");
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(filter.select(columns).size());
+}
+BENCHMARK(BM_FilterIndexed)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,26 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "../include/focus.hpp"
+
+// What to work on today: the top-k query (0) against pulling day 1 from
+// the generator (1), which rescores and heaps every assignment
+static void BM_TodaysFocus(benchmark::State& state) {
+    auto assignments = makeSyntheticAssignments(static_cast<int>(state.range(1)), 42, 120);
+    Planner::ScheduleOptions options;
+    options.weekdayStudyHours = 6;
+    options.weekendStudyHours = 8;
+
+    for (auto _ : state) {
+        std::size_t picked = 0;
+        if (state.range(0)) {
+            Planner::ScheduleGenerator generator(assignments, options);
+            Planner::ScheduleDay day;
+            generator.next(day);
+            picked = day.slots.size();
+        } else {
+            picked = Planner::todaysFocus(assignments, options).size();
+        }
+        benchmark::DoNotOptimize(picked);
+    }
+}
+BENCHMARK(BM_TodaysFocus)->ArgsProduct({{0, 1}, {1000, 10000}})->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,30 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "../include/simulation.hpp"
+
+// Plan of the next 7 days of a semester: pulled from the generator (0) or
+// read off a full simulation (1)
+static void BM_WeekAhead(benchmark::State& state) {
+    auto assignments = makeSyntheticAssignments(static_cast<int>(state.range(1)), 42, 120);
+    Planner::ScheduleOptions options;
+    options.weekdayStudyHours = 6;
+    options.weekendStudyHours = 8;
+
+    for (auto _ : state) {
+        std::size_t slots = 0;
+        if (state.range(0)) {
+            auto items = Planner::makeWorkItems(assignments);
+            Planner::SchedulePlan plan;
+            Planner::simulate(items, options, &plan);
+            for (const auto& slot : plan.slots)
+                slots += slot.day <= 7;
+        } else {
+            Planner::ScheduleGenerator generator(assignments, options);
+            Planner::ScheduleDay day;
+            while (day.day < 7 && generator.next(day))
+                slots += day.slots.size();
+        }
+        benchmark::DoNotOptimize(slots);
+    }
+}
+BENCHMARK(BM_WeekAhead)->ArgsProduct({{0, 1}, {200, 2000}});
@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "../include/groupslots.hpp"
+#include <random>
+
+// Shared sessions for a group over a 16-week term: every member's mask is
+// built from their availability, intersected, and 20 group assignments placed
+static void BM_PlanGroupSessions(benchmark::State& state) {
+    std::mt19937 rng(42);
+    std::vector<Planner::Availability> members(static_cast<std::size_t>(state.range(0)));
+    for (auto& member : members) {
+        for (int i = 0; i < 10; ++i) {
+            int start = static_cast<int>(rng() % 20) + 8;
+            member.addWeekly(static_cast<int>(rng() % 7), start * 60, (start + 2) * 60);
+        }
+    }
+    std::vector<const Planner::Availability*> pointers;
+    for (const auto& member : members)
+        pointers.push_back(&member);
+
+    Planner::AssignmentStore assignments;
+    for (int i = 0; i < 20; ++i)
+        assignments.emplace("Group", "Project " + std::to_string(i), 5 + i * 5, 12, 10.0f, 2, true, 2);
+
+    for (auto _ : state) {
+        auto plan = Planner::planGroupSessions(assignments, pointers, Planner::today() + 1);
+        benchmark::DoNotOptimize(plan.sessions.data());
+    }
+}
+BENCHMARK(BM_PlanGroupSessions)->Arg(2)->Arg(6)->Unit(benchmark::kMicrosecond);
+
+// Intersection alone, for masks built once
+static void BM_CommonFreeHours(benchmark::State& state) {
+    std::mt19937 rng(7);
+    std::vector<Planner::HourMask> masks;
+    for (int member = 0; member < 6; ++member) {
+        masks.emplace_back(0, Planner::DefaultTermWeeks);
+        for (int hour = 0; hour < masks.back().hours(); ++hour)
+            masks.back().setFree(hour, rng() % 4 != 0);
+    }
+
+    for (auto _ : state) {
+        auto common = Planner::commonFreeHours(masks);
+        benchmark::DoNotOptimize(common.count());
+    }
+}
+BENCHMARK(BM_CommonFreeHours);
@@ -0,0 +1,21 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+// Save then load a user file plain (0) or gzip-compressed (1), reporting
+// the bytes that land on disk
+static void BM_SaveLoadCompression(benchmark::State& state) {
+    auto assignments = makeSyntheticAssignments(static_cast<int>(state.range(1)));
+    const std::string filename = state.range(0) ? "bench_gzipstream.json.gz" : "bench_gzipstream.json";
+
+    for (auto _ : state) {
+        Planner::saveToFile(filename, assignments);
+        benchmark::DoNotOptimize(Planner::loadFromFile(filename));
+    }
+
+    state.counters["file_bytes"] = static_cast<double>(std::filesystem::file_size(filename));
+    std::remove(filename.c_str());
+}
+BENCHMARK(BM_SaveLoadCompression)->ArgsProduct({{0, 1}, {1000, 100000}})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,36 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "../include/icsexport.hpp"
+#include "../include/simulation.hpp"
+#include <sstream>
+
+// Feed generation for one plan: arg 0 selects per-hour events (0),
+// coalesced blocks (1) or blocks plus daily rules (2); arg 1 the engine
+static void BM_WriteCalendar(benchmark::State& state) {
+    auto assignments = makeSyntheticAssignments(300);
+    auto engine = state.range(1) ? Planner::SchedulerEngine::EarliestDeadline : Planner::SchedulerEngine::Priority;
+
+    auto items = Planner::makeWorkItems(assignments);
+    Planner::SchedulePlan plan;
+    Planner::simulate(items, 6, 8, engine, &plan);
+
+    Planner::CalendarOptions options;
+    options.coalesce = state.range(0) >= 1;
+    options.dailyRules = state.range(0) >= 2;
+
+    std::size_t bytes = 0;
+    std::size_t events = 0;
+    for (auto _ : state) {
+        auto calendar = Planner::planEvents(assignments, plan, 20000, options);
+        std::ostringstream output;
+        Planner::writeCalendar(output, calendar, 1);
+        bytes = output.str().size();
+        events = calendar.size();
+        benchmark::DoNotOptimize(bytes);
+    }
+
+    state.counters["bytes"] = static_cast<double>(bytes);
+    state.counters["events"] = static_cast<double>(events);
+    state.counters["hours"] = static_cast<double>(plan.slots.size());
+}
+BENCHMARK(BM_WriteCalendar)->ArgsProduct({{0, 1, 2}, {0, 1}})->Unit(benchmark::kMicrosecond);
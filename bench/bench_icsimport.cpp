@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include "../include/icsimport.hpp"
+#include "../include/calendar.hpp"
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+
+// Busy calendar of roughly the requested size: mostly single events, some
+// weekly classes and some counted daily rules, with folded descriptions
+static std::string makeCalendar(std::size_t bytes) {
+    std::string calendar = "BEGIN:VCALENDAR\r\nVERSION:2.0\r\nPRODID:-//Bench//EN\r\n";
+    calendar.reserve(bytes + 1024);
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> dayOffset(-400, 400);
+    std::uniform_int_distribution<int> hour(7, 21);
+    std::uniform_int_distribution<int> kind(0, 19);
+
+    char buffer[512];
+    int year, month, day;
+    const int base = Planner::dayNumber(2024, 9, 2);
+    for (int i = 0; calendar.size() < bytes; ++i) {
+        Planner::civilFromDayNumber(base + dayOffset(rng), year, month, day);
+        int start = hour(rng);
+        int k = kind(rng);
+        const char* rule = k < 3 ? "RRULE:FREQ=WEEKLY;BYDAY=MO,WE,FR;UNTIL=20250131T235959Z\r\n"
+                         : k < 4 ? "RRULE:FREQ=DAILY;COUNT=10\r\n" : "";
+
+        std::snprintf(buffer, sizeof(buffer),
+                      "BEGIN:VEVENT\r\nUID:event-%d@bench\r\nSUMMARY:Event %d\r\n"
+                      "DESCRIPTION:Lecture notes and reading for this session are posted on th\r\n"
+                      " e course page ahead of time.\r\n"
+                      "DTSTART:%04d%02d%02dT%02d0000\r\nDTEND:%04d%02d%02dT%02d3000\r\n%s"
+                      "BEGIN:VALARM\r\nTRIGGER:-PT10M\r\nACTION:DISPLAY\r\nEND:VALARM\r\nEND:VEVENT\r\n",
+                      i, i, year, month, day, start, year, month, day, start + 1, rule);
+        calendar += buffer;
+    }
+
+    calendar += "END:VCALENDAR\r\n";
+    return calendar;
+}
+
+// Import throughput on a 50 MB calendar, planning one semester ahead
+static void BM_ImportICS(benchmark::State& state) {
+    const std::string calendar = makeCalendar(static_cast<std::size_t>(state.range(0)) << 20);
+    const int firstDay = Planner::dayNumber(2024, 9, 2);
+
+    Planner::IcsImportStats stats;
+    for (auto _ : state) {
+        std::istringstream input(calendar);
+        Planner::Availability availability;
+        stats = Planner::importICS(input, availability, firstDay, firstDay + 120);
+        benchmark::DoNotOptimize(availability.busyCount());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(calendar.size()));
+    state.counters["events"] = static_cast<double>(stats.events);
+    state.counters["occurrences"] = static_cast<double>(stats.occurrences);
+    state.counters["weekly"] = static_cast<double>(stats.weeklyPatterns);
+}
+BENCHMARK(BM_ImportICS)->Arg(50)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,23 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "../include/lazyplan.hpp"
+#include <cstdio>
+
+// Time to first menu: open a plan lazily (0) or load it in full (1)
+static void BM_OpenPlan(benchmark::State& state) {
+    const char* filename = "bench_lazyplan.db";
+    std::remove(filename);
+    Planner::UserDatabase database(filename);
+    Planner::saveToFile(database, "user", makeSyntheticAssignments(static_cast<int>(state.range(1))));
+
+    for (auto _ : state) {
+        if (state.range(0)) {
+            benchmark::DoNotOptimize(Planner::loadFromFile(database, "user").size());
+        } else {
+            Planner::LazyPlan plan(database, "user");
+            benchmark::DoNotOptimize(plan.size());
+        }
+    }
+    std::remove(filename);
+}
+BENCHMARK(BM_OpenPlan)->ArgsProduct({{0, 1}, {100, 10000, 100000}});
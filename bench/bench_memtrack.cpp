@@ -0,0 +1,48 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "../include/memtrack.hpp"
+#include "../include/icsexport.hpp"
+#include "../include/simulation.hpp"
+#include <cstdio>
+#include <sstream>
+
+namespace {
+    // Per-iteration allocation count and peak bytes of one phase as counters
+    void reportPhase(benchmark::State& state, Planner::MemoryTag tag) {
+        Planner::MemoryUsage usage = Planner::memoryUsage(tag);
+        std::string name = Planner::memoryTagName(tag);
+        state.counters[name + "_allocs"] =
+            benchmark::Counter(static_cast<double>(usage.allocations), benchmark::Counter::kAvgIterations);
+        state.counters[name + "_bytes"] =
+            benchmark::Counter(static_cast<double>(usage.bytesAllocated), benchmark::Counter::kAvgIterations);
+        state.counters[name + "_peak"] = static_cast<double>(usage.peakBytes);
+    }
+}
+
+// Heap usage of the load -> schedule -> ICS -> save pipeline, per phase
+static void BM_PipelineMemory(benchmark::State& state) {
+    const std::string filename = "bench_memtrack.json";
+    Planner::saveToFile(filename, makeSyntheticAssignments(static_cast<int>(state.range(0))));
+
+    Planner::startMemoryTracking();
+    for (auto _ : state) {
+        auto assignments = Planner::loadFromFile(filename);
+        auto items = Planner::makeWorkItems(assignments);
+        Planner::SchedulePlan plan;
+        Planner::ScheduleOptions options;
+        options.weekdayStudyHours = 6;
+        options.weekendStudyHours = 8;
+        auto stats = Planner::simulate(items, options, &plan);
+        auto events = Planner::planEvents(assignments, plan, 0);
+        std::ostringstream calendar;
+        Planner::writeCalendar(calendar, events, 1);
+        Planner::saveToFile(filename, assignments);
+        benchmark::DoNotOptimize(stats);
+    }
+    Planner::stopMemoryTracking();
+    std::remove(filename.c_str());
+
+    for (auto tag : {Planner::MemoryTag::Load, Planner::MemoryTag::Schedule, Planner::MemoryTag::Ics, Planner::MemoryTag::Save})
+        reportPhase(state, tag);
+}
+BENCHMARK(BM_PipelineMemory)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,27 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "../include/persistence.hpp"
+#include <cstdio>
+
+// Time a menu operation waits for its save: written in place (0) or handed
+// to the persistence thread (1)
+static void BM_SavePlan(benchmark::State& state) {
+    const char* filename = "bench_persistence.db";
+    std::remove(filename);
+    {
+        Planner::UserDatabase database(filename);
+        Planner::PersistenceWriter writer(database);
+        Planner::AssignmentStore assignments = makeSyntheticAssignments(static_cast<int>(state.range(1)));
+
+        for (auto _ : state) {
+            if (state.range(0))
+                writer.savePlan("user", assignments);
+            else
+                Planner::saveToFile(database, "user", assignments);
+        }
+        writer.drain();
+        state.counters["writes"] = static_cast<double>(state.range(0) ? writer.writeCount() : state.iterations());
+    }
+    std::remove(filename);
+}
+BENCHMARK(BM_SavePlan)->ArgsProduct({{0, 1}, {100, 10000}});
@@ -0,0 +1,25 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "../include/sweep.hpp"
+
+// Single simulated run over a synthetic cohort
+static void BM_Simulate(benchmark::State& state) {
+    auto assignments = makeSyntheticAssignments(static_cast<int>(state.range(0)));
+    const auto baseItems = Planner::makeWorkItems(assignments);
+
+    for (auto _ : state) {
+        auto items = baseItems;
+        benchmark::DoNotOptimize(Planner::simulate(items, 4, 6));
+    }
+}
+BENCHMARK(BM_Simulate)->Arg(100)->Arg(1000)->Arg(10000);
+
+// Full 24x24 budget sweep, the target is well under a second for 1,000 assignments
+static void BM_SweepStudyHours(benchmark::State& state) {
+    auto assignments = makeSyntheticAssignments(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Planner::sweepStudyHours(assignments, 24, 24));
+    }
+}
+BENCHMARK(BM_SweepStudyHours)->Arg(1000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+#include "../include/textindex.hpp"
+#include <random>
+#include <string>
+
+namespace {
+    // A million names in the style users give them, across many users
+    const Planner::TextIndex& corpus() {
+        static const Planner::TextIndex index = [] {
+            static const char* kinds[] = {"Lab", "Project", "Essay", "Homework", "Quiz prep", "Problem set",
+                                          "Reading", "Presentation", "Report", "Midterm review"};
+            static const char* topics[] = {"optics", "thermodynamics", "algebra", "calculus", "Rome", "genetics",
+                                            "databases", "poetry", "statistics", "circuits", "ecology", "ethics"};
+            static const char* subjects[] = {"Math", "Physics", "Chemistry", "History", "Programming", "Literature"};
+            std::mt19937 rng(42);
+            Planner::TextIndex built;
+            for (std::uint32_t id = 0; id < 1000000; ++id) {
+                std::string text = std::string(kinds[rng() % 10]) + " " + std::to_string(rng() % 20) + " " +
+                                   topics[rng() % 12] + " / " + subjects[rng() % 6];
+                built.add(id, text);
+            }
+            return built;
+        }();
+        return index;
+    }
+}
+
+// Substring queries over a 1M-assignment corpus, from rare to common
+static void BM_TextSearch(benchmark::State& state) {
+    static const char* queries[] = {"lab 3 optics", "thermo", "proj"};
+    const auto& index = corpus();
+    const char* query = queries[state.range(0)];
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(index.search(query).size());
+    state.SetLabel(query);
+}
+BENCHMARK(BM_TextSearch)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+// Misspelt queries over the same corpus
+static void BM_TextSearchFuzzy(benchmark::State& state) {
+    static const char* queries[] = {"thermodynamcis", "presentaton"};
+    const auto& index = corpus();
+    const char* query = queries[state.range(0)];
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(index.searchFuzzy(query).size());
+    state.SetLabel(query);
+}
+BENCHMARK(BM_TextSearchFuzzy)->DenseRange(0, 1)->Unit(benchmark::kMicrosecond);
+
+// Adding and removing single assignments in a large index
+static void BM_TextIndexUpdate(benchmark::State& state) {
+    Planner::TextIndex index;
+    for (std::uint32_t id = 0; id < 100000; ++id)
+        index.add(id, "Homework " + std::to_string(id) + " / Math");
+
+    std::uint32_t next = 100000;
+    for (auto _ : state) {
+        index.add(next, "Lab " + std::to_string(next) + " / Physics");
+        index.remove(next - 100000);
+        ++next;
+    }
+}
+BENCHMARK(BM_TextIndexUpdate);
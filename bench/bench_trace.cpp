@@ -0,0 +1,19 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "../include/simulation.hpp"
+#include "../include/trace.hpp"
+
+// Simulation with tracing off (0) and on (1), to keep span overhead in check
+static void BM_SimulateTracing(benchmark::State& state) {
+    auto assignments = makeSyntheticAssignments(static_cast<int>(state.range(1)));
+    if (state.range(0))
+        Planner::startTracing();
+
+    for (auto _ : state) {
+        auto items = Planner::makeWorkItems(assignments);
+        benchmark::DoNotOptimize(Planner::simulate(items, 8, 10));
+    }
+
+    Planner::stopTracing();
+}
+BENCHMARK(BM_SimulateTracing)->ArgsProduct({{0, 1}, {100, 1000, 10000}});
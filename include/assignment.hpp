@@ -8,7 +8,7 @@ class Assignment {
 private:
     std::string subject;
     std::string name;
-    int deadline; // Remaining days to complete the assignment
+    int deadline; // Due day, counted in days from the plan epoch
     int duration; // Total required hours to complete the assignment
     float weight; // Importance of the assignment
     int size; // Size of the assignment or team (if group work)
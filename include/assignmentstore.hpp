@@ -0,0 +1,85 @@
+#ifndef ASSIGNMENTSTORE_HPP
+#define ASSIGNMENTSTORE_HPP
+
+#include "assignment.hpp"
+#include "calendar.hpp"
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Planner {
+    // Trivially copyable reference to an assignment owned by an AssignmentStore
+    using AssignmentHandle = std::uint32_t;
+
+    // Owns a user's assignments in fixed-size arena chunks. Handles stay valid
+    // until the assignment is removed; freed slots are reused by later adds.
+    // Deadlines are day numbers counted from the store's plan epoch.
+    class AssignmentStore {
+    public:
+        AssignmentStore() : epoch(today()) {}
+        ~AssignmentStore();
+
+        AssignmentStore(const AssignmentStore&) = delete;
+        AssignmentStore& operator=(const AssignmentStore&) = delete;
+
+        AssignmentStore(AssignmentStore&& other) noexcept;
+        AssignmentStore& operator=(AssignmentStore&& other) noexcept;
+
+        // Construct a new assignment in place and return its handle
+        template <typename... Args>
+        AssignmentHandle emplace(Args&&... args) {
+            AssignmentHandle handle = allocateSlot();
+            new (slot(handle)) Assignment(std::forward<Args>(args)...);
+            order.push_back(handle);
+            return handle;
+        }
+
+        // Destroy an assignment and recycle its slot
+        void remove(AssignmentHandle handle);
+
+        // Destroy every assignment and release the arena in one go
+        void clear();
+
+        // Access an assignment by handle
+        Assignment& get(AssignmentHandle handle) { return *slot(handle); }
+        const Assignment& get(AssignmentHandle handle) const { return *slot(handle); }
+        Assignment& operator[](AssignmentHandle handle) { return get(handle); }
+        const Assignment& operator[](AssignmentHandle handle) const { return get(handle); }
+
+        // Live handles in insertion order
+        const std::vector<AssignmentHandle>& handles() const { return order; }
+
+        std::size_t size() const { return order.size(); }
+        bool empty() const { return order.empty(); }
+
+        // Plan epoch as days since 1970-01-01; deadlines count from this day
+        int epochDay() const { return epoch; }
+        void setEpochDay(int day) { epoch = day; }
+
+        // Move the epoch, shifting every deadline so due dates stay the same
+        void rebase(int newEpochDay);
+
+    private:
+        static constexpr std::size_t ChunkSize = 256; // Assignments per arena chunk
+
+        struct Chunk {
+            alignas(Assignment) unsigned char storage[ChunkSize * sizeof(Assignment)];
+        };
+
+        AssignmentHandle allocateSlot();
+
+        Assignment* slot(AssignmentHandle handle) const {
+            return reinterpret_cast<Assignment*>(chunks[handle / ChunkSize]->storage) + handle % ChunkSize;
+        }
+
+        std::vector<std::unique_ptr<Chunk>> chunks;
+        std::vector<AssignmentHandle> freeSlots; // Slots released by remove()
+        std::vector<AssignmentHandle> order; // Order index of live assignments
+        AssignmentHandle nextSlot = 0; // First never-used slot
+        int epoch; // Plan epoch, days since 1970-01-01
+    };
+}
+
+#endif // ASSIGNMENTSTORE_HPP
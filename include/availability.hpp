@@ -0,0 +1,144 @@
+#ifndef AVAILABILITY_HPP
+#define AVAILABILITY_HPP
+
+#include <climits>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Planner {
+    // Clock hour the study window opens when no availability is configured
+    constexpr int DefaultStudyStartHour = 18;
+
+    constexpr int MinutesPerDay = 24 * 60;
+
+    // Absolute local minute of a clock hour, which may pass 24, on a day number
+    constexpr long long minuteAt(int dayNumber, int hour) {
+        return static_cast<long long>(dayNumber) * MinutesPerDay + hour * 60LL;
+    }
+
+    // A user's busy time: recurring weekly commitments (classes, shifts) and
+    // one-off events. Times are local; an absolute time is a day number times
+    // MinutesPerDay plus the minute of the day. Recurring commitments are kept
+    // as a single weekly pattern and are never expanded into occurrences.
+    class Availability {
+    public:
+        // A busy interval. Weekly ones count minutes from Monday 00:00 and
+        // never cross midnight; one-off ones use absolute local minutes.
+        struct Interval {
+            long long start;
+            long long end;
+            int firstDay; // Validity of a weekly commitment, by day number
+            int lastDay;
+        };
+
+        Availability();
+
+        // Commitments added while a Batch is alive are sorted once when it
+        // ends instead of one insert at a time; for loads and imports. The
+        // availability must not be queried until the batch has ended.
+        class Batch {
+        public:
+            explicit Batch(Availability& availability);
+            ~Batch();
+
+            Batch(const Batch&) = delete;
+            Batch& operator=(const Batch&) = delete;
+
+        private:
+            Availability& availability;
+        };
+
+        // Busy every week on weekday (0 = Monday .. 6 = Sunday) between two
+        // minutes of the day, for day numbers in [firstDay, lastDay]. The end
+        // may pass midnight, in which case the commitment runs into the next day.
+        void addWeekly(int weekday, int startMinute, int endMinute, int firstDay = INT_MIN, int lastDay = INT_MAX);
+
+        // Busy once between two absolute local times
+        void addBusy(long long start, long long end);
+
+        // Busy once, set aside under a tag such as the sessions of a group
+        // assignment, so everything reserved under it can be replaced later
+        void reserve(const std::string& tag, long long start, long long end);
+
+        // Drop every reservation made under tag
+        void release(const std::string& tag);
+
+        // Minutes reserved under tag
+        long long reservedMinutes(const std::string& tag) const;
+
+        // Reservations by tag, each in the order they were made
+        const std::map<std::string, std::vector<Interval>>& reservations() const { return tagged; }
+
+        // Remove every commitment
+        void clear();
+
+        // Clock hours during which study may be planned; the end may pass 24
+        void setStudyWindow(int startHour, int endHour);
+        int studyWindowStart() const { return windowStart; }
+        int studyWindowEnd() const { return windowEnd; }
+
+        // True if no commitment overlaps [start, end)
+        bool isFree(long long start, long long end) const;
+
+        // Fill startHours with the clock hours (counted from midnight of the
+        // day, possibly past 24) of up to maxHours free one-hour slots in the
+        // study window of a day, earliest first. Returns how many were found.
+        int freeStudyHours(int dayNumber, int maxHours, std::vector<int>& startHours) const;
+
+        // Stored commitments, sorted by start
+        const std::vector<Interval>& weeklyIntervals() const { return weekly.all(); }
+        const std::vector<Interval>& busyIntervals() const { return once.all(); }
+
+        std::size_t weeklyCount() const { return weekly.size(); }
+        std::size_t busyCount() const { return once.size(); }
+        bool empty() const { return weekly.size() == 0 && once.size() == 0 && tagged.empty(); }
+
+        // Weekday of a day number, 0 = Monday
+        static int weekdayOf(int dayNumber);
+
+    private:
+        // Sorted interval set with a running maximum of interval ends, so an
+        // overlap query is a binary search plus a walk over true candidates.
+        // Intervals are put in order as they are added, or at build() after
+        // defer(), so queries never modify it and may run from several
+        // threads at once.
+        class IntervalIndex {
+        public:
+            void add(const Interval& interval);
+            void clear();
+
+            // Append without sorting until build()
+            void defer() { deferred = true; }
+            void build();
+
+            std::size_t size() const { return intervals.size(); }
+
+            // True if an interval valid on the given day overlaps [start, end)
+            bool overlaps(long long start, long long end, int dayNumber) const;
+
+            const std::vector<Interval>& all() const { return intervals; }
+
+        private:
+            std::vector<Interval> intervals;
+            std::vector<long long> maxEnd; // maxEnd[i] = max end of intervals[0..i]
+            bool deferred = false;
+        };
+
+        IntervalIndex weekly; // Minutes since Monday 00:00, split at midnight
+        IntervalIndex once; // Absolute local minutes
+        IntervalIndex reserved; // Absolute local minutes of every reservation
+        std::map<std::string, std::vector<Interval>> tagged;
+        int windowStart;
+        int windowEnd;
+    };
+
+    // Load a user's availability; a missing file means no commitments
+    Availability loadAvailability(const std::string& filename);
+
+    // Save a user's availability. Returns false if the file cannot be written.
+    bool saveAvailability(const std::string& filename, const Availability& availability);
+}
+
+#endif // AVAILABILITY_HPP
@@ -0,0 +1,87 @@
+#ifndef BATCHIO_HPP
+#define BATCHIO_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Reading and writing many small files at once, for batch runs over
+// thousands of users. On Linux the opens, reads and writes go to the
+// kernel in batches through io_uring, with one registered buffer per
+// request in flight; elsewhere, or where io_uring is refused, the files
+// go through iostreams one at a time.
+namespace Planner {
+    enum class IoBackend {
+        Auto, // io_uring where the kernel allows it, iostreams otherwise
+        Uring,
+        Stream
+    };
+
+    // True if io_uring can be used by this process
+    bool uringAvailable();
+
+    const char* ioBackendName(IoBackend backend);
+
+    // A file read by a BatchReader
+    struct FileData {
+        std::size_t index = 0; // Position of the path in the reader's list
+        std::string path;
+        std::string data;
+        bool ok = false; // False if the file could not be opened or read
+    };
+
+    // Reads a list of files with up to depth of them in flight. Files are
+    // handed out as they complete, and the next reads are already queued
+    // by then, so parsing one file overlaps with reading the following ones.
+    class BatchReader {
+    public:
+        explicit BatchReader(std::vector<std::string> paths, IoBackend backend = IoBackend::Auto, unsigned depth = 64);
+        ~BatchReader();
+
+        BatchReader(const BatchReader&) = delete;
+        BatchReader& operator=(const BatchReader&) = delete;
+
+        // Next completed file, in completion order. Returns false once
+        // every file has been handed out.
+        bool next(FileData& file);
+
+        // Backend in use; Uring falls back to Stream if it is unavailable
+        IoBackend backend() const;
+
+    private:
+        struct State;
+        std::unique_ptr<State> state;
+    };
+
+    // Writes files with up to depth of them in flight. add() returns once
+    // the write is queued; finish() waits for all of them.
+    class BatchWriter {
+    public:
+        explicit BatchWriter(IoBackend backend = IoBackend::Auto, unsigned depth = 64);
+
+        // Waits for queued writes
+        ~BatchWriter();
+
+        BatchWriter(const BatchWriter&) = delete;
+        BatchWriter& operator=(const BatchWriter&) = delete;
+
+        // Create or truncate path and write data to it
+        void add(const std::string& path, std::string data);
+
+        // Wait until every queued write is done. Returns the number of
+        // files that could not be written so far.
+        std::size_t finish();
+
+        // Paths that could not be written, in the order they failed
+        const std::vector<std::string>& failures() const;
+
+        IoBackend backend() const;
+
+    private:
+        struct State;
+        std::unique_ptr<State> state;
+    };
+}
+
+#endif // BATCHIO_HPP
@@ -0,0 +1,24 @@
+#ifndef CALENDAR_HPP
+#define CALENDAR_HPP
+
+#include <ctime>
+
+// Calendar day arithmetic shared by the planner
+namespace Planner {
+    // Days since 1970-01-01 for a calendar date (month 1-12)
+    int dayNumber(int year, int month, int day);
+
+    // Calendar date (month 1-12) of a day count since 1970-01-01
+    void civilFromDayNumber(int dayNumber, int& year, int& month, int& day);
+
+    // Days in a month of a year (month 1-12)
+    int daysInMonth(int year, int month);
+
+    // Days since 1970-01-01 for the local date in a broken-down time
+    int dayNumber(const std::tm& date);
+
+    // Days since 1970-01-01 for the current local date
+    int today();
+}
+
+#endif // CALENDAR_HPP
@@ -0,0 +1,71 @@
+#ifndef CAPACITY_HPP
+#define CAPACITY_HPP
+
+#include <array>
+#include <string>
+#include <vector>
+
+// Study hours per day of a plan, worked out once for a horizon so the
+// scheduler and the feasibility checks only look them up
+namespace Planner {
+    // A date with its own study budget, such as a public holiday or an exam day
+    struct Holiday {
+        int day; // Day number (days since 1970-01-01)
+        int hours; // Study hours that day
+    };
+
+    // Study hours of day 1, 2, ... of a plan, with a running total so the
+    // capacity of any range of days is one subtraction. Days past the
+    // horizon follow the table's repeating rule, so lookups never fail.
+    class CapacityTable {
+    public:
+        // The planner's original rule on the plan's own day counter: days
+        // with day % 6 == 0 or day % 7 == 0 get the weekend hours
+        static CapacityTable legacy(int weekdayStudyHours, int weekendStudyHours, int horizon = 0);
+
+        // Real dates: day d of the plan is day number startDay + d and gets
+        // the hours of its weekday (weeklyHours[0] is Monday), unless it is
+        // one of the holidays
+        static CapacityTable calendar(int startDay, const std::array<int, 7>& weeklyHours,
+                                      const std::vector<Holiday>& holidays, int horizon);
+
+        // Hours on day day of the plan; none before day 1
+        int hoursFor(int day) const;
+
+        // Hours over days 1 to day
+        long long hoursThrough(int day) const;
+
+        // Hours over days first to last, both included
+        long long hoursBetween(int first, int last) const {
+            return last < first ? 0 : hoursThrough(last) - hoursThrough(first - 1);
+        }
+
+        // Last day held in the table
+        int horizon() const { return static_cast<int>(hours.size()) - 1; }
+
+    private:
+        CapacityTable(std::vector<int> pattern, int phase, int horizon);
+
+        // Sum of the repeating rule over its first n positions from the start of a cycle
+        long long cycleSum(long long n) const;
+        int patternHours(int day) const;
+        void finish();
+
+        std::vector<int> hours; // hours[d] for days 0 to the horizon; day 0 is empty
+        std::vector<long long> prefix; // prefix[d] = hours of days 1 to d
+        std::vector<int> pattern; // Rule past the horizon, day d at (d + phase) % pattern.size()
+        std::vector<long long> patternPrefix; // patternPrefix[i] = sum of pattern[0..i)
+        int phase;
+    };
+
+    // Capacity on real dates with weekday hours Monday to Friday and weekend
+    // hours on Saturday and Sunday
+    CapacityTable calendarCapacity(int startDay, int weekdayStudyHours, int weekendStudyHours,
+                                   const std::vector<Holiday>& holidays, int horizon);
+
+    // Holidays from a text file of "YYYY-MM-DD hours" lines; a missing
+    // hours value means no study that day. A missing file means no holidays.
+    std::vector<Holiday> loadHolidays(const std::string& filename);
+}
+
+#endif // CAPACITY_HPP
@@ -2,28 +2,51 @@
 #define DISPLAYFUNCTIONS_HPP
 
 #include <vector>
-#include <memory>
 #include <string>
 #include "assignment.hpp"
+#include "assignmentstore.hpp"
+#include "sweep.hpp"
+#include "focus.hpp"
+#include "groupslots.hpp"
+#include "textindex.hpp"
 
 class DisplayFunctions {
 public:
-    using AssignmentPtr = std::shared_ptr<Assignment>;
-
     // Display menu options for assignments
-    static void displayMenu(const std::vector<AssignmentPtr>& assignments);
+    static void displayMenu(const Planner::AssignmentStore& assignments);
 
     // Display all assignments
-    static void displayAllAssignments(const std::vector<AssignmentPtr>& assignments);
+    static void displayAllAssignments(const Planner::AssignmentStore& assignments);
 
     // Display assignments filtered by subject
-    static void displayAssignmentsBySubject(const std::vector<AssignmentPtr>& assignments, const std::string& subject);
+    static void displayAssignmentsBySubject(const Planner::AssignmentStore& assignments, const std::string& subject);
+
+    // Display assignments matching a filter expression such as
+    // "deadline < 7 && weight >= 15 && group_work"
+    static void displayAssignmentsMatching(const Planner::AssignmentStore& assignments, const std::string& expression);
+
+    // Display assignments whose name or subject contains query, or the
+    // closest ones if none does. The index holds the store's handles.
+    static void displaySearchResults(const Planner::AssignmentStore& assignments, const Planner::TextIndex& index,
+                                     const std::string& query);
 
     // Display assignments sorted by shortest deadline
-    static void displayAssignmentsByShortestDeadline(const std::vector<AssignmentPtr>& assignments);
+    static void displayAssignmentsByShortestDeadline(const Planner::AssignmentStore& assignments);
 
     // Display assignments sorted by biggest duration
-    static void displayAssignmentsByBiggestDuration(const std::vector<AssignmentPtr>& assignments);
+    static void displayAssignmentsByBiggestDuration(const Planner::AssignmentStore& assignments);
+
+    // Display a study-hour sweep as a grid of missed deadlines
+    static void displaySweepResult(const Planner::SweepResult& result);
+
+    // Display the plan for the next few days only; later days are never simulated
+    static void displayDaysAhead(const Planner::AssignmentStore& assignments, const Planner::ScheduleOptions& options, int days);
+
+    // Display what to work on today and for how long
+    static void displayTodaysFocus(const Planner::AssignmentStore& assignments, const std::vector<Planner::FocusTask>& tasks);
+
+    // Display shared group sessions and the group work they could not fit
+    static void displayGroupPlan(const Planner::AssignmentStore& assignments, const Planner::GroupPlan& plan);
 };
 
 #endif // DISPLAYFUNCTIONS_HPP
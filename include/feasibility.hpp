@@ -0,0 +1,28 @@
+#ifndef FEASIBILITY_HPP
+#define FEASIBILITY_HPP
+
+#include "capacity.hpp"
+#include "planner.hpp"
+#include <vector>
+
+// Demand-versus-capacity checks that avoid simulating a full plan
+namespace Planner {
+    // True if some schedule can meet every deadline with the given budget.
+    // Uses an earliest-deadline-first prefix-sum test in O(n log n).
+    bool isFeasible(const AssignmentStore& assignments, int weekdayStudyHours, int weekendStudyHours);
+
+    // Same, with the hours of each day taken from a capacity table
+    bool isFeasible(const AssignmentStore& assignments, const CapacityTable& capacity);
+
+    // Smallest uniform daily budget (same hours every day) that meets every
+    // deadline, found by binary search over isFeasible. Returns -1 if even
+    // maxHours per day is not enough.
+    int minimalBudget(const AssignmentStore& assignments, int maxHours = 24);
+
+    // Same, on real dates: the budget is tested against calendarCapacity from
+    // startDay, so holidays keep their own hours
+    int minimalBudget(const AssignmentStore& assignments, int startDay, const std::vector<Holiday>& holidays,
+                      int maxHours = 24);
+}
+
+#endif // FEASIBILITY_HPP
@@ -0,0 +1,92 @@
+#ifndef FILTER_HPP
+#define FILTER_HPP
+
+#include "assignmentstore.hpp"
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Filter expressions over a user's assignments, such as
+//
+//   deadline < 7 && weight >= 15 && group_work
+//   subject == "Physics" && !(size == 3 || duration > 10)
+//
+// Fields: deadline (days from today), duration, real_duration, weight,
+// size, group_size, group_work and subject. Comparisons are < <= > >= ==
+// and !=, combined with &&, || and !, and grouped with parentheses.
+namespace Planner {
+    // An AssignmentStore laid out one column per field, one row per
+    // assignment in the store's order index, with subjects numbered.
+    // The rows of each subject and a deadline order serve as indexes.
+    struct AssignmentColumns {
+        std::vector<int> deadline; // Days from today
+        std::vector<int> duration;
+        std::vector<int> realDuration;
+        std::vector<float> weight;
+        std::vector<int> size;
+        std::vector<int> groupSize;
+        std::vector<std::uint8_t> groupWork;
+        std::vector<std::uint32_t> subject; // Position in subjects
+
+        std::vector<std::string> subjects; // Sorted, each once
+        std::vector<std::vector<std::uint32_t>> subjectRows; // Rows of each subject, ascending
+        std::vector<std::uint32_t> byDeadline; // Rows by deadline, ties in row order
+
+        std::size_t rows() const { return deadline.size(); }
+    };
+
+    AssignmentColumns makeAssignmentColumns(const AssignmentStore& assignments);
+
+    // A filter expression, parsed once into a flat postfix program. The
+    // program runs over blocks of rows a column at a time; when the whole
+    // expression requires a subject or a deadline range narrow enough, only
+    // the rows the indexes give are tested.
+    class AssignmentFilter {
+    public:
+        // Throws std::invalid_argument if the expression is malformed
+        explicit AssignmentFilter(const std::string& expression);
+
+        // Rows that match, ascending
+        std::vector<std::uint32_t> select(const AssignmentColumns& columns) const;
+
+        const std::string& expression() const { return text; }
+
+        enum class Field : std::uint8_t { Deadline, Duration, RealDuration, Weight, Size, GroupSize, GroupWork, Subject };
+        enum class Compare : std::uint8_t { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+        // One step of the program; a test pushes a result, the others combine them
+        struct Instruction {
+            enum class Op : std::uint8_t { Test, And, Or, Not } op = Op::Test;
+            Field field = Field::Deadline;
+            Compare compare = Compare::NotEqual; // A bare group_work is group_work != 0
+            int whole = 0; // Value for integer and boolean fields
+            float real = 0; // Value for weight
+            std::string subject; // Value for subject
+        };
+
+    private:
+        class Parser;
+
+        // Run the program on one row, with room for depth results on stack
+        bool matches(const AssignmentColumns& columns, std::uint32_t row, const std::vector<std::uint32_t>& subjectIds,
+                     std::uint8_t* stack) const;
+
+        // Run the program over every row, a block of each column at a time
+        void scan(const AssignmentColumns& columns, const std::vector<std::uint32_t>& subjectIds,
+                  std::vector<std::uint32_t>& rows) const;
+
+        std::string text;
+        std::vector<Instruction> program;
+        std::size_t depth = 0; // Most results on the stack at once
+
+        // Conditions the whole expression requires, for the indexes
+        bool requiresSubject = false;
+        std::string requiredSubject;
+        int deadlineLow = INT_MIN;
+        int deadlineHigh = INT_MAX;
+    };
+}
+
+#endif // FILTER_HPP
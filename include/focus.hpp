@@ -0,0 +1,27 @@
+#ifndef FOCUS_HPP
+#define FOCUS_HPP
+
+#include "simulation.hpp"
+#include <cstdint>
+#include <vector>
+
+// What to work on today, answered without planning the days after it
+namespace Planner {
+    // An assignment picked for today
+    struct FocusTask {
+        std::uint32_t assignment; // Position of the assignment in the store's order index
+        int hours; // Study hours it gets today
+        int score; // Priority score it was picked with
+    };
+
+    // Today's study hours (day 1 of the plan) handed out the way the
+    // priority ladder does it: each hour goes to the highest score, and an
+    // assignment is rescored after each hour it gets. Every assignment is
+    // scored once and only the top few are kept, in O(n log k) for k hours. Equal
+    // scores go to the earlier deadline, then to the earlier assignment,
+    // where the scheduler's heap breaks them by its own layout.
+    // Tasks are listed in the order they first get an hour.
+    std::vector<FocusTask> todaysFocus(const AssignmentStore& assignments, const ScheduleOptions& options);
+}
+
+#endif // FOCUS_HPP
@@ -0,0 +1,106 @@
+#ifndef GROUPSLOTS_HPP
+#define GROUPSLOTS_HPP
+
+#include "availability.hpp"
+#include "planner.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Shared study sessions for group assignments. Each member's free study
+// hours are a bitset of 168 hours per week, so the hours every member has
+// free are a word-wise AND of the members' sets.
+namespace Planner {
+    constexpr int HoursPerWeek = 7 * 24;
+
+    // Length of a term, the horizon group sessions are planned over
+    constexpr int DefaultTermWeeks = 16;
+
+    // Most hours a group meets on one study day unless told otherwise
+    constexpr int DefaultGroupHoursPerDay = 3;
+
+    // One bit per hour over whole weeks, counted from midnight of firstDay.
+    // A set bit is a free hour.
+    class HourMask {
+    public:
+        // Every hour busy
+        HourMask(int firstDay, int weeks);
+
+        // Free one-hour slots in the study window of each day
+        static HourMask fromAvailability(const Availability& availability, int firstDay, int weeks);
+
+        int firstDay() const { return first; }
+        int weeks() const { return weekCount; }
+        int hours() const { return weekCount * HoursPerWeek; }
+
+        bool isFree(int hour) const;
+        void setFree(int hour, bool free);
+
+        // Keep the hours both masks have free; other must span the same days
+        HourMask& operator&=(const HourMask& other);
+
+        // Free hours in [fromHour, toHour), or in the whole mask
+        int count(int fromHour, int toHour) const;
+        int count() const { return count(0, hours()); }
+
+        // First free hour at or after fromHour, or -1 if there is none
+        int nextFree(int fromHour) const;
+
+    private:
+        static constexpr int WordsPerWeek = 3; // 168 bits, the top 24 of the last word unused
+
+        int first;
+        int weekCount;
+        std::vector<std::uint64_t> words;
+    };
+
+    // Hours free for every member; members must span the same days
+    HourMask commonFreeHours(const std::vector<HourMask>& members);
+
+    // Consecutive hours a whole group studies together
+    struct GroupSession {
+        std::uint32_t assignment; // Position of the assignment in the store's order index
+        int day; // Day number of the session
+        int startHour; // Clock hour it starts
+        int hours;
+    };
+
+    // A group assignment that could not get all its hours before its deadline
+    struct GroupShortfall {
+        std::uint32_t assignment;
+        int hours; // Hours still missing
+    };
+
+    struct GroupPlan {
+        std::vector<GroupSession> sessions; // By assignment, then by time
+        std::vector<GroupShortfall> shortfalls;
+    };
+
+    // Plan shared sessions for every group assignment, the earliest deadline
+    // first, each taking the earliest hours all members have free up to its
+    // deadline. The group meets for each member's share of the work
+    // (the real duration), and sessions never overlap. A study day, which
+    // runs from the latest window start of the members to the same hour the
+    // next day, holds at most maxHoursPerDay group hours.
+    GroupPlan planGroupSessions(const AssignmentStore& assignments, const std::vector<const Availability*>& members,
+                                int firstDay, int weeks = DefaultTermWeeks, int maxHoursPerDay = DefaultGroupHoursPerDay);
+
+    // Tag under which the sessions of a group assignment are reserved. The
+    // same assignment in each member's plan has the same tag.
+    std::string groupSessionTag(const Assignment& assignment);
+
+    // Hours already reserved for the sessions of a group assignment
+    int reservedGroupHours(const Assignment& assignment, const Availability& availability);
+
+    // Drop the sessions reserved for the group assignments of a plan, so
+    // they can be planned again from everyone's free time
+    void releaseGroupSessions(Availability& availability, const AssignmentStore& assignments);
+
+    // Reserve the sessions as busy time under their assignments' tags, so a
+    // member's own plan works around them. Sessions reserved earlier for the
+    // same assignments are replaced.
+    void reserveGroupSessions(Availability& availability, const AssignmentStore& assignments,
+                              const std::vector<GroupSession>& sessions);
+}
+
+#endif // GROUPSLOTS_HPP
@@ -0,0 +1,112 @@
+#ifndef GZIPSTREAM_HPP
+#define GZIPSTREAM_HPP
+
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+
+// Files that may be stored gzip-compressed. Data streams through zlib in
+// fixed-size chunks, so no whole file is ever held in memory.
+namespace Planner {
+    // True if the file name asks for compressed storage (ends in .gz)
+    bool isGzipPath(const std::string& filename);
+
+    // True if data starts with the gzip magic bytes
+    bool isGzipData(const std::string& data);
+
+    // Whole-buffer forms for callers that do their own file I/O. A corrupt
+    // or truncated stream decompresses to what could be read before it.
+    std::string gzipCompress(const std::string& data);
+    std::string gzipDecompress(const std::string& data);
+
+    // Inflates a gzip stream read chunk by chunk from another buffer.
+    // Concatenated gzip members are read as one stream, like gunzip does.
+    class GzipInputBuffer : public std::streambuf {
+    public:
+        explicit GzipInputBuffer(std::streambuf* source);
+        ~GzipInputBuffer() override;
+
+        // True once the data turned out corrupt, or the source ended before
+        // the end of a gzip member; reading then stops as if at the end
+        bool failed() const;
+
+    protected:
+        int_type underflow() override;
+
+    private:
+        struct State;
+        std::unique_ptr<State> state;
+    };
+
+    // Deflates everything written to it into a gzip stream on another buffer
+    class GzipOutputBuffer : public std::streambuf {
+    public:
+        explicit GzipOutputBuffer(std::streambuf* sink);
+        ~GzipOutputBuffer() override;
+
+        // Write the gzip trailer; nothing can be written afterwards
+        bool finish();
+
+    protected:
+        int_type overflow(int_type c) override;
+
+        // Hands pending bytes to zlib but does not force a flush block,
+        // which would cost compression ratio
+        int sync() override;
+
+    private:
+        bool deflateChunk(int flush);
+
+        struct State;
+        std::unique_ptr<State> state;
+    };
+
+    // Reads a file, inflating it on the fly if it starts with the gzip
+    // magic bytes; any other file is read as is
+    class InputFile {
+    public:
+        explicit InputFile(const std::string& filename);
+        ~InputFile();
+
+        InputFile(const InputFile&) = delete;
+        InputFile& operator=(const InputFile&) = delete;
+
+        bool isOpen() const { return file.is_open(); }
+        bool isCompressed() const { return gzip != nullptr; }
+        std::istream& stream() { return input; }
+
+        // True if the compressed data read so far is corrupt or truncated
+        bool failed() const { return gzip && gzip->failed(); }
+
+    private:
+        std::ifstream file;
+        std::unique_ptr<GzipInputBuffer> gzip;
+        std::istream input;
+    };
+
+    // Writes a file, deflating it to gzip when the name ends in .gz
+    class OutputFile {
+    public:
+        explicit OutputFile(const std::string& filename);
+        ~OutputFile();
+
+        OutputFile(const OutputFile&) = delete;
+        OutputFile& operator=(const OutputFile&) = delete;
+
+        bool isOpen() const { return file.is_open(); }
+        std::ostream& stream() { return output; }
+
+        // Finish the compressed stream and close the file. Returns false if
+        // anything could not be written.
+        bool close();
+
+    private:
+        std::ofstream file;
+        std::unique_ptr<GzipOutputBuffer> gzip;
+        std::ostream output;
+    };
+}
+
+#endif // GZIPSTREAM_HPP
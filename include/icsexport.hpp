@@ -0,0 +1,75 @@
+#ifndef ICSEXPORT_HPP
+#define ICSEXPORT_HPP
+
+#include "assignmentstore.hpp"
+#include "simulation.hpp"
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Writing schedules as iCalendar feeds that clients can sync incrementally
+namespace Planner {
+    // One scheduled study event as written to a calendar feed
+    struct CalendarEvent {
+        std::string uid; // Stable across runs for the same assignment and slot
+        std::string summary;
+        std::string start; // Local time, YYYYMMDDTHHMMSS
+        std::string end;
+        std::string rule; // RRULE value for repeating blocks, empty for a single block
+        std::string stamp; // DTSTAMP of the run that last changed the event
+        int sequence = 0; // Feed revision that last changed the event
+    };
+
+    // How plan slots are turned into events
+    struct CalendarOptions {
+        bool coalesce = true; // One event per run of consecutive hours instead of one per hour
+        bool dailyRules = false; // Fold identical blocks on consecutive days into one RRULE event
+    };
+
+    // A full feed: every event of the latest run and its revision counter
+    struct CalendarFeed {
+        int revision = 0;
+        std::vector<CalendarEvent> events;
+    };
+
+    // Changes between two runs. Changed holds new and moved events;
+    // cancelled holds events of the previous run that are gone.
+    struct CalendarDelta {
+        int revision = 0;
+        std::vector<CalendarEvent> changed;
+        std::vector<CalendarEvent> cancelled;
+        std::size_t unchanged = 0;
+    };
+
+    // Deterministic UID for the index-th event of an assignment starting on
+    // a day number. The assignment part hashes subject and name, and
+    // occurrence tells apart assignments sharing both. Keying on the date
+    // rather than the plan day keeps UIDs stable as the plan moves forward.
+    std::string studyEventUid(const std::string& subject, const std::string& name, int occurrence, int dayNumber, int index);
+
+    // Events of a simulated plan; day 0 of the plan is the day number startDay
+    std::vector<CalendarEvent> planEvents(const AssignmentStore& assignments, const SchedulePlan& plan, int startDay,
+                                          const CalendarOptions& options = CalendarOptions());
+
+    // Read a feed written by writeCalendar; a missing file is an empty feed
+    CalendarFeed readCalendarFeed(const std::string& filename);
+    CalendarFeed readCalendarFeed(std::istream& input);
+
+    // Compare a new run with the previous feed. Unchanged events keep their
+    // sequence and stamp; changed and cancelled ones get the next revision
+    // and the given stamp. The events are updated in place.
+    CalendarDelta diffCalendar(std::vector<CalendarEvent>& events, const CalendarFeed& previous, const std::string& stamp);
+
+    // Write every event as a full feed
+    void writeCalendar(std::ostream& output, const std::vector<CalendarEvent>& events, int revision);
+
+    // Write only the changes: new and moved events as a METHOD:PUBLISH
+    // calendar, followed by a METHOD:CANCEL calendar for removed events
+    void writeCalendarDelta(std::ostream& output, const CalendarDelta& delta);
+
+    // Current UTC time in iCalendar form, for DTSTAMP
+    std::string calendarTimestamp();
+}
+
+#endif // ICSEXPORT_HPP
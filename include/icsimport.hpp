@@ -0,0 +1,33 @@
+#ifndef ICSIMPORT_HPP
+#define ICSIMPORT_HPP
+
+#include "availability.hpp"
+#include <cstddef>
+#include <istream>
+#include <string>
+
+// Streaming import of busy time from iCalendar (.ics) files
+namespace Planner {
+    // Calendar days an import looks ahead when no horizon is given
+    constexpr int DefaultImportHorizonDays = 365;
+
+    // What an import read and what it added to the availability
+    struct IcsImportStats {
+        std::size_t events = 0; // VEVENTs read
+        std::size_t weeklyPatterns = 0; // Weekly rules stored as a pattern, without expansion
+        std::size_t occurrences = 0; // One-off busy intervals added inside the horizon
+        std::size_t skipped = 0; // Free, cancelled or unreadable events
+    };
+
+    // Read VEVENTs from a calendar stream one line at a time and add the busy
+    // ones to the availability. Only days in [firstDay, lastDay] are considered;
+    // recurring events are expanded lazily within that horizon, and plain weekly
+    // rules become weekly patterns. Memory use does not grow with the file.
+    // Times in UTC are converted to local time; TZID parameters are read as local.
+    IcsImportStats importICS(std::istream& input, Availability& availability, int firstDay, int lastDay);
+
+    // Same, reading from a file; returns empty stats if it cannot be opened
+    IcsImportStats importICSFile(const std::string& filename, Availability& availability, int firstDay, int lastDay);
+}
+
+#endif // ICSIMPORT_HPP
@@ -0,0 +1,37 @@
+#ifndef ICSTEXT_HPP
+#define ICSTEXT_HPP
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// iCalendar content lines shared by the importer and the exporter (RFC 5545 3.1, 3.3.11)
+namespace Planner {
+    // Escape a TEXT value: backslash, semicolon, comma and newlines
+    std::string escapeText(std::string_view text);
+
+    // Undo escapeText; an unknown escape keeps the character after the backslash
+    std::string unescapeText(std::string_view text);
+
+    // Write "name:value" folded into lines of at most 75 octets, each ending
+    // in CRLF. Folds never split a UTF-8 sequence.
+    void writeContentLine(std::ostream& output, std::string_view name, std::string_view value);
+
+    // Reads content lines, joining folded continuation lines
+    class UnfoldingReader {
+    public:
+        explicit UnfoldingReader(std::istream& input);
+
+        bool read(std::string& line);
+
+    private:
+        bool fetch(std::string& line);
+
+        std::istream& input;
+        std::string next;
+        bool hasNext = false;
+    };
+}
+
+#endif // ICSTEXT_HPP
@@ -0,0 +1,75 @@
+#ifndef LAZYPLAN_HPP
+#define LAZYPLAN_HPP
+
+#include "planner.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// A user's plan in the database is a header line with the epoch, the
+// assignment count and the subjects, then one JSON line per assignment.
+// The header alone answers the questions asked at startup.
+namespace Planner {
+    class PersistenceWriter;
+
+    struct PlanSummary {
+        int epoch = 0; // Day the stored deadlines count from
+        std::size_t count = 0;
+        std::vector<std::string> subjects; // Sorted, each once
+    };
+
+    // Database record of a plan
+    std::string formatPlanRecord(const AssignmentStore& assignments);
+
+    // Assignments of a record, with deadlines rebased onto today
+    AssignmentStore parsePlanRecord(const std::string& record);
+
+    // Summary from the header line of a record
+    PlanSummary parsePlanHeader(const std::string& header);
+
+    // A record with assignments appended and its header replaced by summary.
+    // Deadlines of the added assignments count from today.
+    std::string appendPlanRecord(const std::string& record, const PlanSummary& summary,
+                                 const std::vector<Assignment>& added);
+
+    // A user's plan that reads only its header when opened. The assignments
+    // are parsed the first time an operation needs them; adding one does not.
+    class LazyPlan {
+    public:
+        // With a writer, save() hands changes to its thread and returns at once
+        LazyPlan(UserDatabase& database, const std::string& userName, PersistenceWriter* writer = nullptr);
+
+        LazyPlan(const LazyPlan&) = delete;
+        LazyPlan& operator=(const LazyPlan&) = delete;
+
+        // Number of assignments and their subjects, without loading them
+        std::size_t size() const;
+        bool empty() const { return size() == 0; }
+        const std::vector<std::string>& subjects() const { return summary.subjects; }
+
+        bool isLoaded() const { return loaded; }
+
+        // Every assignment, parsed on first use. Once loaded, the plan is
+        // rewritten in full by save().
+        AssignmentStore& assignments();
+
+        // Add an assignment whose deadline counts from today
+        void add(const Assignment& assignment);
+
+        // Write changes back. Additions to an unloaded plan are appended to
+        // its record without parsing it, unless the record fails to read;
+        // an untouched plan writes nothing. Through a writer, failures are reported by the writer instead.
+        bool save();
+
+    private:
+        UserDatabase& database;
+        std::string userName;
+        PersistenceWriter* writer;
+        PlanSummary summary;
+        bool loaded = false;
+        AssignmentStore store;
+        std::vector<Assignment> pending; // Added before the plan was loaded
+    };
+}
+
+#endif // LAZYPLAN_HPP
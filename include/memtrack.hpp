@@ -0,0 +1,74 @@
+#ifndef MEMTRACK_HPP
+#define MEMTRACK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Heap accounting per planner phase, fed by a replaced global operator new.
+// Every allocation is charged to the innermost MemoryScope of its thread,
+// and its bytes are returned to that same phase when it is freed.
+// Only built with PLANNER_MEMORY_TRACKING=1; otherwise the standard
+// allocator is kept and every counter stays zero.
+#ifndef PLANNER_MEMORY_TRACKING
+#define PLANNER_MEMORY_TRACKING 0
+#endif
+
+namespace Planner {
+    enum class MemoryTag : unsigned char {
+        Untagged,
+        Load,
+        Schedule,
+        Ics,
+        Save,
+        Display,
+        Count
+    };
+
+    // Counters of one phase since tracking started
+    struct MemoryUsage {
+        std::uint64_t allocations = 0;
+        std::uint64_t frees = 0;
+        std::uint64_t bytesAllocated = 0; // Total requested bytes
+        std::int64_t liveBytes = 0; // Still allocated now
+        std::int64_t peakBytes = 0; // Most ever allocated at once
+    };
+
+    // Start counting from zero; allocations made earlier are never charged.
+    // Without PLANNER_MEMORY_TRACKING every counter stays zero.
+    void startMemoryTracking();
+    void stopMemoryTracking();
+    bool memoryTrackingEnabled();
+
+    MemoryUsage memoryUsage(MemoryTag tag);
+    const char* memoryTagName(MemoryTag tag);
+
+    // Print one line per phase that allocated anything, or a note that
+    // accounting was not built in
+    void writeMemoryReport(std::ostream& output);
+
+    // Charges the calling thread's allocations to a phase until destroyed
+    class MemoryScope {
+    public:
+        explicit MemoryScope(MemoryTag tag);
+        ~MemoryScope();
+
+        MemoryScope(const MemoryScope&) = delete;
+        MemoryScope& operator=(const MemoryScope&) = delete;
+
+    private:
+        MemoryTag previous;
+    };
+}
+
+#define PLANNER_MEMORY_CONCAT_INNER(a, b) a##b
+#define PLANNER_MEMORY_CONCAT(a, b) PLANNER_MEMORY_CONCAT_INNER(a, b)
+
+#if PLANNER_MEMORY_TRACKING
+// Charge the rest of the enclosing scope's allocations to a phase
+#define PLANNER_MEMORY_SCOPE(tag) ::Planner::MemoryScope PLANNER_MEMORY_CONCAT(memoryScope, __LINE__)(::Planner::MemoryTag::tag)
+#else
+#define PLANNER_MEMORY_SCOPE(tag) ((void)0)
+#endif
+
+#endif // MEMTRACK_HPP
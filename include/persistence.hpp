@@ -0,0 +1,118 @@
+#ifndef PERSISTENCE_HPP
+#define PERSISTENCE_HPP
+
+#include "lazyplan.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Saves on a background thread so menu operations return as soon as the
+// in-memory state is updated. The thread owns snapshots and deltas handed
+// to it; a burst of changes to the same plan or file becomes one write.
+namespace Planner {
+    class PersistenceWriter {
+    public:
+        // Changes are held for coalesceWindow after the first one of a burst
+        explicit PersistenceWriter(UserDatabase& database,
+                                   std::chrono::milliseconds coalesceWindow = std::chrono::milliseconds(50));
+
+        // Drains whatever is still queued
+        ~PersistenceWriter();
+
+        PersistenceWriter(const PersistenceWriter&) = delete;
+        PersistenceWriter& operator=(const PersistenceWriter&) = delete;
+
+        // Replace a user's plan with a copy of assignments, superseding
+        // anything still queued for that user
+        void savePlan(const std::string& userName, const AssignmentStore& assignments);
+
+        // Append assignments to a user's plan, updating its header to summary.
+        // Deadlines count from today.
+        void appendToPlan(const std::string& userName, const PlanSummary& summary, std::vector<Assignment> added);
+
+        // Run write on the thread, superseding a queued write with the same
+        // key. The write returns false on failure.
+        void submit(const std::string& key, std::function<bool()> write);
+
+        // Block until everything handed over so far is written
+        void wait();
+
+        // Write everything still queued and stop the thread; later changes
+        // are written on the caller's thread. Returns false if a write
+        // failed and its error has not been taken.
+        bool drain();
+
+        // Failed writes since the last call, oldest first
+        std::vector<std::string> takeErrors();
+
+        // Writes performed and changes folded into another write
+        std::size_t writeCount() const;
+        std::size_t coalescedCount() const;
+
+    private:
+        // Queued changes to one user's plan
+        struct PlanChange {
+            std::unique_ptr<AssignmentStore> snapshot; // Whole plan to write, if set
+            PlanSummary summary;
+            std::vector<Assignment> added; // Appended to the stored record otherwise
+        };
+
+        void run();
+        bool writePlan(const std::string& userName, const PlanChange& change);
+        void attempt(const std::string& what, const std::function<bool()>& write); // Records a throwing write as failed
+        void record(bool ok, const std::string& what);
+        void queued(bool wasEmpty, bool merged); // Called with the mutex held
+        bool queueEmpty() const { return plans.empty() && files.empty(); }
+
+        UserDatabase& database;
+        const std::chrono::milliseconds coalesceWindow;
+
+        mutable std::mutex mutex;
+        std::condition_variable wake; // New work, a waiter or a stop request
+        std::condition_variable idle; // The queue ran dry
+        std::map<std::string, PlanChange> plans;
+        std::map<std::string, std::function<bool()>> files;
+        std::chrono::steady_clock::time_point burstStart;
+        bool writing = false;
+        bool stopping = false;
+        bool stopped = false;
+        std::size_t waiters = 0;
+        std::size_t writes = 0;
+        std::size_t coalesced = 0;
+        std::vector<std::string> errors;
+        std::once_flag joined;
+        std::thread thread;
+    };
+
+    // Drains the writer and exits when SIGINT, SIGTERM or SIGHUP arrives,
+    // for as long as it lives. Blocks those signals in the calling thread,
+    // so create it in main before starting other threads, and after the
+    // writer so it is stopped first.
+    class SignalDrain {
+    public:
+        explicit SignalDrain(PersistenceWriter& writer);
+
+        // Stops and joins the thread waiting for the signals, and unblocks
+        // them in the calling thread again
+        ~SignalDrain();
+
+        SignalDrain(const SignalDrain&) = delete;
+        SignalDrain& operator=(const SignalDrain&) = delete;
+
+    private:
+        std::atomic<bool> stopping{false};
+        sigset_t previousMask;
+        std::thread thread;
+    };
+}
+
+#endif // PERSISTENCE_HPP
@@ -2,28 +2,74 @@
 #define PLANNER_HPP
 
 #include "assignment.hpp"
+#include "assignmentstore.hpp"
+#include "availability.hpp"
+#include "capacity.hpp"
+#include "userdatabase.hpp"
 #include <vector>
 #include <string>
-#include <memory>
 
 // Namespace for organizing planner-related functionality
 namespace Planner {
-    // Define a shared pointer for assignments
-    using AssignmentPtr = std::shared_ptr<Assignment>;
+    // Scheduling strategies available to the scheduler
+    enum class SchedulerEngine {
+        Priority, // Heuristic priority ladder from calculatePriority
+        EarliestDeadline // Earliest deadline first, minimizes maximum lateness
+    };
+
+    // What the scheduler writes besides the full calendar feed
+    enum class CalendarOutput {
+        Full, // Only the full feed, Data/<user>_schedule.ics
+        Delta // Also the changes since the last run, Data/<user>_schedule_delta.ics
+    };
 
     // Function declarations
 
-    // Load assignments from a file
-    std::vector<AssignmentPtr> loadFromFile(const std::string& filename);
+    // Load assignments from a file, with deadlines rebased onto today
+    AssignmentStore loadFromFile(const std::string& filename);
+
+    // Save assignments to a file together with their plan epoch
+    void saveToFile(const std::string& filename, const AssignmentStore& assignments);
+
+    // Assignments from the contents of a plan file, plain or gzip-compressed,
+    // for callers that read files themselves
+    AssignmentStore parsePlanFile(const std::string& contents);
+
+    // Contents of a plan file as saveToFile writes it, uncompressed
+    std::string formatPlanFile(const AssignmentStore& assignments);
 
-    // Save assignments to a file
-    void saveToFile(const std::string& filename, const std::vector<AssignmentPtr>& assignments);
+    // Load a user's assignments from a database; an unknown user has none.
+    // The record format and lazy access live in lazyplan.hpp.
+    AssignmentStore loadFromFile(UserDatabase& database, const std::string& userName);
+
+    // Save a user's assignments to a database, replacing their record
+    void saveToFile(UserDatabase& database, const std::string& userName, const AssignmentStore& assignments);
 
     // Calculate the priority of an assignment based on the given study hours
     int calculatePriority(const Assignment& assignment, int studyHoursPerDay);
 
-    // Priority-based scheduler for assignments
-    void scheduler(const std::vector<AssignmentPtr>& assignments, int weekdayStudyHours, int weekendStudyHours, const std::string& userName);
+    // Calculate the priority from the raw scheduling fields of an assignment
+    int calculatePriority(int deadline, int realDuration, float weight, int size, int studyHoursPerDay);
+
+    // Scheduler for assignments; the assignments themselves are left untouched.
+    // With an availability, study hours only go into the user's free slots,
+    // and group assignments only get the hours their reserved sessions leave.
+    // With a capacity table, it decides the hours of each day instead of
+    // the weekday and weekend hours.
+    // Events keep stable UIDs, so only moved or cancelled ones change between runs.
+    // With compress, the calendar files are written gzip-compressed; a
+    // calendar already stored compressed stays so either way.
+    void scheduler(const AssignmentStore& assignments, int weekdayStudyHours, int weekendStudyHours, const std::string& userName,
+                   SchedulerEngine engine = SchedulerEngine::Priority, const Availability* availability = nullptr,
+                   CalendarOutput output = CalendarOutput::Full, const CapacityTable* capacity = nullptr,
+                   bool compress = false);
+
+    // Scheduler for batch runs that do their own file I/O: takes the
+    // previous feed as text (empty if none) and returns the new full feed.
+    // Nothing is printed.
+    std::string scheduleCalendar(const AssignmentStore& assignments, int weekdayStudyHours, int weekendStudyHours,
+                                 SchedulerEngine engine, const std::string& previousFeed,
+                                 const Availability* availability = nullptr, const CapacityTable* capacity = nullptr);
 
     // Add an assignment schedule to an ICS file
     void addToICSFile(const std::string& icsFilePath, const std::string& assignmentName, int dayOffset, int hour);
@@ -0,0 +1,123 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include "availability.hpp"
+#include "capacity.hpp"
+#include "planner.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Scheduling engines running on private working state, shared by the
+// scheduler and the planning tools
+namespace Planner {
+    // Compact per-run scheduling state for one assignment
+    struct WorkItem {
+        int remainingHours; // Real duration still to be scheduled
+        int dueDay; // Last day of the plan the assignment can be worked on
+        int score; // Priority score for the current day
+        float weight; // Importance of the assignment
+        int size; // Size of the assignment
+        bool covered = false; // Done in reserved group sessions instead; never scheduled
+    };
+
+    // Outcome of a simulated scheduling run
+    struct ScheduleStats {
+        int days = 0; // Number of simulated days
+        int scheduledHours = 0; // Hours handed out to assignments
+        int missedDeadlines = 0; // Assignments still unfinished at their deadline
+        int totalLateness = 0; // Hours still outstanding on missed assignments
+        int maxLateness = 0; // Most days an assignment was finished past its deadline
+    };
+
+    // One study hour handed to an assignment
+    struct ScheduledSlot {
+        std::uint32_t assignment; // Position of the assignment in the store's order index
+        int day; // Day of the plan, starting at 1
+        int hour; // Hour within the day, starting at 0
+        int startHour; // Clock hour the slot starts, counted from midnight of the day
+    };
+
+    // An assignment that reached its deadline unfinished
+    struct MissedDeadline {
+        std::uint32_t assignment;
+        int day;
+    };
+
+    // Everything a run decided, in the order it was decided
+    struct SchedulePlan {
+        std::vector<ScheduledSlot> slots;
+        std::vector<MissedDeadline> missed;
+    };
+
+    // Everything that decides how much study time each day offers
+    struct ScheduleOptions {
+        int weekdayStudyHours = 0;
+        int weekendStudyHours = 0;
+        SchedulerEngine engine = SchedulerEngine::Priority;
+        const Availability* availability = nullptr; // Busy time to plan around, if any
+        const CapacityTable* capacity = nullptr; // Hours per day; the weekday/weekend rule otherwise
+        int startDay = 0; // Day number of day 0 of the simulation, used with availability
+    };
+
+    // Study hours available on a simulated day (day 1 is the first planned day)
+    // under the original rule on the plan's day counter
+    int studyHoursForDay(int day, int weekdayStudyHours, int weekendStudyHours);
+
+    // Study hours the options give a simulated day, before availability
+    inline int studyHoursForDay(int day, const ScheduleOptions& options) {
+        return options.capacity ? options.capacity->hoursFor(day)
+                                : studyHoursForDay(day, options.weekdayStudyHours, options.weekendStudyHours);
+    }
+
+    // Build the working state for a simulation from the user's assignments.
+    // With an availability, group assignments only keep the hours their
+    // reserved group sessions do not already cover.
+    std::vector<WorkItem> makeWorkItems(const AssignmentStore& assignments, const Availability* availability = nullptr);
+
+    // Run a scheduling engine on a private working state, optionally
+    // recording the plan. The items are consumed; pass a copy to keep them.
+    ScheduleStats simulate(std::vector<WorkItem>& items, int weekdayStudyHours, int weekendStudyHours,
+                           SchedulerEngine engine = SchedulerEngine::Priority, SchedulePlan* plan = nullptr);
+
+    // Same, with study hours capped by the free slots of an availability
+    ScheduleStats simulate(std::vector<WorkItem>& items, const ScheduleOptions& options, SchedulePlan* plan = nullptr);
+
+    // What one simulated day decided
+    struct ScheduleDay : SchedulePlan {
+        int day = 0; // Day of the plan, starting at 1
+    };
+
+    class DayEngine; // An engine's state between days, defined in simulation.cpp
+
+    // Runs a scheduling engine one day at a time, on demand. The engine is
+    // suspended between pulls, so a caller that stops after a week pays
+    // for a week, not for the whole horizon. The days match what
+    // simulate() plans with the same items and options.
+    class ScheduleGenerator {
+    public:
+        ScheduleGenerator(std::vector<WorkItem> items, const ScheduleOptions& options);
+        ScheduleGenerator(const AssignmentStore& assignments, const ScheduleOptions& options);
+        ~ScheduleGenerator();
+
+        ScheduleGenerator(const ScheduleGenerator&) = delete;
+        ScheduleGenerator& operator=(const ScheduleGenerator&) = delete;
+
+        // Simulate the next day into day. Returns false once every
+        // assignment is finished or expired.
+        bool next(ScheduleDay& day);
+
+        bool done() const;
+
+        // Totals over the days pulled so far
+        const ScheduleStats& stats() const { return totals; }
+
+    private:
+        std::vector<WorkItem> items;
+        ScheduleOptions options;
+        ScheduleStats totals;
+        std::unique_ptr<DayEngine> engine;
+    };
+}
+
+#endif // SIMULATION_HPP
@@ -0,0 +1,40 @@
+#ifndef SWEEP_HPP
+#define SWEEP_HPP
+
+#include "capacity.hpp"
+#include "simulation.hpp"
+#include <vector>
+
+// What-if sweeps over study-hour budgets
+namespace Planner {
+    // Result of one (weekday, weekend) budget in a sweep
+    struct SweepCell {
+        int weekdayStudyHours;
+        int weekendStudyHours;
+        ScheduleStats stats;
+    };
+
+    // Full sweep grid, ordered by weekday hours and then weekend hours
+    struct SweepResult {
+        std::vector<SweepCell> cells;
+        int cheapest = -1; // Index of the cheapest budget with no missed deadlines, -1 if none
+    };
+
+    // Weekly study hours implied by a budget (five weekdays, two weekend days)
+    int weeklyStudyHours(int weekdayStudyHours, int weekendStudyHours);
+
+    // Simulate every budget from 1..maxWeekdayHours x 1..maxWeekendHours in parallel.
+    // A threadCount of 0 uses every available core.
+    SweepResult sweepStudyHours(const AssignmentStore& assignments, int maxWeekdayHours,
+                                int maxWeekendHours, SchedulerEngine engine = SchedulerEngine::Priority,
+                                unsigned threadCount = 0);
+
+    // Same, on real dates: each budget is simulated against calendarCapacity
+    // from options.startDay with the given holidays and horizon, around
+    // options.availability and with options.engine, the way the scheduler plans it
+    SweepResult sweepStudyHours(const AssignmentStore& assignments, int maxWeekdayHours, int maxWeekendHours,
+                                const ScheduleOptions& options, const std::vector<Holiday>& holidays, int horizon,
+                                unsigned threadCount = 0);
+}
+
+#endif // SWEEP_HPP
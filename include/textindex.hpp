@@ -0,0 +1,87 @@
+#ifndef TEXTINDEX_HPP
+#define TEXTINDEX_HPP
+
+#include "assignmentstore.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Finding assignments by fragments of their names and subjects. Every run
+// of three characters (a trigram) maps to the sorted ids of the texts that
+// contain it, stored as variable-length deltas. Case is ignored.
+namespace Planner {
+    struct TextMatch {
+        std::uint32_t id;
+        int score; // Trigrams shared with the query
+    };
+
+    class TextIndex {
+    public:
+        // Index text under id, replacing whatever id held before
+        void add(std::uint32_t id, const std::string& text);
+
+        // Same, for several texts such as a name and a subject. A fragment
+        // must lie within one of them to match.
+        void add(std::uint32_t id, const std::vector<std::string>& fields);
+
+        // Forget id. Its postings are dropped lazily, a batch at a time.
+        void remove(std::uint32_t id);
+
+        bool contains(std::uint32_t id) const;
+        std::size_t size() const { return live; }
+
+        // Ids whose text contains fragment, ascending. Fragments shorter
+        // than a trigram are looked for in every text.
+        std::vector<std::uint32_t> search(const std::string& fragment) const;
+
+        // Ids whose text shares at least a third of the trigrams of query, so
+        // swapped or wrong letters still match; the most shared first, then
+        // the shortest
+        std::vector<TextMatch> searchFuzzy(const std::string& query, std::size_t limit = 10) const;
+
+        // Bytes taken by the posting lists
+        std::size_t postingBytes() const;
+
+    private:
+        // Sorted ids as deltas, 7 bits per byte
+        struct PostingList {
+            std::vector<std::uint8_t> bytes;
+            std::uint32_t last = 0;
+            std::uint32_t count = 0; // Includes removed ids not yet dropped
+
+            void append(std::uint32_t id);
+            std::vector<std::uint32_t> decode() const;
+            void assign(const std::vector<std::uint32_t>& ids);
+        };
+
+        enum class State : std::uint8_t { Absent, Live, Removed };
+
+        struct Document {
+            std::uint32_t start = 0; // Normalised text in the arena
+            std::uint32_t length = 0;
+            State state = State::Absent;
+        };
+
+        void addNormalised(std::uint32_t id, const std::string& normalised);
+        std::string textOf(std::uint32_t id) const { return arena.substr(documents[id].start, documents[id].length); }
+        bool containsText(std::uint32_t id, const std::string& fragment) const;
+        void unlink(std::uint32_t id); // Drop a removed id from its postings now
+        void compact();
+
+        std::unordered_map<std::uint32_t, PostingList> postings; // By trigram
+        std::vector<Document> documents; // By id
+        std::string arena; // Texts, each field padded with a space on each side
+        std::size_t live = 0;
+        std::size_t removed = 0; // Removed ids still in postings
+    };
+
+    // Texts an assignment is found by: its name and its subject
+    std::vector<std::string> searchableFields(const Assignment& assignment);
+
+    // Index every assignment of a store under its handle
+    void indexAssignments(TextIndex& index, const AssignmentStore& assignments);
+}
+
+#endif // TEXTINDEX_HPP
@@ -0,0 +1,62 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Scoped phase timers that export a Chrome trace (opens in Perfetto).
+// Build with PLANNER_TRACING=0 to compile every span out entirely.
+#ifndef PLANNER_TRACING
+#define PLANNER_TRACING 1
+#endif
+
+namespace Planner {
+    // Start recording spans on every thread, dropping anything recorded before
+    void startTracing();
+
+    // Stop recording; recorded spans are kept until the next start
+    void stopTracing();
+
+    bool tracingEnabled();
+
+    // Number of spans recorded so far, across all threads
+    std::size_t traceEventCount();
+
+    // Write the recorded spans as Chrome trace JSON. Returns false if the
+    // file cannot be written. Call it once worker threads are done.
+    bool writeTrace(const std::string& filename);
+
+    // Records the time between its construction and destruction on the
+    // calling thread's own buffer; no locks on the way
+    class TraceSpan {
+    public:
+        explicit TraceSpan(const char* name) : name(name), start(tracingEnabled() ? now() : -1) {}
+        ~TraceSpan() {
+            if (start >= 0)
+                record(name, start, now());
+        }
+
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+
+    private:
+        static std::int64_t now();
+        static void record(const char* name, std::int64_t start, std::int64_t end);
+
+        const char* name; // Must outlive the trace; string literals in practice
+        std::int64_t start;
+    };
+}
+
+#define PLANNER_TRACE_CONCAT_INNER(a, b) a##b
+#define PLANNER_TRACE_CONCAT(a, b) PLANNER_TRACE_CONCAT_INNER(a, b)
+
+#if PLANNER_TRACING
+// Time the rest of the enclosing scope under the given name
+#define PLANNER_TRACE_SCOPE(name) ::Planner::TraceSpan PLANNER_TRACE_CONCAT(traceSpan, __LINE__)(name)
+#else
+#define PLANNER_TRACE_SCOPE(name) ((void)0)
+#endif
+
+#endif // TRACE_HPP
@@ -0,0 +1,137 @@
+#ifndef USERDATABASE_HPP
+#define USERDATABASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Every user's plan in one page-based file instead of one file per user.
+// A B+tree keyed by user name maps each user to a chain of data pages
+// holding the record. Updates never touch pages the last commit uses:
+// the new chain and tree path go to free pages, and a checksummed header
+// slot naming the new root is written last, after an fsync, so a crash
+// leaves either the old or the new state. Records may be stored
+// gzip-compressed; reads inflate them transparently. Calls are
+// serialized, so a database can be shared with a background writer.
+namespace Planner {
+    // Default database file of the planner program
+    inline const char* const DefaultDatabasePath = "Data/planner.db";
+
+    class UserDatabase {
+    public:
+        static constexpr std::size_t PageSize = 4096;
+        static constexpr std::size_t MaxUserNameLength = 63;
+
+        // Open a database, creating an empty one if the file does not exist
+        explicit UserDatabase(const std::string& filename);
+        ~UserDatabase();
+
+        UserDatabase(const UserDatabase&) = delete;
+        UserDatabase& operator=(const UserDatabase&) = delete;
+
+        // False if the file could not be opened or is not a planner database
+        bool isOpen() const { return open; }
+
+        bool contains(const std::string& userName);
+
+        // Read a user's record. Returns false if the user is unknown.
+        bool read(const std::string& userName, std::string& record);
+
+        // Read a user's record up to the first delimiter, leaving the
+        // delimiter out; reading stops soon after it. Returns false if the
+        // user is unknown.
+        bool readPrefix(const std::string& userName, char delimiter, std::string& prefix);
+
+        // Insert or replace a user's record and commit it to disk. With
+        // compress, or if the record was already stored compressed, it is
+        // stored gzip-compressed. Returns false if the name is empty or too
+        // long, or the file cannot be written; the database then keeps its
+        // previous state.
+        bool write(const std::string& userName, const std::string& record, bool compress = false);
+
+        // True if the user's record is stored gzip-compressed
+        bool isCompressed(const std::string& userName);
+
+        // Visit every user in name order, a leaf at a time. The visitor may
+        // rewrite the user it is given, but not add users.
+        void forEachUser(const std::function<void(const std::string& userName, const std::string& record)>& visit);
+
+        std::vector<std::string> userNames();
+        std::uint64_t userCount() const;
+        std::uint32_t pageCount() const;
+
+    private:
+        // Record location as stored in a leaf, or a child pointer in an inner node
+        struct Entry {
+            std::string key;
+            std::uint32_t page = 0;
+            std::uint64_t length = 0;
+        };
+
+        struct Node {
+            bool leaf = true;
+            std::uint32_t link = 0; // Leftmost child of an inner node
+            std::vector<Entry> entries;
+        };
+
+        // Copy of a node written by insert, and its new right sibling if it split
+        struct Insertion {
+            std::uint32_t page = 0;
+            std::string splitKey;
+            std::uint32_t right = 0;
+        };
+
+        // State named by a header slot
+        struct Commit {
+            std::uint64_t sequence = 0;
+            std::uint32_t root = 0;
+            std::uint32_t pages = 0;
+            std::uint32_t freeList = 0; // First page of the list of free pages
+            std::uint64_t users = 0;
+        };
+
+        void readPage(std::uint32_t page, unsigned char* buffer);
+        void writePage(std::uint32_t page, const unsigned char* buffer);
+        bool readHeader();
+        bool readFreeList(std::uint32_t first, bool legacy);
+        bool commit();
+        void rollback();
+
+        Node readNode(std::uint32_t page);
+        std::uint32_t writeNode(const Node& node);
+
+        // Pages free in the last commit are handed out; pages it still uses
+        // are only released, and become free once the next commit is on disk
+        std::uint32_t allocatePage();
+        void releasePage(std::uint32_t page) { released.push_back(page); }
+
+        std::vector<std::uint32_t> leafPages();
+        bool find(const std::string& userName, Entry& entry);
+        Insertion insert(std::uint32_t page, const Entry& entry);
+        std::uint32_t writeChain(const std::string& record, std::uint32_t old);
+        std::string readRecord(const Entry& entry, char delimiter = '\0', bool stopAtDelimiter = false);
+
+        class ChainBuffer;
+
+        mutable std::recursive_mutex mutex; // Recursive so forEachUser visitors may write
+        int fd = -1;
+        bool open = false;
+        bool failed = false; // A read or write of the current operation went wrong
+
+        Commit committed;
+        std::vector<std::uint32_t> listPages; // Pages holding the committed free list
+
+        // Working state of the write in progress
+        std::uint32_t root = 0;
+        std::uint32_t pages = 0;
+        std::uint64_t users = 0;
+        std::vector<std::uint32_t> freePages; // Free in the last commit
+        std::vector<std::uint32_t> taken;     // Taken from freePages by this write
+        std::vector<std::uint32_t> released;  // Used by the last commit, dropped by this write
+    };
+}
+
+#endif // USERDATABASE_HPP
@@ -15,17 +15,13 @@ Assignment::Assignment(const std::string& subject, const std::string& name, int
 Assignment::Assignment(const Assignment& other)
     : subject(other.subject), name(other.name), deadline(other.deadline), duration(other.duration),
       weight(other.weight), size(other.size), groupWork(other.groupWork),
-      groupSize(other.groupSize), realDuration(other.realDuration), priority(other.priority) {
-    std::cout << "Copy constructor called." << std::endl;
-}
+      groupSize(other.groupSize), realDuration(other.realDuration), priority(other.priority) {}
 
 // Move constructor
 Assignment::Assignment(Assignment&& other) noexcept
     : subject(std::move(other.subject)), name(std::move(other.name)), deadline(other.deadline),
       duration(other.duration), weight(other.weight), size(other.size),
-      groupWork(other.groupWork), groupSize(other.groupSize), realDuration(other.realDuration), priority(other.priority) {
-    std::cout << "Move constructor called." << std::endl;
-}
+      groupWork(other.groupWork), groupSize(other.groupSize), realDuration(other.realDuration), priority(other.priority) {}
 
 // Copy assignment operator
 Assignment& Assignment::operator=(const Assignment& other) {
@@ -40,7 +36,6 @@ Assignment& Assignment::operator=(const Assignment& other) {
         groupSize = other.groupSize;
         realDuration = other.realDuration;
         priority = other.priority;
-        std::cout << "Copy assignment operator called." << std::endl;
     }
     return *this;
 }
@@ -58,15 +53,12 @@ Assignment& Assignment::operator=(Assignment&& other) noexcept {
         groupSize = other.groupSize;
         realDuration = other.realDuration;
         priority = other.priority;
-        std::cout << "Move assignment operator called." << std::endl;
     }
     return *this;
 }
 
 // Destructor
-Assignment::~Assignment() {
-    std::cout << "Destructor called for " << name << "." << std::endl;
-}
+Assignment::~Assignment() = default;
 
 // Setters and Getters for Priority
 void Assignment::setPriority(int priority) { this->priority = priority; }
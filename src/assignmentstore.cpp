@@ -0,0 +1,66 @@
+#include "../include/assignmentstore.hpp"
+#include <algorithm>
+
+Planner::AssignmentStore::~AssignmentStore() {
+    clear();
+}
+
+Planner::AssignmentStore::AssignmentStore(AssignmentStore&& other) noexcept
+    : chunks(std::move(other.chunks)), freeSlots(std::move(other.freeSlots)),
+      order(std::move(other.order)), nextSlot(other.nextSlot), epoch(other.epoch) {
+    other.nextSlot = 0;
+}
+
+Planner::AssignmentStore& Planner::AssignmentStore::operator=(AssignmentStore&& other) noexcept {
+    if (this != &other) {
+        clear();
+        chunks = std::move(other.chunks);
+        freeSlots = std::move(other.freeSlots);
+        order = std::move(other.order);
+        nextSlot = other.nextSlot;
+        epoch = other.epoch;
+        other.nextSlot = 0;
+    }
+    return *this;
+}
+
+Planner::AssignmentHandle Planner::AssignmentStore::allocateSlot() {
+    if (!freeSlots.empty()) {
+        AssignmentHandle handle = freeSlots.back();
+        freeSlots.pop_back();
+        return handle;
+    }
+
+    if (nextSlot % ChunkSize == 0 && nextSlot / ChunkSize == chunks.size())
+        chunks.push_back(std::make_unique<Chunk>());
+    return nextSlot++;
+}
+
+void Planner::AssignmentStore::remove(AssignmentHandle handle) {
+    auto it = std::find(order.begin(), order.end(), handle);
+    if (it == order.end())
+        return;
+
+    order.erase(it);
+    slot(handle)->~Assignment();
+    freeSlots.push_back(handle);
+}
+
+void Planner::AssignmentStore::rebase(int newEpochDay) {
+    const int shift = newEpochDay - epoch;
+    if (shift != 0) {
+        for (AssignmentHandle handle : order)
+            slot(handle)->decreaseDeadline(shift);
+    }
+    epoch = newEpochDay;
+}
+
+void Planner::AssignmentStore::clear() {
+    for (AssignmentHandle handle : order)
+        slot(handle)->~Assignment();
+
+    order.clear();
+    freeSlots.clear();
+    chunks.clear();
+    nextSlot = 0;
+}
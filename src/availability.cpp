@@ -0,0 +1,269 @@
+#include "../include/availability.hpp"
+#include "../include/json.hpp"
+#include "../include/memtrack.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+using json = nlohmann::json;
+
+// Inserts in start order and updates the running maxima from there on.
+// Between defer() and build(), as inside a Batch, adds only append.
+void Planner::Availability::IntervalIndex::add(const Interval& interval) {
+    if (interval.end <= interval.start)
+        return;
+
+    if (deferred) {
+        intervals.push_back(interval);
+        return;
+    }
+
+    auto at = std::upper_bound(intervals.begin(), intervals.end(), interval.start,
+                               [](long long value, const Interval& other) { return value < other.start; });
+    std::size_t position = static_cast<std::size_t>(at - intervals.begin());
+    intervals.insert(at, interval);
+    maxEnd.insert(maxEnd.begin() + static_cast<std::ptrdiff_t>(position),
+                  position == 0 ? interval.end : std::max(maxEnd[position - 1], interval.end));
+
+    // Later running maxima only grow, up to the first that already covers this end
+    for (std::size_t i = position + 1; i < maxEnd.size() && maxEnd[i] < interval.end; ++i)
+        maxEnd[i] = interval.end;
+}
+
+void Planner::Availability::IntervalIndex::clear() {
+    intervals.clear();
+    maxEnd.clear();
+}
+
+void Planner::Availability::IntervalIndex::build() {
+    if (!deferred)
+        return;
+    deferred = false;
+
+    // Stable, so equal starts keep the order add() would have given them
+    std::stable_sort(intervals.begin(), intervals.end(), [](const Interval& a, const Interval& b) {
+        return a.start < b.start;
+    });
+    maxEnd.resize(intervals.size());
+    for (std::size_t i = 0; i < intervals.size(); ++i)
+        maxEnd[i] = i == 0 ? intervals[i].end : std::max(maxEnd[i - 1], intervals[i].end);
+}
+
+bool Planner::Availability::IntervalIndex::overlaps(long long start, long long end, int dayNumber) const {
+    // Candidates start before the query ends; walking back stops as soon as
+    // no earlier interval reaches past the query start
+    auto first = std::lower_bound(intervals.begin(), intervals.end(), end, [](const Interval& interval, long long value) {
+        return interval.start < value;
+    });
+
+    for (std::size_t i = static_cast<std::size_t>(first - intervals.begin()); i-- > 0;) {
+        if (maxEnd[i] <= start)
+            break;
+
+        const Interval& interval = intervals[i];
+        if (interval.end > start && dayNumber >= interval.firstDay && dayNumber <= interval.lastDay)
+            return true;
+    }
+
+    return false;
+}
+
+Planner::Availability::Availability() : windowStart(DefaultStudyStartHour), windowEnd(DefaultStudyStartHour + 24) {}
+
+Planner::Availability::Batch::Batch(Availability& availability) : availability(availability) {
+    availability.weekly.defer();
+    availability.once.defer();
+    availability.reserved.defer();
+}
+
+Planner::Availability::Batch::~Batch() {
+    availability.weekly.build();
+    availability.once.build();
+    availability.reserved.build();
+}
+
+int Planner::Availability::weekdayOf(int dayNumber) {
+    // 1970-01-01 was a Thursday
+    return ((dayNumber + 3) % 7 + 7) % 7;
+}
+
+void Planner::Availability::addWeekly(int weekday, int startMinute, int endMinute, int firstDay, int lastDay) {
+    weekday = ((weekday % 7) + 7) % 7;
+
+    // Split at midnight so every piece belongs to exactly one day
+    while (endMinute > startMinute) {
+        int pieceEnd = std::min(endMinute, MinutesPerDay);
+        if (startMinute < pieceEnd) {
+            long long base = static_cast<long long>(weekday) * MinutesPerDay;
+            weekly.add({base + std::max(startMinute, 0), base + pieceEnd, firstDay, lastDay});
+        }
+
+        startMinute = std::max(startMinute - MinutesPerDay, 0);
+        endMinute -= MinutesPerDay;
+        weekday = (weekday + 1) % 7;
+        if (firstDay != INT_MIN)
+            ++firstDay;
+        if (lastDay != INT_MAX)
+            ++lastDay;
+    }
+}
+
+void Planner::Availability::addBusy(long long start, long long end) {
+    once.add({start, end, INT_MIN, INT_MAX});
+}
+
+void Planner::Availability::reserve(const std::string& tag, long long start, long long end) {
+    if (end <= start)
+        return;
+    Interval interval{start, end, INT_MIN, INT_MAX};
+    tagged[tag].push_back(interval);
+    reserved.add(interval);
+}
+
+void Planner::Availability::release(const std::string& tag) {
+    if (tagged.erase(tag) == 0)
+        return;
+    reserved.clear();
+    reserved.defer();
+    for (const auto& entry : tagged) {
+        for (const Interval& interval : entry.second)
+            reserved.add(interval);
+    }
+    reserved.build();
+}
+
+long long Planner::Availability::reservedMinutes(const std::string& tag) const {
+    auto found = tagged.find(tag);
+    if (found == tagged.end())
+        return 0;
+    long long minutes = 0;
+    for (const Interval& interval : found->second)
+        minutes += interval.end - interval.start;
+    return minutes;
+}
+
+void Planner::Availability::clear() {
+    weekly.clear();
+    once.clear();
+    reserved.clear();
+    tagged.clear();
+}
+
+void Planner::Availability::setStudyWindow(int startHour, int endHour) {
+    windowStart = startHour;
+    windowEnd = std::max(startHour, endHour);
+}
+
+bool Planner::Availability::isFree(long long start, long long end) const {
+    if (once.overlaps(start, end, 0) || reserved.overlaps(start, end, 0))
+        return false;
+
+    // Check the weekly pattern one day at a time
+    for (long long dayStart = start - ((start % MinutesPerDay) + MinutesPerDay) % MinutesPerDay; dayStart < end;
+         dayStart += MinutesPerDay) {
+        int dayNumber = static_cast<int>(dayStart / MinutesPerDay);
+        long long from = std::max(start, dayStart) - dayStart;
+        long long to = std::min(end, dayStart + MinutesPerDay) - dayStart;
+        long long base = static_cast<long long>(weekdayOf(dayNumber)) * MinutesPerDay;
+
+        if (weekly.overlaps(base + from, base + to, dayNumber))
+            return false;
+    }
+
+    return true;
+}
+
+int Planner::Availability::freeStudyHours(int dayNumber, int maxHours, std::vector<int>& startHours) const {
+    startHours.clear();
+
+    long long midnight = static_cast<long long>(dayNumber) * MinutesPerDay;
+    for (int hour = windowStart; hour < windowEnd && static_cast<int>(startHours.size()) < maxHours; ++hour) {
+        long long start = midnight + hour * 60LL;
+        if (isFree(start, start + 60))
+            startHours.push_back(hour);
+    }
+
+    return static_cast<int>(startHours.size());
+}
+
+Planner::Availability Planner::loadAvailability(const std::string& filename) {
+    PLANNER_MEMORY_SCOPE(Load);
+    Availability availability;
+
+    std::ifstream file(filename);
+    if (!file.is_open())
+        return availability;
+
+    try {
+        json jsonData;
+        file >> jsonData;
+        Availability::Batch batch(availability);
+
+        if (jsonData.contains("window")) {
+            availability.setStudyWindow(jsonData["window"].at("start").get<int>(), jsonData["window"].at("end").get<int>());
+        }
+
+        for (const auto& obj : jsonData.value("weekly", json::array())) {
+            availability.addWeekly(obj.at("weekday").get<int>(), obj.at("start").get<int>(), obj.at("end").get<int>(),
+                                   obj.value("first_day", INT_MIN), obj.value("last_day", INT_MAX));
+        }
+
+        for (const auto& obj : jsonData.value("busy", json::array())) {
+            availability.addBusy(obj.at("start").get<long long>(), obj.at("end").get<long long>());
+        }
+
+        for (const auto& obj : jsonData.value("reserved", json::array())) {
+            availability.reserve(obj.at("tag").get<std::string>(), obj.at("start").get<long long>(),
+                                 obj.at("end").get<long long>());
+        }
+    } catch (const json::exception& e) {
+        std::cerr << "Error: Failed to parse availability JSON - " << e.what() << "\n";
+    }
+
+    return availability;
+}
+
+bool Planner::saveAvailability(const std::string& filename, const Availability& availability) {
+    PLANNER_MEMORY_SCOPE(Save);
+    std::ofstream file(filename, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << " for writing.\n";
+        return false;
+    }
+
+    json weekly = json::array();
+    for (const auto& interval : availability.weeklyIntervals()) {
+        json obj = {
+            {"weekday", interval.start / MinutesPerDay},
+            {"start", interval.start % MinutesPerDay},
+            {"end", interval.end - (interval.start / MinutesPerDay) * MinutesPerDay}
+        };
+        if (interval.firstDay != INT_MIN)
+            obj["first_day"] = interval.firstDay;
+        if (interval.lastDay != INT_MAX)
+            obj["last_day"] = interval.lastDay;
+        weekly.push_back(obj);
+    }
+
+    json busy = json::array();
+    for (const auto& interval : availability.busyIntervals()) {
+        busy.push_back({{"start", interval.start}, {"end", interval.end}});
+    }
+
+    json reserved = json::array();
+    for (const auto& entry : availability.reservations()) {
+        for (const auto& interval : entry.second)
+            reserved.push_back({{"tag", entry.first}, {"start", interval.start}, {"end", interval.end}});
+    }
+
+    json jsonData = {
+        {"window", {{"start", availability.studyWindowStart()}, {"end", availability.studyWindowEnd()}}},
+        {"weekly", weekly},
+        {"busy", busy},
+        {"reserved", reserved}
+    };
+
+    file << jsonData.dump(4);
+    file.close();
+    return !file.fail();
+}
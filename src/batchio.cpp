@@ -0,0 +1,672 @@
+#include "../include/batchio.hpp"
+#include "../include/trace.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <utility>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define PLANNER_HAVE_URING 1
+#endif
+#endif
+
+#if PLANNER_HAVE_URING
+#include <linux/io_uring.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace {
+    // Registered buffer per request in flight; plan files and calendars fit in one
+    constexpr std::size_t SlotBufferSize = 64 * 1024;
+
+    // user_data of cancel requests, which no slot uses
+    constexpr std::uint64_t CancelRequest = ~std::uint64_t(0);
+
+    // Whole file through an ifstream, the path batch I/O is measured against
+    bool readStream(const std::string& path, std::string& data) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+            return false;
+        std::streamoff size = file.tellg();
+        file.seekg(0);
+        data.resize(static_cast<std::size_t>(std::max<std::streamoff>(size, 0)));
+        file.read(&data[0], static_cast<std::streamsize>(data.size()));
+        return static_cast<bool>(file);
+    }
+
+    bool writeStream(const std::string& path, const std::string& data) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        file.close();
+        return !file.fail();
+    }
+
+#if PLANNER_HAVE_URING
+    // One io_uring instance with its submission and completion rings mapped
+    // into this process. There is no liburing here, so this talks to the
+    // kernel through the raw system calls.
+    class Uring {
+    public:
+        explicit Uring(unsigned entries) {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+            fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (fd < 0)
+                return;
+            if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+                // Older than 5.6: no OPENAT, READ or WRITE opcodes
+                release();
+                return;
+            }
+
+            sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (singleMap)
+                sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+            sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+            sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            cqRing = singleMap ? sqRing
+                               : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            void* sqeMap = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+            if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqeMap == MAP_FAILED) {
+                if (sqeMap != MAP_FAILED)
+                    munmap(sqeMap, sqesSize);
+                release();
+                return;
+            }
+
+            auto* sq = static_cast<char*>(sqRing);
+            auto* cq = static_cast<char*>(cqRing);
+            sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+            sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            sqes = static_cast<io_uring_sqe*>(sqeMap);
+            sqEntries = params.sq_entries;
+            localTail = *sqTail;
+        }
+
+        ~Uring() {
+            if (sqes)
+                munmap(sqes, sqesSize);
+            release();
+        }
+
+        Uring(const Uring&) = delete;
+        Uring& operator=(const Uring&) = delete;
+
+        bool ok() const { return fd >= 0; }
+
+        // Register buffers for the READ_FIXED and WRITE_FIXED opcodes
+        bool registerBuffers(const std::vector<iovec>& buffers) {
+            return syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, buffers.data(),
+                           static_cast<unsigned>(buffers.size())) == 0;
+        }
+
+        // A cleared submission entry, or nullptr if the ring is full
+        io_uring_sqe* nextEntry() {
+            unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+            if (localTail - head >= sqEntries)
+                return nullptr;
+            unsigned index = localTail & sqMask;
+            io_uring_sqe* entry = &sqes[index];
+            std::memset(entry, 0, sizeof(*entry));
+            sqArray[index] = index;
+            ++localTail;
+            ++queued;
+            return entry;
+        }
+
+        // Hand queued entries to the kernel and wait until at least
+        // waitFor completions are available
+        bool submit(unsigned waitFor) {
+            __atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+            for (;;) {
+                long submitted = syscall(__NR_io_uring_enter, fd, queued, waitFor,
+                                         waitFor ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+                if (submitted >= 0) {
+                    queued -= static_cast<unsigned>(submitted);
+                    return true;
+                }
+                if (errno != EINTR)
+                    return false;
+            }
+        }
+
+        bool pop(io_uring_cqe& completion) {
+            unsigned head = *cqHead;
+            if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+                return false;
+            completion = cqes[head & cqMask];
+            __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+
+    private:
+        void release() {
+            if (cqRing && cqRing != MAP_FAILED && !singleMap)
+                munmap(cqRing, cqRingSize);
+            if (sqRing && sqRing != MAP_FAILED)
+                munmap(sqRing, sqRingSize);
+            if (fd >= 0)
+                close(fd);
+            fd = -1;
+        }
+
+        int fd = -1;
+        bool singleMap = false;
+        void* sqRing = nullptr;
+        void* cqRing = nullptr;
+        std::size_t sqRingSize = 0;
+        std::size_t cqRingSize = 0;
+        std::size_t sqesSize = 0;
+        unsigned* sqHead = nullptr;
+        unsigned* sqTail = nullptr;
+        unsigned* sqArray = nullptr;
+        unsigned sqMask = 0;
+        unsigned sqEntries = 0;
+        unsigned* cqHead = nullptr;
+        unsigned* cqTail = nullptr;
+        unsigned cqMask = 0;
+        io_uring_cqe* cqes = nullptr;
+        io_uring_sqe* sqes = nullptr;
+        unsigned localTail = 0;
+        unsigned queued = 0;
+    };
+
+    // A file in flight. Each slot owns one registered buffer.
+    struct Slot {
+        enum class Stage { Free, Opening, Transferring };
+
+        Stage stage = Stage::Free;
+        std::size_t index = 0;
+        std::string path; // Kept alive for the asynchronous open
+        std::string data;
+        std::uint64_t offset = 0;
+        std::uint64_t size = 0; // Known file size when reading, 0 if unknown
+        int fd = -1;
+    };
+
+    // The ring, the slots and their buffers, shared by the reader and writer
+    class SlotRing {
+    public:
+        explicit SlotRing(unsigned depth) : slots(std::max(depth, 1u)), ring(std::max(depth, 1u) * 2) {
+            if (!ring.ok())
+                return;
+            buffers.reset(new char[slots.size() * SlotBufferSize]);
+            std::vector<iovec> iovecs(slots.size());
+            for (std::size_t i = 0; i < slots.size(); ++i) {
+                iovecs[i].iov_base = buffer(i);
+                iovecs[i].iov_len = SlotBufferSize;
+                freeSlots.push_back(static_cast<unsigned>(slots.size() - 1 - i));
+            }
+            // Without registered buffers (a tight memlock limit) plain reads and writes still work
+            registered = ring.registerBuffers(iovecs);
+        }
+
+        ~SlotRing() {
+            for (Slot& slot : slots) {
+                if (slot.fd >= 0)
+                    close(slot.fd);
+            }
+        }
+
+        bool ok() const { return ring.ok(); }
+        char* buffer(std::size_t slot) { return buffers.get() + slot * SlotBufferSize; }
+
+        // Queue an open of the slot's path
+        bool open(unsigned slot, int flags) {
+            io_uring_sqe* entry = ring.nextEntry();
+            if (!entry)
+                return false;
+            entry->opcode = IORING_OP_OPENAT;
+            entry->fd = AT_FDCWD;
+            entry->addr = reinterpret_cast<std::uint64_t>(slots[slot].path.c_str());
+            entry->len = 0644; // Mode of created files
+            entry->open_flags = static_cast<std::uint32_t>(flags | O_CLOEXEC);
+            entry->user_data = slot;
+            slots[slot].stage = Slot::Stage::Opening;
+            ++inFlight;
+            return true;
+        }
+
+        // Queue a read or write of length bytes at the slot's offset
+        bool transfer(unsigned slot, bool write, char* address, std::size_t length) {
+            io_uring_sqe* entry = ring.nextEntry();
+            if (!entry)
+                return false;
+            bool fixed = registered && address >= buffer(slot) && address < buffer(slot) + SlotBufferSize;
+            if (write)
+                entry->opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+            else
+                entry->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+            entry->fd = slots[slot].fd;
+            entry->addr = reinterpret_cast<std::uint64_t>(address);
+            entry->len = static_cast<std::uint32_t>(length);
+            entry->off = slots[slot].offset;
+            entry->buf_index = static_cast<std::uint16_t>(fixed ? slot : 0);
+            entry->user_data = slot;
+            slots[slot].stage = Slot::Stage::Transferring;
+            ++inFlight;
+            return true;
+        }
+
+        // Close the slot's file and return the slot to the free list.
+        // Returns false if the close reported an error.
+        bool finish(unsigned slot) {
+            bool closed = true;
+            if (slots[slot].fd >= 0)
+                closed = close(slots[slot].fd) == 0;
+            slots[slot] = Slot();
+            freeSlots.push_back(slot);
+            return closed;
+        }
+
+        // Cancel the requests in flight and wait until the kernel is done
+        // with every slot. The slots keep their paths and data. Returns false
+        // if the ring cannot be waited on; the kernel may then still use the
+        // buffers and paths, so they must not be freed.
+        bool cancel() {
+            for (unsigned slot = 0; slot < slots.size(); ++slot) {
+                if (slots[slot].stage == Slot::Stage::Free)
+                    continue;
+                io_uring_sqe* entry = ring.nextEntry();
+                if (!entry)
+                    break; // The rest run to completion instead
+                entry->opcode = IORING_OP_ASYNC_CANCEL;
+                entry->addr = slot;
+                entry->user_data = CancelRequest;
+            }
+
+            while (inFlight > 0) {
+                bool submitted = ring.submit(1);
+                bool reaped = false;
+                io_uring_cqe completion;
+                while (ring.pop(completion)) {
+                    reaped = true;
+                    if (completion.user_data == CancelRequest)
+                        continue;
+                    --inFlight;
+                    // An open that finished before the cancel still needs closing
+                    Slot& current = slots[static_cast<unsigned>(completion.user_data)];
+                    if (current.stage == Slot::Stage::Opening && completion.res >= 0)
+                        current.fd = completion.res;
+                }
+                // A full completion ring refuses submissions until it is reaped
+                if (!submitted && !reaped)
+                    return false;
+            }
+            return true;
+        }
+
+        // Buffers outlive the ring, which the kernel may still write through
+        std::unique_ptr<char[]> buffers;
+        std::vector<Slot> slots;
+        std::vector<unsigned> freeSlots;
+        Uring ring;
+        bool registered = false;
+        unsigned inFlight = 0;
+    };
+
+    // Stop the kernel using the ring and free it. If the kernel cannot be
+    // waited on it may still use the buffers, so they are left allocated.
+    void releaseRing(std::unique_ptr<SlotRing>& ring) {
+        if (!ring->cancel())
+            ring.release();
+        ring.reset();
+    }
+#endif
+}
+
+bool Planner::uringAvailable() {
+#if PLANNER_HAVE_URING
+    static const bool available = Uring(2).ok();
+    return available;
+#else
+    return false;
+#endif
+}
+
+const char* Planner::ioBackendName(IoBackend backend) {
+    switch (backend) {
+        case IoBackend::Auto: return "auto";
+        case IoBackend::Uring: return "io_uring";
+        case IoBackend::Stream: return "iostream";
+    }
+    return "unknown";
+}
+
+struct Planner::BatchReader::State {
+    std::vector<std::string> paths;
+    std::size_t nextPath = 0;
+    std::deque<FileData> ready;
+    IoBackend backend = IoBackend::Stream;
+#if PLANNER_HAVE_URING
+    std::unique_ptr<SlotRing> ring;
+
+    // Open as many files as there are free slots
+    void startOpens() {
+        while (nextPath < paths.size() && !ring->freeSlots.empty()) {
+            unsigned slot = ring->freeSlots.back();
+            Slot& current = ring->slots[slot];
+            current.index = nextPath;
+            current.path = paths[nextPath];
+            if (!ring->open(slot, O_RDONLY))
+                return;
+            ring->freeSlots.pop_back();
+            ++nextPath;
+        }
+    }
+
+    void complete(unsigned slot, bool ok) {
+        Slot& current = ring->slots[slot];
+        FileData file;
+        file.index = current.index;
+        file.path = std::move(current.path);
+        file.data = std::move(current.data);
+        file.ok = ok;
+        ring->finish(slot);
+        if (!file.ok)
+            file.data.clear();
+        ready.push_back(std::move(file));
+    }
+
+    void readMore(unsigned slot) {
+        if (!ring->transfer(slot, false, ring->buffer(slot), SlotBufferSize))
+            complete(slot, false);
+    }
+
+    // Handle every available completion, queueing the follow-up reads
+    void reap() {
+        io_uring_cqe completion;
+        while (ring->ring.pop(completion)) {
+            unsigned slot = static_cast<unsigned>(completion.user_data);
+            Slot& current = ring->slots[slot];
+            --ring->inFlight;
+            if (completion.res < 0) {
+                complete(slot, false);
+                continue;
+            }
+
+            if (current.stage == Slot::Stage::Opening) {
+                current.fd = completion.res;
+                struct stat info;
+                if (fstat(current.fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+                    current.size = static_cast<std::uint64_t>(info.st_size);
+                    current.data.reserve(current.size);
+                }
+                readMore(slot);
+                continue;
+            }
+
+            current.data.append(ring->buffer(slot), static_cast<std::size_t>(completion.res));
+            current.offset += static_cast<std::uint64_t>(completion.res);
+            bool done = completion.res == 0 || (current.size > 0 && current.offset >= current.size);
+            if (done)
+                complete(slot, true);
+            else
+                readMore(slot);
+        }
+    }
+
+    // The ring stopped working: cancel what is in flight and read those
+    // files and the rest with iostreams
+    void abandonRing() {
+        std::vector<FileData> retries;
+        for (const Slot& slot : ring->slots) {
+            if (slot.stage != Slot::Stage::Free) {
+                retries.emplace_back();
+                retries.back().index = slot.index;
+                retries.back().path = slot.path;
+            }
+        }
+        releaseRing(ring);
+
+        for (FileData& file : retries) {
+            file.ok = readStream(file.path, file.data);
+            ready.push_back(std::move(file));
+        }
+        backend = IoBackend::Stream;
+    }
+#endif
+};
+
+Planner::BatchReader::BatchReader(std::vector<std::string> paths, IoBackend backend, unsigned depth)
+    : state(std::make_unique<State>()) {
+    state->paths = std::move(paths);
+#if PLANNER_HAVE_URING
+    if (backend != IoBackend::Stream) {
+        state->ring = std::make_unique<SlotRing>(depth);
+        if (state->ring->ok())
+            state->backend = IoBackend::Uring;
+        else
+            state->ring.reset();
+    }
+#else
+    (void)backend;
+    (void)depth;
+#endif
+}
+
+Planner::BatchReader::~BatchReader() {
+#if PLANNER_HAVE_URING
+    // The kernel may still write into the buffers; stop it before freeing them
+    if (state->ring)
+        releaseRing(state->ring);
+#endif
+}
+
+bool Planner::BatchReader::next(FileData& file) {
+    PLANNER_TRACE_SCOPE("batchRead");
+    while (state->ready.empty()) {
+#if PLANNER_HAVE_URING
+        if (state->ring) {
+            state->startOpens();
+            if (state->ring->inFlight == 0)
+                return false;
+            if (!state->ring->ring.submit(1)) {
+                state->abandonRing();
+                continue;
+            }
+            state->reap();
+            continue;
+        }
+#endif
+        if (state->nextPath >= state->paths.size())
+            return false;
+        FileData read;
+        read.index = state->nextPath;
+        read.path = state->paths[state->nextPath++];
+        read.ok = readStream(read.path, read.data);
+        state->ready.push_back(std::move(read));
+    }
+
+#if PLANNER_HAVE_URING
+    // Keep the kernel busy while the caller works on this file
+    if (state->ring) {
+        state->startOpens();
+        if (!state->ring->ring.submit(0))
+            state->abandonRing();
+    }
+#endif
+    file = std::move(state->ready.front());
+    state->ready.pop_front();
+    return true;
+}
+
+Planner::IoBackend Planner::BatchReader::backend() const {
+    return state->backend;
+}
+
+struct Planner::BatchWriter::State {
+    IoBackend backend = IoBackend::Stream;
+    std::vector<std::string> failures;
+#if PLANNER_HAVE_URING
+    std::unique_ptr<SlotRing> ring;
+
+    void complete(unsigned slot, bool ok) {
+        std::string path = ring->slots[slot].path;
+        if (!ring->finish(slot))
+            ok = false;
+        if (!ok)
+            failures.push_back(path);
+    }
+
+    void writeMore(unsigned slot) {
+        Slot& current = ring->slots[slot];
+        std::size_t remaining = current.data.size() - current.offset;
+        // Small files were copied into the registered buffer when queued
+        char* source = current.data.size() <= SlotBufferSize ? ring->buffer(slot) : &current.data[0];
+        if (!ring->transfer(slot, true, source + current.offset, remaining))
+            complete(slot, false);
+    }
+
+    void reap() {
+        io_uring_cqe completion;
+        while (ring->ring.pop(completion)) {
+            unsigned slot = static_cast<unsigned>(completion.user_data);
+            Slot& current = ring->slots[slot];
+            --ring->inFlight;
+            if (completion.res < 0) {
+                complete(slot, false);
+                continue;
+            }
+
+            if (current.stage == Slot::Stage::Opening) {
+                current.fd = completion.res;
+                if (current.data.empty())
+                    complete(slot, true);
+                else
+                    writeMore(slot);
+                continue;
+            }
+
+            current.offset += static_cast<std::uint64_t>(completion.res);
+            if (completion.res == 0)
+                complete(slot, false); // No progress: the disk is full or the file went away
+            else if (current.offset >= current.data.size())
+                complete(slot, true);
+            else
+                writeMore(slot);
+        }
+    }
+
+    // Wait for completions until at most maxInFlight requests are left
+    bool drainTo(unsigned maxInFlight) {
+        while (ring->inFlight > maxInFlight) {
+            if (!ring->ring.submit(1))
+                return false;
+            reap();
+        }
+        return true;
+    }
+
+    // The ring stopped working: cancel what is in flight and write those
+    // files again with iostreams
+    void abandonRing() {
+        std::vector<std::pair<std::string, std::string>> retries;
+        for (const Slot& slot : ring->slots) {
+            if (slot.stage != Slot::Stage::Free)
+                retries.emplace_back(slot.path, slot.data);
+        }
+        releaseRing(ring);
+
+        for (const auto& retry : retries) {
+            if (!writeStream(retry.first, retry.second))
+                failures.push_back(retry.first);
+        }
+        backend = IoBackend::Stream;
+    }
+#endif
+};
+
+Planner::BatchWriter::BatchWriter(IoBackend backend, unsigned depth) : state(std::make_unique<State>()) {
+#if PLANNER_HAVE_URING
+    if (backend != IoBackend::Stream) {
+        state->ring = std::make_unique<SlotRing>(depth);
+        if (state->ring->ok())
+            state->backend = IoBackend::Uring;
+        else
+            state->ring.reset();
+    }
+#else
+    (void)backend;
+    (void)depth;
+#endif
+}
+
+Planner::BatchWriter::~BatchWriter() {
+    finish();
+}
+
+void Planner::BatchWriter::add(const std::string& path, std::string data) {
+    PLANNER_TRACE_SCOPE("batchWrite");
+#if PLANNER_HAVE_URING
+    if (state->ring) {
+        // A free slot frees up once one of the files in flight is done
+        while (state->ring->freeSlots.empty()) {
+            if (!state->ring->ring.submit(1)) {
+                state->abandonRing();
+                break;
+            }
+            state->reap();
+        }
+    }
+    if (state->ring) {
+        unsigned slot = state->ring->freeSlots.back();
+        Slot& current = state->ring->slots[slot];
+        current.path = path;
+        current.data = std::move(data);
+        if (current.data.size() <= SlotBufferSize)
+            std::memcpy(state->ring->buffer(slot), current.data.data(), current.data.size());
+
+        if (state->ring->open(slot, O_WRONLY | O_CREAT | O_TRUNC)) {
+            state->ring->freeSlots.pop_back();
+            if (state->ring->ring.submit(0))
+                return;
+            state->abandonRing();
+            return;
+        }
+        // The submission ring is full; write this one directly
+        data = std::move(current.data);
+        current = Slot();
+    }
+#endif
+    if (!writeStream(path, data))
+        state->failures.push_back(path);
+}
+
+std::size_t Planner::BatchWriter::finish() {
+#if PLANNER_HAVE_URING
+    if (state->ring && !state->ring->ring.submit(0))
+        state->abandonRing();
+    if (state->ring && !state->drainTo(0))
+        state->abandonRing();
+#endif
+    return state->failures.size();
+}
+
+const std::vector<std::string>& Planner::BatchWriter::failures() const {
+    return state->failures;
+}
+
+Planner::IoBackend Planner::BatchWriter::backend() const {
+    return state->backend;
+}
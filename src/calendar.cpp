@@ -0,0 +1,40 @@
+#include "../include/calendar.hpp"
+
+// Proleptic Gregorian date to day count, independent of the time zone
+int Planner::dayNumber(int year, int month, int day) {
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const int yearOfEra = year - era * 400;
+    const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// Inverse of dayNumber, same algorithm run backwards
+void Planner::civilFromDayNumber(int dayNumber, int& year, int& month, int& day) {
+    dayNumber += 719468;
+    const int era = (dayNumber >= 0 ? dayNumber : dayNumber - 146096) / 146097;
+    const int dayOfEra = dayNumber - era * 146097;
+    const int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int monthIndex = (5 * dayOfYear + 2) / 153;
+
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = yearOfEra + era * 400 + (month <= 2);
+}
+
+int Planner::daysInMonth(int year, int month) {
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : days[month - 1];
+}
+
+int Planner::dayNumber(const std::tm& date) {
+    return dayNumber(date.tm_year + 1900, date.tm_mon + 1, date.tm_mday);
+}
+
+int Planner::today() {
+    std::time_t now = std::time(nullptr);
+    return dayNumber(*std::localtime(&now));
+}
@@ -0,0 +1,107 @@
+#include "../include/capacity.hpp"
+#include "../include/availability.hpp"
+#include "../include/calendar.hpp"
+#include "../include/simulation.hpp"
+#include "../include/memtrack.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+Planner::CapacityTable::CapacityTable(std::vector<int> pattern, int phase, int horizon)
+    : pattern(std::move(pattern)), phase(phase) {
+    patternPrefix.assign(this->pattern.size() + 1, 0);
+    for (std::size_t i = 0; i < this->pattern.size(); ++i)
+        patternPrefix[i + 1] = patternPrefix[i] + this->pattern[i];
+
+    hours.assign(static_cast<std::size_t>(std::max(horizon, 0)) + 1, 0);
+    for (int day = 1; day <= this->horizon(); ++day)
+        hours[day] = patternHours(day);
+}
+
+void Planner::CapacityTable::finish() {
+    prefix.assign(hours.size(), 0);
+    for (std::size_t day = 1; day < hours.size(); ++day)
+        prefix[day] = prefix[day - 1] + hours[day];
+}
+
+int Planner::CapacityTable::patternHours(int day) const {
+    const int size = static_cast<int>(pattern.size());
+    return pattern[((day + phase) % size + size) % size];
+}
+
+long long Planner::CapacityTable::cycleSum(long long n) const {
+    const long long size = static_cast<long long>(pattern.size());
+    return (n / size) * patternPrefix.back() + patternPrefix[static_cast<std::size_t>(n % size)];
+}
+
+int Planner::CapacityTable::hoursFor(int day) const {
+    if (day < 1)
+        return 0;
+    return day <= horizon() ? hours[day] : patternHours(day);
+}
+
+long long Planner::CapacityTable::hoursThrough(int day) const {
+    if (day < 1)
+        return 0;
+    const int last = horizon();
+    if (day <= last)
+        return prefix[day];
+    // Days past the horizon repeat the pattern, whole cycles at a time
+    return prefix[last] + cycleSum(static_cast<long long>(day) + phase + 1) - cycleSum(static_cast<long long>(last) + phase + 1);
+}
+
+Planner::CapacityTable Planner::CapacityTable::legacy(int weekdayStudyHours, int weekendStudyHours, int horizon) {
+    // The rule repeats every lcm(6, 7) = 42 days
+    std::vector<int> pattern(42);
+    for (int day = 0; day < 42; ++day)
+        pattern[day] = studyHoursForDay(day, weekdayStudyHours, weekendStudyHours);
+
+    CapacityTable table(std::move(pattern), 0, horizon);
+    table.finish();
+    return table;
+}
+
+Planner::CapacityTable Planner::CapacityTable::calendar(int startDay, const std::array<int, 7>& weeklyHours,
+                                                        const std::vector<Holiday>& holidays, int horizon) {
+    PLANNER_MEMORY_SCOPE(Schedule);
+    CapacityTable table(std::vector<int>(weeklyHours.begin(), weeklyHours.end()),
+                        Availability::weekdayOf(startDay), horizon);
+    for (const Holiday& holiday : holidays) {
+        int day = holiday.day - startDay;
+        if (day >= 1 && day <= table.horizon())
+            table.hours[day] = std::max(holiday.hours, 0);
+    }
+    table.finish();
+    return table;
+}
+
+Planner::CapacityTable Planner::calendarCapacity(int startDay, int weekdayStudyHours, int weekendStudyHours,
+                                                 const std::vector<Holiday>& holidays, int horizon) {
+    std::array<int, 7> weeklyHours;
+    weeklyHours.fill(weekdayStudyHours);
+    weeklyHours[5] = weeklyHours[6] = weekendStudyHours;
+    return CapacityTable::calendar(startDay, weeklyHours, holidays, horizon);
+}
+
+std::vector<Planner::Holiday> Planner::loadHolidays(const std::string& filename) {
+    std::vector<Holiday> holidays;
+    std::ifstream file(filename);
+    if (!file.is_open())
+        return holidays;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        int year, month, day, hours = 0;
+        if (std::sscanf(line.c_str(), "%d-%d-%d %d", &year, &month, &day, &hours) < 3 || month < 1 || month > 12 ||
+            day < 1 || day > daysInMonth(year, month)) {
+            std::cerr << "Error: Ignoring holiday line '" << line << "' in " << filename << "\n";
+            continue;
+        }
+        holidays.push_back({dayNumber(year, month, day), hours});
+    }
+    return holidays;
+}
@@ -1,29 +1,37 @@
 #include "../include/displayfunctions.hpp"
+#include "../include/memtrack.hpp"
+#include "../include/calendar.hpp"
+#include "../include/filter.hpp"
 #include <iostream>
 #include <algorithm>
 #include <limits>
+#include <iomanip>
+#include <stdexcept>
 
 // Display all assignments
-void DisplayFunctions::displayAllAssignments(const std::vector<AssignmentPtr>& assignments) {
+void DisplayFunctions::displayAllAssignments(const Planner::AssignmentStore& assignments) {
+    PLANNER_MEMORY_SCOPE(Display);
     if (assignments.empty()) {
         std::cout << "No assignments to display.\n";
         return;
     }
 
     std::cout << "\nAll Assignments:\n";
-    for (const auto& assignment : assignments) {
-        assignment->display();
+    for (Planner::AssignmentHandle handle : assignments.handles()) {
+        assignments[handle].display();
         std::cout << "---------------------------\n";
     }
 }
 
 // Display assignments filtered by subject
-void DisplayFunctions::displayAssignmentsBySubject(const std::vector<AssignmentPtr>& assignments, const std::string& subject) {
+void DisplayFunctions::displayAssignmentsBySubject(const Planner::AssignmentStore& assignments, const std::string& subject) {
+    PLANNER_MEMORY_SCOPE(Display);
     std::cout << "\nAssignments for Subject: " << subject << "\n";
     bool found = false;
-    for (const auto& assignment : assignments) {
-        if (assignment->getSubject() == subject) {
-            assignment->display();
+    for (Planner::AssignmentHandle handle : assignments.handles()) {
+        const Assignment& assignment = assignments[handle];
+        if (assignment.getSubject() == subject) {
+            assignment.display();
             std::cout << "---------------------------\n";
             found = true;
         }
@@ -34,64 +42,206 @@ void DisplayFunctions::displayAssignmentsBySubject(const std::vector<AssignmentP
     }
 }
 
+// Display assignments matching a filter expression
+void DisplayFunctions::displayAssignmentsMatching(const Planner::AssignmentStore& assignments, const std::string& expression) {
+    PLANNER_MEMORY_SCOPE(Display);
+    Planner::AssignmentFilter filter(expression);
+    auto rows = filter.select(Planner::makeAssignmentColumns(assignments));
+
+    std::cout << "\nAssignments matching: " << expression << "\n";
+    const auto& handles = assignments.handles();
+    for (std::uint32_t row : rows) {
+        assignments[handles[row]].display();
+        std::cout << "---------------------------\n";
+    }
+
+    if (rows.empty()) {
+        std::cout << "No assignments match.\n";
+    }
+}
+
+// Display assignments found by a fragment of their name or subject
+void DisplayFunctions::displaySearchResults(const Planner::AssignmentStore& assignments, const Planner::TextIndex& index,
+                                            const std::string& query) {
+    PLANNER_MEMORY_SCOPE(Display);
+    auto found = index.search(query);
+    if (!found.empty()) {
+        std::cout << "\nAssignments matching \"" << query << "\":\n";
+        for (std::uint32_t handle : found)
+            std::cout << assignments[handle].getName() << " (" << assignments[handle].getSubject() << ")\n";
+        return;
+    }
+
+    auto close = index.searchFuzzy(query, 5);
+    if (close.empty()) {
+        std::cout << "No assignments match \"" << query << "\".\n";
+        return;
+    }
+    std::cout << "No exact match for \"" << query << "\". Did you mean:\n";
+    for (const auto& match : close)
+        std::cout << assignments[match.id].getName() << " (" << assignments[match.id].getSubject() << ")\n";
+}
+
 // Display assignments sorted by shortest deadline
-void DisplayFunctions::displayAssignmentsByShortestDeadline(const std::vector<AssignmentPtr>& assignments) {
+void DisplayFunctions::displayAssignmentsByShortestDeadline(const Planner::AssignmentStore& assignments) {
+    PLANNER_MEMORY_SCOPE(Display);
     if (assignments.empty()) {
         std::cout << "No assignments to display.\n";
         return;
     }
 
     std::cout << "\nAssignments by Shortest Deadline:\n";
-    std::vector<AssignmentPtr> sortedAssignments(assignments);
+    std::vector<Planner::AssignmentHandle> sortedAssignments(assignments.handles());
 
     std::sort(sortedAssignments.begin(), sortedAssignments.end(),
-              [](const AssignmentPtr& a, const AssignmentPtr& b) {
-                  return a->getDeadline() < b->getDeadline();
+              [&assignments](Planner::AssignmentHandle a, Planner::AssignmentHandle b) {
+                  return assignments[a].getDeadline() < assignments[b].getDeadline();
               });
 
-    for (const auto& assignment : sortedAssignments) {
-        assignment->display();
+    for (Planner::AssignmentHandle handle : sortedAssignments) {
+        assignments[handle].display();
         std::cout << "---------------------------\n";
     }
 }
 
 // Display assignments sorted by biggest duration
-void DisplayFunctions::displayAssignmentsByBiggestDuration(const std::vector<AssignmentPtr>& assignments) {
+void DisplayFunctions::displayAssignmentsByBiggestDuration(const Planner::AssignmentStore& assignments) {
+    PLANNER_MEMORY_SCOPE(Display);
     if (assignments.empty()) {
         std::cout << "No assignments to display.\n";
         return;
     }
 
     std::cout << "\nAssignments by Biggest Duration:\n";
-    std::vector<AssignmentPtr> sortedAssignments(assignments);
+    std::vector<Planner::AssignmentHandle> sortedAssignments(assignments.handles());
 
     std::sort(sortedAssignments.begin(), sortedAssignments.end(),
-              [](const AssignmentPtr& a, const AssignmentPtr& b) {
-                  return a->getDuration() > b->getDuration();
+              [&assignments](Planner::AssignmentHandle a, Planner::AssignmentHandle b) {
+                  return assignments[a].getDuration() > assignments[b].getDuration();
               });
 
-    for (const auto& assignment : sortedAssignments) {
-        assignment->display();
+    for (Planner::AssignmentHandle handle : sortedAssignments) {
+        assignments[handle].display();
         std::cout << "---------------------------\n";
     }
 }
 
+// Display a study-hour sweep as a grid of missed deadlines
+void DisplayFunctions::displaySweepResult(const Planner::SweepResult& result) {
+    PLANNER_MEMORY_SCOPE(Display);
+    if (result.cells.empty()) {
+        std::cout << "No study-hour budgets to display.\n";
+        return;
+    }
+
+    int maxWeekend = 0;
+    for (const auto& cell : result.cells)
+        maxWeekend = std::max(maxWeekend, cell.weekendStudyHours);
+
+    std::cout << "\nMissed deadlines (rows: weekday hours, columns: weekend hours):\n";
+    std::cout << "    ";
+    for (int weekend = 1; weekend <= maxWeekend; ++weekend)
+        std::cout << std::setw(4) << weekend;
+    std::cout << "\n";
+
+    for (const auto& cell : result.cells) {
+        if (cell.weekendStudyHours == 1)
+            std::cout << std::setw(4) << cell.weekdayStudyHours;
+        std::cout << std::setw(4) << cell.stats.missedDeadlines;
+        if (cell.weekendStudyHours == maxWeekend)
+            std::cout << "\n";
+    }
+
+    if (result.cheapest < 0) {
+        std::cout << "No budget in this range meets every deadline.\n";
+        return;
+    }
+
+    const auto& best = result.cells[result.cheapest];
+    std::cout << "Cheapest budget with no missed deadlines: " << best.weekdayStudyHours
+              << " weekday hours, " << best.weekendStudyHours << " weekend hours ("
+              << Planner::weeklyStudyHours(best.weekdayStudyHours, best.weekendStudyHours)
+              << " hours per week)\n";
+}
+
+// Display the plan of the next few days, pulled one day at a time
+void DisplayFunctions::displayDaysAhead(const Planner::AssignmentStore& assignments, const Planner::ScheduleOptions& options,
+                                        int days) {
+    PLANNER_MEMORY_SCOPE(Display);
+    const auto& handles = assignments.handles();
+    Planner::ScheduleGenerator generator(assignments, options);
+    Planner::ScheduleDay day;
+
+    while (day.day < days && generator.next(day)) {
+        std::cout << "\nDay " << day.day << ":\n";
+        if (day.slots.empty() && day.missed.empty())
+            std::cout << "Nothing planned\n";
+        for (const auto& slot : day.slots) {
+            std::cout << std::setw(2) << std::setfill('0') << slot.startHour % 24 << ":00 "
+                      << std::setfill(' ') << assignments[handles[slot.assignment]].getName() << "\n";
+        }
+        for (const auto& missed : day.missed)
+            std::cout << "Missed deadline for assignment: " << assignments[handles[missed.assignment]].getName() << "\n";
+    }
+
+    if (generator.done())
+        std::cout << "\nEverything is planned by day " << generator.stats().days << ".\n";
+}
+
+// Display what to work on today and for how long
+void DisplayFunctions::displayTodaysFocus(const Planner::AssignmentStore& assignments,
+                                          const std::vector<Planner::FocusTask>& tasks) {
+    if (tasks.empty()) {
+        std::cout << "No study time today.\n";
+        return;
+    }
+
+    const auto& handles = assignments.handles();
+    std::cout << "\nToday's focus:\n";
+    for (const auto& task : tasks) {
+        const Assignment& assignment = assignments[handles[task.assignment]];
+        std::cout << assignment.getName() << " (" << assignment.getSubject() << "): " << task.hours
+                  << (task.hours == 1 ? " hour" : " hours") << "\n";
+    }
+}
+
+// Display shared group sessions and the group work they could not fit
+void DisplayFunctions::displayGroupPlan(const Planner::AssignmentStore& assignments, const Planner::GroupPlan& plan) {
+    if (plan.sessions.empty() && plan.shortfalls.empty()) {
+        std::cout << "No group assignments to plan.\n";
+        return;
+    }
+
+    const auto& handles = assignments.handles();
+    for (const auto& session : plan.sessions) {
+        int year, month, day;
+        Planner::civilFromDayNumber(session.day, year, month, day);
+        std::cout << year << "-" << std::setw(2) << std::setfill('0') << month << "-" << std::setw(2) << day << " "
+                  << std::setw(2) << session.startHour << ":00" << std::setfill(' ') << " " << session.hours
+                  << (session.hours == 1 ? " hour: " : " hours: ") << assignments[handles[session.assignment]].getName() << "\n";
+    }
+    for (const auto& shortfall : plan.shortfalls)
+        std::cout << "No common time for " << shortfall.hours << " more hours of "
+                  << assignments[handles[shortfall.assignment]].getName() << " before its deadline\n";
+}
+
 // Display menu options for assignments
-void DisplayFunctions::displayMenu(const std::vector<AssignmentPtr>& assignments) {
+void DisplayFunctions::displayMenu(const Planner::AssignmentStore& assignments) {
     while (true) {
         std::cout << "\nDisplay Menu:\n"
                   << "1. Display all assignments\n"
                   << "2. Display assignments by subject\n"
                   << "3. Display assignments by shortest deadline\n"
                   << "4. Display assignments by biggest duration\n"
-                  << "5. Go back\n"
+                  << "5. Filter assignments\n"
+                  << "6. Go back\n"
                   << "Enter your choice: ";
 
         int choice;
         std::cin >> choice;
 
         // Input validation
-        if (std::cin.fail() || choice < 1 || choice > 5) {
+        if (std::cin.fail() || choice < 1 || choice > 6) {
             std::cin.clear();
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             std::cout << "Invalid choice. Please try again.\n";
@@ -115,7 +265,19 @@ void DisplayFunctions::displayMenu(const std::vector<AssignmentPtr>& assignments
             case 4:
                 displayAssignmentsByBiggestDuration(assignments);
                 break;
-            case 5:
+            case 5: {
+                std::cout << "Filter (e.g. deadline < 7 && weight >= 15 && group_work): ";
+                std::string expression;
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                std::getline(std::cin, expression);
+                try {
+                    displayAssignmentsMatching(assignments, expression);
+                } catch (const std::invalid_argument& e) {
+                    std::cout << e.what() << "\n";
+                }
+                break;
+            }
+            case 6:
                 std::cout << "Exiting display menu.\n";
                 return;
         }
@@ -0,0 +1,93 @@
+#include "../include/feasibility.hpp"
+#include "../include/simulation.hpp"
+#include "../include/trace.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace {
+    // Hours each assignment needs, keyed by the last day it can be worked on
+    using Demand = std::vector<std::pair<int, long long>>;
+
+    // The scheduler always works at least one hour on an assignment and
+    // day 1 is always available, even for deadlines already due.
+    Demand sortedDemand(const Planner::AssignmentStore& assignments, int startDay = Planner::today()) {
+        Demand demand;
+        demand.reserve(assignments.size());
+        const int elapsed = startDay - assignments.epochDay();
+
+        for (Planner::AssignmentHandle handle : assignments.handles()) {
+            const Assignment& assignment = assignments[handle];
+            demand.emplace_back(std::max(assignment.getDeadline() - elapsed, 1),
+                                std::max(assignment.getRealDuration(), 1));
+        }
+
+        std::sort(demand.begin(), demand.end());
+        return demand;
+    }
+
+    // Every prefix of the deadline-ordered demand must fit in the capacity
+    // available up to its deadline
+    bool fits(const Demand& demand, const Planner::CapacityTable& capacity) {
+        long long required = 0;
+
+        for (std::size_t i = 0; i < demand.size(); ++i) {
+            required += demand[i].second;
+
+            // Only test at the last assignment sharing a deadline
+            if (i + 1 < demand.size() && demand[i + 1].first == demand[i].first)
+                continue;
+
+            if (required > capacity.hoursThrough(demand[i].first))
+                return false;
+        }
+
+        return true;
+    }
+
+    // Smallest daily budget whose capacity(budget) fits the demand, by binary search
+    template <typename MakeCapacity>
+    int smallestBudget(const Demand& demand, int maxHours, MakeCapacity capacity) {
+        if (demand.empty())
+            return 0;
+        if (maxHours < 1 || !fits(demand, capacity(maxHours)))
+            return -1;
+
+        // Feasibility is monotone in the budget
+        int low = 1;
+        int high = maxHours;
+        while (low < high) {
+            int middle = low + (high - low) / 2;
+            if (fits(demand, capacity(middle)))
+                high = middle;
+            else
+                low = middle + 1;
+        }
+
+        return low;
+    }
+}
+
+bool Planner::isFeasible(const AssignmentStore& assignments, int weekdayStudyHours, int weekendStudyHours) {
+    return fits(sortedDemand(assignments), CapacityTable::legacy(weekdayStudyHours, weekendStudyHours));
+}
+
+bool Planner::isFeasible(const AssignmentStore& assignments, const CapacityTable& capacity) {
+    return fits(sortedDemand(assignments), capacity);
+}
+
+int Planner::minimalBudget(const AssignmentStore& assignments, int maxHours) {
+    PLANNER_TRACE_SCOPE("minimalBudget");
+    return smallestBudget(sortedDemand(assignments), maxHours,
+                          [](int hours) { return CapacityTable::legacy(hours, hours); });
+}
+
+int Planner::minimalBudget(const AssignmentStore& assignments, int startDay, const std::vector<Holiday>& holidays,
+                           int maxHours) {
+    PLANNER_TRACE_SCOPE("minimalBudget");
+    const Demand demand = sortedDemand(assignments, startDay);
+    // Holidays only matter up to the last deadline
+    const int horizon = demand.empty() ? 0 : demand.back().first;
+    return smallestBudget(demand, maxHours, [&](int hours) {
+        return calendarCapacity(startDay, hours, hours, holidays, horizon);
+    });
+}
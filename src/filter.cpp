@@ -0,0 +1,505 @@
+#include "../include/filter.hpp"
+#include "../include/calendar.hpp"
+#include "../include/trace.hpp"
+#include "../include/memtrack.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+
+using Filter = Planner::AssignmentFilter;
+
+namespace {
+    // Rows tested together; each stack entry of the program is one block of results
+    constexpr std::size_t BlockSize = 2048;
+
+    // Index results are only used when they leave at most 1 row in IndexRatio
+    constexpr std::size_t IndexRatio = 8;
+
+    template <typename T, typename Compare>
+    void compareBlock(const T* column, std::size_t count, T value, std::uint8_t* out, Compare compare) {
+        // Branch-free, so the compiler can vectorise it
+        for (std::size_t i = 0; i < count; ++i)
+            out[i] = compare(column[i], value);
+    }
+
+    template <typename T>
+    void compareBlock(const T* column, std::size_t count, T value, Filter::Compare compare, std::uint8_t* out) {
+        switch (compare) {
+            case Filter::Compare::Less: compareBlock(column, count, value, out, std::less<T>()); break;
+            case Filter::Compare::LessEqual: compareBlock(column, count, value, out, std::less_equal<T>()); break;
+            case Filter::Compare::Greater: compareBlock(column, count, value, out, std::greater<T>()); break;
+            case Filter::Compare::GreaterEqual: compareBlock(column, count, value, out, std::greater_equal<T>()); break;
+            case Filter::Compare::Equal: compareBlock(column, count, value, out, std::equal_to<T>()); break;
+            case Filter::Compare::NotEqual: compareBlock(column, count, value, out, std::not_equal_to<T>()); break;
+        }
+    }
+
+    template <typename T>
+    bool compareValue(T a, T b, Filter::Compare compare) {
+        switch (compare) {
+            case Filter::Compare::Less: return a < b;
+            case Filter::Compare::LessEqual: return a <= b;
+            case Filter::Compare::Greater: return a > b;
+            case Filter::Compare::GreaterEqual: return a >= b;
+            case Filter::Compare::Equal: return a == b;
+            case Filter::Compare::NotEqual: return a != b;
+        }
+        return false;
+    }
+
+    // Integer column of a field, or nullptr for weight and subject
+    const std::vector<int>* integerColumn(const Planner::AssignmentColumns& columns, Filter::Field field) {
+        switch (field) {
+            case Filter::Field::Deadline: return &columns.deadline;
+            case Filter::Field::Duration: return &columns.duration;
+            case Filter::Field::RealDuration: return &columns.realDuration;
+            case Filter::Field::Size: return &columns.size;
+            case Filter::Field::GroupSize: return &columns.groupSize;
+            default: return nullptr;
+        }
+    }
+}
+
+Planner::AssignmentColumns Planner::makeAssignmentColumns(const AssignmentStore& assignments) {
+    PLANNER_TRACE_SCOPE("makeAssignmentColumns");
+    PLANNER_MEMORY_SCOPE(Schedule);
+    AssignmentColumns columns;
+    const std::size_t rows = assignments.size();
+    columns.deadline.reserve(rows);
+    columns.duration.reserve(rows);
+    columns.realDuration.reserve(rows);
+    columns.weight.reserve(rows);
+    columns.size.reserve(rows);
+    columns.groupSize.reserve(rows);
+    columns.groupWork.reserve(rows);
+    columns.subject.reserve(rows);
+
+    // Subjects are numbered as they appear, then renumbered in sorted order
+    std::unordered_map<std::string, std::uint32_t> seen;
+    std::vector<std::string> names;
+    const int elapsed = today() - assignments.epochDay();
+    for (AssignmentHandle handle : assignments.handles()) {
+        const Assignment& assignment = assignments[handle];
+        columns.deadline.push_back(assignment.getDeadline() - elapsed);
+        columns.duration.push_back(assignment.getDuration());
+        columns.realDuration.push_back(assignment.getRealDuration());
+        columns.weight.push_back(assignment.getWeight());
+        columns.size.push_back(assignment.getSize());
+        columns.groupSize.push_back(assignment.getGroupSize());
+        columns.groupWork.push_back(assignment.isGroupWork());
+
+        auto [at, added] = seen.emplace(assignment.getSubject(), static_cast<std::uint32_t>(names.size()));
+        if (added)
+            names.push_back(assignment.getSubject());
+        columns.subject.push_back(at->second);
+    }
+
+    std::vector<std::uint32_t> sorted(names.size());
+    for (std::uint32_t i = 0; i < sorted.size(); ++i)
+        sorted[i] = i;
+    std::sort(sorted.begin(), sorted.end(), [&](std::uint32_t a, std::uint32_t b) { return names[a] < names[b]; });
+    std::vector<std::uint32_t> renumber(names.size());
+    for (std::uint32_t i = 0; i < sorted.size(); ++i) {
+        renumber[sorted[i]] = i;
+        columns.subjects.push_back(std::move(names[sorted[i]]));
+    }
+
+    columns.subjectRows.resize(columns.subjects.size());
+    for (std::uint32_t row = 0; row < rows; ++row) {
+        columns.subject[row] = renumber[columns.subject[row]];
+        columns.subjectRows[columns.subject[row]].push_back(row);
+    }
+
+    columns.byDeadline.resize(rows);
+    for (std::uint32_t row = 0; row < rows; ++row)
+        columns.byDeadline[row] = row;
+    std::stable_sort(columns.byDeadline.begin(), columns.byDeadline.end(),
+                     [&](std::uint32_t a, std::uint32_t b) { return columns.deadline[a] < columns.deadline[b]; });
+    return columns;
+}
+
+// Recursive descent over the expression, emitting the program in postfix order
+class Planner::AssignmentFilter::Parser {
+public:
+    Parser(const std::string& text, AssignmentFilter& filter) : text(text), filter(filter) {}
+
+    void parse() {
+        advance();
+        parseOr();
+        if (token.kind != Kind::End)
+            fail("Unexpected '" + token.text + "'");
+        if (topLevelOr) {
+            // An alternative can match without the conditions of the first branch
+            filter.requiresSubject = false;
+            filter.deadlineLow = INT_MIN;
+            filter.deadlineHigh = INT_MAX;
+        }
+    }
+
+private:
+    enum class Kind { End, Word, Number, String, Symbol };
+
+    struct Token {
+        Kind kind = Kind::End;
+        std::string text;
+        std::size_t position = 0;
+    };
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::invalid_argument("Filter: " + message + " at position " + std::to_string(token.position + 1));
+    }
+
+    void advance() {
+        while (at < text.size() && std::isspace(static_cast<unsigned char>(text[at])))
+            ++at;
+        token = Token();
+        token.position = at;
+        if (at == text.size())
+            return;
+
+        const char c = text[at];
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            token.kind = Kind::Word;
+            while (at < text.size() && (std::isalnum(static_cast<unsigned char>(text[at])) || text[at] == '_'))
+                token.text += text[at++];
+        } else if (std::isdigit(static_cast<unsigned char>(c)) || c == '-' || c == '.') {
+            token.kind = Kind::Number;
+            token.text += text[at++];
+            while (at < text.size() && (std::isdigit(static_cast<unsigned char>(text[at])) || text[at] == '.'))
+                token.text += text[at++];
+        } else if (c == '"' || c == '\'') {
+            token.kind = Kind::String;
+            std::size_t end = text.find(c, at + 1);
+            if (end == std::string::npos)
+                fail("Unterminated string");
+            token.text = text.substr(at + 1, end - at - 1);
+            at = end + 1;
+        } else {
+            token.kind = Kind::Symbol;
+            static const char* const symbols[] = {"&&", "||", "<=", ">=", "==", "!=", "<", ">", "!", "(", ")"};
+            for (const char* symbol : symbols) {
+                if (text.compare(at, std::char_traits<char>::length(symbol), symbol) == 0) {
+                    token.text = symbol;
+                    at += token.text.size();
+                    return;
+                }
+            }
+            token.text = std::string(1, c);
+            fail("Unexpected '" + token.text + "'");
+        }
+    }
+
+    bool isSymbol(const char* symbol) const {
+        return token.kind == Kind::Symbol && token.text == symbol;
+    }
+
+    void emit(Instruction instruction) {
+        if (instruction.op == Instruction::Op::Test)
+            filter.depth = std::max(filter.depth, ++stack);
+        else if (instruction.op != Instruction::Op::Not)
+            --stack;
+        filter.program.push_back(std::move(instruction));
+    }
+
+    void emit(Instruction::Op op) {
+        Instruction instruction;
+        instruction.op = op;
+        emit(std::move(instruction));
+    }
+
+    void parseOr() {
+        parseAnd();
+        while (isSymbol("||")) {
+            topLevelOr = topLevelOr || nesting == 0;
+            advance();
+            parseAnd();
+            emit(Instruction::Op::Or);
+        }
+    }
+
+    void parseAnd() {
+        parseUnary();
+        while (isSymbol("&&")) {
+            advance();
+            parseUnary();
+            emit(Instruction::Op::And);
+        }
+    }
+
+    void parseUnary() {
+        if (isSymbol("!")) {
+            advance();
+            ++nesting;
+            parseUnary();
+            --nesting;
+            emit(Instruction::Op::Not);
+        } else if (isSymbol("(")) {
+            advance();
+            ++nesting;
+            parseOr();
+            --nesting;
+            if (!isSymbol(")"))
+                fail("Expected ')'");
+            advance();
+        } else {
+            parseTest();
+        }
+    }
+
+    void parseTest() {
+        static const std::pair<const char*, Field> fields[] = {
+            {"deadline", Field::Deadline}, {"duration", Field::Duration}, {"real_duration", Field::RealDuration},
+            {"weight", Field::Weight}, {"size", Field::Size}, {"group_size", Field::GroupSize},
+            {"group_work", Field::GroupWork}, {"subject", Field::Subject}};
+
+        if (token.kind != Kind::Word)
+            fail("Expected a field");
+        Instruction test;
+        auto field = std::find_if(std::begin(fields), std::end(fields),
+                                  [&](const auto& entry) { return token.text == entry.first; });
+        if (field == std::end(fields))
+            fail("Unknown field '" + token.text + "'");
+        test.field = field->second;
+        advance();
+
+        static const std::pair<const char*, Compare> compares[] = {
+            {"<", Compare::Less}, {"<=", Compare::LessEqual}, {">", Compare::Greater},
+            {">=", Compare::GreaterEqual}, {"==", Compare::Equal}, {"!=", Compare::NotEqual}};
+        auto compare = std::find_if(std::begin(compares), std::end(compares),
+                                    [&](const auto& entry) { return isSymbol(entry.first); });
+
+        if (compare == std::end(compares)) {
+            if (test.field != Field::GroupWork)
+                fail("Expected a comparison");
+            emit(test); // A bare group_work, true for group assignments
+            return;
+        }
+        test.compare = compare->second;
+        advance();
+
+        if (test.field == Field::Subject) {
+            if (test.compare != Compare::Equal && test.compare != Compare::NotEqual)
+                fail("Subjects can only be compared with == and !=");
+            if (token.kind != Kind::String && token.kind != Kind::Word)
+                fail("Expected a subject");
+            test.subject = token.text;
+        } else if (test.field == Field::GroupWork) {
+            if ((test.compare != Compare::Equal && test.compare != Compare::NotEqual) ||
+                (token.text != "true" && token.text != "false"))
+                fail("group_work can only be compared with == or != to true or false");
+            test.whole = token.text == "true";
+        } else {
+            if (token.kind != Kind::Number)
+                fail("Expected a number");
+            char* end = nullptr;
+            double value = std::strtod(token.text.c_str(), &end);
+            if (*end != '\0')
+                fail("Malformed number '" + token.text + "'");
+            if (test.field == Field::Weight) {
+                test.real = static_cast<float>(value);
+            } else {
+                if (value != std::floor(value) || value < INT_MIN || value > INT_MAX)
+                    fail("Expected a whole number");
+                test.whole = static_cast<int>(value);
+            }
+        }
+        advance();
+
+        if (nesting == 0)
+            require(test);
+        emit(std::move(test));
+    }
+
+    // Record a condition every match must meet, for the indexes
+    void require(const Instruction& test) {
+        if (test.field == Field::Subject && test.compare == Compare::Equal && !filter.requiresSubject) {
+            filter.requiresSubject = true;
+            filter.requiredSubject = test.subject;
+        } else if (test.field == Field::Deadline) {
+            int& low = filter.deadlineLow;
+            int& high = filter.deadlineHigh;
+            switch (test.compare) {
+                case Compare::Less: high = std::min(high, test.whole == INT_MIN ? INT_MIN : test.whole - 1); break;
+                case Compare::LessEqual: high = std::min(high, test.whole); break;
+                case Compare::Greater: low = std::max(low, test.whole == INT_MAX ? INT_MAX : test.whole + 1); break;
+                case Compare::GreaterEqual: low = std::max(low, test.whole); break;
+                case Compare::Equal: low = std::max(low, test.whole); high = std::min(high, test.whole); break;
+                case Compare::NotEqual: break;
+            }
+        }
+    }
+
+    const std::string& text;
+    AssignmentFilter& filter;
+    std::size_t at = 0;
+    Token token;
+    int nesting = 0; // Inside parentheses or a negation
+    bool topLevelOr = false;
+    std::size_t stack = 0;
+};
+
+Planner::AssignmentFilter::AssignmentFilter(const std::string& expression) : text(expression) {
+    Parser(text, *this).parse();
+    if (program.empty())
+        throw std::invalid_argument("Filter: Empty expression");
+}
+
+bool Planner::AssignmentFilter::matches(const AssignmentColumns& columns, std::uint32_t row,
+                                        const std::vector<std::uint32_t>& subjectIds, std::uint8_t* stack) const {
+    std::size_t top = 0;
+    for (std::size_t i = 0; i < program.size(); ++i) {
+        const Instruction& step = program[i];
+        switch (step.op) {
+            case Instruction::Op::Test:
+                if (step.field == Field::Weight)
+                    stack[top++] = compareValue(columns.weight[row], step.real, step.compare);
+                else if (step.field == Field::GroupWork)
+                    stack[top++] = compareValue<int>(columns.groupWork[row], step.whole, step.compare);
+                else if (step.field == Field::Subject)
+                    stack[top++] = compareValue(columns.subject[row], subjectIds[i], step.compare);
+                else
+                    stack[top++] = compareValue((*integerColumn(columns, step.field))[row], step.whole, step.compare);
+                break;
+            case Instruction::Op::And:
+                --top;
+                stack[top - 1] &= stack[top];
+                break;
+            case Instruction::Op::Or:
+                --top;
+                stack[top - 1] |= stack[top];
+                break;
+            case Instruction::Op::Not:
+                stack[top - 1] ^= 1;
+                break;
+        }
+    }
+    return stack[0];
+}
+
+void Planner::AssignmentFilter::scan(const AssignmentColumns& columns, const std::vector<std::uint32_t>& subjectIds,
+                                     std::vector<std::uint32_t>& rows) const {
+    // One block of results per stack entry
+    std::vector<std::uint8_t> stack(depth * BlockSize);
+    const std::size_t total = columns.rows();
+
+    for (std::size_t first = 0; first < total; first += BlockSize) {
+        const std::size_t count = std::min(BlockSize, total - first);
+        std::size_t top = 0;
+
+        for (std::size_t i = 0; i < program.size(); ++i) {
+            const Instruction& step = program[i];
+            switch (step.op) {
+                case Instruction::Op::Test: {
+                    std::uint8_t* out = stack.data() + top * BlockSize;
+                    if (step.field == Field::Weight)
+                        compareBlock(columns.weight.data() + first, count, step.real, step.compare, out);
+                    else if (step.field == Field::GroupWork)
+                        compareBlock<std::uint8_t>(columns.groupWork.data() + first, count,
+                                                   static_cast<std::uint8_t>(step.whole), step.compare, out);
+                    else if (step.field == Field::Subject)
+                        compareBlock(columns.subject.data() + first, count, subjectIds[i], step.compare, out);
+                    else
+                        compareBlock(integerColumn(columns, step.field)->data() + first, count, step.whole, step.compare, out);
+                    ++top;
+                    break;
+                }
+                case Instruction::Op::And:
+                case Instruction::Op::Or: {
+                    --top;
+                    std::uint8_t* left = stack.data() + (top - 1) * BlockSize;
+                    const std::uint8_t* right = stack.data() + top * BlockSize;
+                    if (step.op == Instruction::Op::And) {
+                        for (std::size_t r = 0; r < count; ++r)
+                            left[r] &= right[r];
+                    } else {
+                        for (std::size_t r = 0; r < count; ++r)
+                            left[r] |= right[r];
+                    }
+                    break;
+                }
+                case Instruction::Op::Not: {
+                    std::uint8_t* last = stack.data() + (top - 1) * BlockSize;
+                    for (std::size_t r = 0; r < count; ++r)
+                        last[r] ^= 1;
+                    break;
+                }
+            }
+        }
+
+        // Append matching rows without a branch per row
+        const std::uint8_t* match = stack.data();
+        std::size_t size = rows.size();
+        rows.resize(size + count);
+        for (std::size_t r = 0; r < count; ++r) {
+            rows[size] = static_cast<std::uint32_t>(first + r);
+            size += match[r];
+        }
+        rows.resize(size);
+    }
+}
+
+std::vector<std::uint32_t> Planner::AssignmentFilter::select(const AssignmentColumns& columns) const {
+    PLANNER_TRACE_SCOPE("filter");
+    PLANNER_MEMORY_SCOPE(Display);
+    std::vector<std::uint32_t> rows;
+    if (columns.rows() == 0)
+        return rows;
+
+    // Subjects become their numbers in these columns; unknown ones match nothing
+    std::vector<std::uint32_t> subjectIds(program.size(), 0);
+    for (std::size_t i = 0; i < program.size(); ++i) {
+        if (program[i].op != Instruction::Op::Test || program[i].field != Field::Subject)
+            continue;
+        auto at = std::lower_bound(columns.subjects.begin(), columns.subjects.end(), program[i].subject);
+        subjectIds[i] = at != columns.subjects.end() && *at == program[i].subject
+                            ? static_cast<std::uint32_t>(at - columns.subjects.begin())
+                            : static_cast<std::uint32_t>(columns.subjects.size());
+    }
+
+    // Rows an index narrows the search to, if it narrows it enough
+    const std::vector<std::uint32_t>* subjectCandidates = nullptr;
+    if (requiresSubject) {
+        auto at = std::lower_bound(columns.subjects.begin(), columns.subjects.end(), requiredSubject);
+        if (at == columns.subjects.end() || *at != requiredSubject)
+            return rows;
+        subjectCandidates = &columns.subjectRows[static_cast<std::size_t>(at - columns.subjects.begin())];
+    }
+
+    std::size_t deadlineCount = columns.rows();
+    auto deadlineFirst = columns.byDeadline.begin();
+    if (deadlineLow != INT_MIN || deadlineHigh != INT_MAX) {
+        if (deadlineLow > deadlineHigh)
+            return rows;
+        auto byValue = [&](std::uint32_t row, int value) { return columns.deadline[row] < value; };
+        auto byRow = [&](int value, std::uint32_t row) { return value < columns.deadline[row]; };
+        deadlineFirst = std::lower_bound(columns.byDeadline.begin(), columns.byDeadline.end(), deadlineLow, byValue);
+        auto deadlineLast = std::upper_bound(deadlineFirst, columns.byDeadline.end(), deadlineHigh, byRow);
+        deadlineCount = static_cast<std::size_t>(deadlineLast - deadlineFirst);
+    }
+
+    const std::size_t subjectCount = subjectCandidates ? subjectCandidates->size() : columns.rows();
+    const std::size_t narrowest = std::min(subjectCount, deadlineCount);
+    if (narrowest * IndexRatio > columns.rows()) {
+        scan(columns, subjectIds, rows);
+        return rows;
+    }
+
+    std::vector<std::uint32_t> candidates;
+    if (subjectCandidates && subjectCount <= deadlineCount) {
+        candidates = *subjectCandidates;
+    } else {
+        candidates.assign(deadlineFirst, deadlineFirst + static_cast<std::ptrdiff_t>(deadlineCount));
+        std::sort(candidates.begin(), candidates.end());
+    }
+
+    std::vector<std::uint8_t> stack(depth);
+    for (std::uint32_t row : candidates) {
+        if (matches(columns, row, subjectIds, stack.data()))
+            rows.push_back(row);
+    }
+    return rows;
+}
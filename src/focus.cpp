@@ -0,0 +1,103 @@
+#include "../include/focus.hpp"
+#include "../include/groupslots.hpp"
+#include "../include/trace.hpp"
+#include "../include/memtrack.hpp"
+#include <algorithm>
+
+namespace {
+    struct Candidate {
+        int score;
+        int dueDay;
+        int remainingHours;
+        float weight;
+        int size;
+        std::uint32_t index;
+    };
+
+    // calculatePriority with each ladder written as a sum of comparisons,
+    // so scoring thousands of assignments does not stall on branches
+    int ladderScore(int deadline, int realDuration, float weight, int size, int studyHoursPerDay) {
+        const int slack = deadline * studyHoursPerDay - realDuration;
+        return 4 * (deadline < 8) + 2 * (deadline < 6) + 2 * (deadline < 4) + 2 * (deadline < 2)
+             + 10 * (slack < 6) + 5 * (slack < 4) + 5 * (slack < 2)
+             + 2 * (weight > 10) + 2 * (weight > 15) + 2 * (weight > 20)
+             + (static_cast<unsigned>(size - 1) < 3u) * (4 - size);
+    }
+
+    // Highest score first, then earliest deadline, then insertion order
+    bool ranksBefore(const Candidate& a, const Candidate& b) {
+        if (a.score != b.score)
+            return a.score > b.score;
+        if (a.dueDay != b.dueDay)
+            return a.dueDay < b.dueDay;
+        return a.index < b.index;
+    }
+}
+
+// Scores only fall as an assignment is worked on, so an assignment can
+// only beat one ranked above it once that one has had an hour. With k
+// hours in the day, the hours therefore all go to the top k by first score.
+std::vector<Planner::FocusTask> Planner::todaysFocus(const AssignmentStore& assignments, const ScheduleOptions& options) {
+    PLANNER_TRACE_SCOPE("todaysFocus");
+    PLANNER_MEMORY_SCOPE(Schedule);
+    std::vector<FocusTask> tasks;
+
+    int studyHours = studyHoursForDay(1, options);
+    if (options.availability) {
+        std::vector<int> freeHours;
+        studyHours = options.availability->freeStudyHours(options.startDay + 1, studyHours, freeHours);
+    }
+    if (studyHours <= 0 || assignments.empty())
+        return tasks;
+
+    // The best studyHours assignments seen so far, as a heap whose front
+    // ranks last, so most assignments are turned away by one comparison
+    const std::size_t kept = std::min(assignments.size(), static_cast<std::size_t>(studyHours));
+    std::vector<Candidate> candidates;
+    candidates.reserve(kept);
+    const int elapsed = today() - assignments.epochDay();
+    const auto& handles = assignments.handles();
+
+    {
+        PLANNER_TRACE_SCOPE("score");
+        for (std::uint32_t i = 0; i < handles.size(); ++i) {
+            const Assignment& assignment = assignments[handles[i]];
+            const int dueDay = assignment.getDeadline() - elapsed;
+            const int reserved = options.availability ? reservedGroupHours(assignment, *options.availability) : 0;
+            if (reserved > 0 && assignment.getRealDuration() <= reserved)
+                continue; // Done in the group's reserved sessions
+            const int remaining = assignment.getRealDuration() - reserved;
+            const Candidate candidate{ladderScore(dueDay, remaining, assignment.getWeight(), assignment.getSize(), studyHours),
+                                      dueDay, remaining, assignment.getWeight(), assignment.getSize(), i};
+
+            if (candidates.size() < kept) {
+                candidates.push_back(candidate);
+                std::push_heap(candidates.begin(), candidates.end(), ranksBefore);
+            } else if (ranksBefore(candidate, candidates.front())) {
+                std::pop_heap(candidates.begin(), candidates.end(), ranksBefore);
+                candidates.back() = candidate;
+                std::push_heap(candidates.begin(), candidates.end(), ranksBefore);
+            }
+        }
+    }
+
+    // At most a day's worth of hours among at most that many candidates
+    for (int hour = 0; hour < studyHours && !candidates.empty(); ++hour) {
+        auto best = std::min_element(candidates.begin(), candidates.end(), ranksBefore);
+
+        auto task = std::find_if(tasks.begin(), tasks.end(),
+                                 [&](const FocusTask& t) { return t.assignment == best->index; });
+        if (task == tasks.end())
+            tasks.push_back({best->index, 1, best->score});
+        else
+            ++task->hours;
+
+        // Like the scheduler, an assignment gets at least its first hour
+        if (--best->remainingHours > 0)
+            best->score = calculatePriority(best->dueDay, best->remainingHours, best->weight, best->size, studyHours);
+        else
+            candidates.erase(best);
+    }
+
+    return tasks;
+}
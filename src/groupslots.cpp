@@ -0,0 +1,195 @@
+#include "../include/groupslots.hpp"
+#include "../include/trace.hpp"
+#include "../include/memtrack.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace {
+    constexpr int BitsPerWord = 64;
+
+    // Bits of a word from position lo up to, not including, hi
+    std::uint64_t bitRange(int lo, int hi) {
+        std::uint64_t upper = hi >= BitsPerWord ? ~std::uint64_t(0) : (std::uint64_t(1) << hi) - 1;
+        return upper & ~((std::uint64_t(1) << lo) - 1);
+    }
+}
+
+Planner::HourMask::HourMask(int firstDay, int weeks)
+    : first(firstDay), weekCount(std::max(weeks, 0)), words(static_cast<std::size_t>(weekCount) * WordsPerWeek, 0) {}
+
+Planner::HourMask Planner::HourMask::fromAvailability(const Availability& availability, int firstDay, int weeks) {
+    PLANNER_TRACE_SCOPE("hourMask");
+    HourMask mask(firstDay, weeks);
+    for (int day = 0; day < mask.weekCount * 7; ++day) {
+        long long midnight = static_cast<long long>(firstDay + day) * MinutesPerDay;
+        for (int hour = availability.studyWindowStart(); hour < availability.studyWindowEnd(); ++hour) {
+            int bit = day * 24 + hour;
+            if (bit >= mask.hours())
+                break;
+            long long start = midnight + hour * 60LL;
+            if (availability.isFree(start, start + 60))
+                mask.setFree(bit, true);
+        }
+    }
+    return mask;
+}
+
+bool Planner::HourMask::isFree(int hour) const {
+    if (hour < 0 || hour >= hours())
+        return false;
+    int inWeek = hour % HoursPerWeek;
+    return (words[(hour / HoursPerWeek) * WordsPerWeek + inWeek / BitsPerWord] >> (inWeek % BitsPerWord)) & 1;
+}
+
+void Planner::HourMask::setFree(int hour, bool free) {
+    if (hour < 0 || hour >= hours())
+        return;
+    int inWeek = hour % HoursPerWeek;
+    std::uint64_t& word = words[(hour / HoursPerWeek) * WordsPerWeek + inWeek / BitsPerWord];
+    std::uint64_t bit = std::uint64_t(1) << (inWeek % BitsPerWord);
+    word = free ? word | bit : word & ~bit;
+}
+
+Planner::HourMask& Planner::HourMask::operator&=(const HourMask& other) {
+    // Flat loop over the words so the compiler can vectorise it
+    const std::size_t shared = std::min(words.size(), other.words.size());
+    const std::uint64_t* from = other.words.data();
+    std::uint64_t* to = words.data();
+    for (std::size_t i = 0; i < shared; ++i)
+        to[i] &= from[i];
+    std::fill(words.begin() + static_cast<std::ptrdiff_t>(shared), words.end(), 0);
+    return *this;
+}
+
+int Planner::HourMask::count(int fromHour, int toHour) const {
+    fromHour = std::max(fromHour, 0);
+    toHour = std::min(toHour, hours());
+    int total = 0;
+
+    for (int week = fromHour / HoursPerWeek; week * HoursPerWeek < toHour; ++week) {
+        for (int w = 0; w < WordsPerWeek; ++w) {
+            int base = week * HoursPerWeek + w * BitsPerWord;
+            int lo = std::max(fromHour - base, 0);
+            int hi = std::min(toHour - base, BitsPerWord);
+            if (lo < hi)
+                total += __builtin_popcountll(words[week * WordsPerWeek + w] & bitRange(lo, hi));
+        }
+    }
+    return total;
+}
+
+int Planner::HourMask::nextFree(int fromHour) const {
+    fromHour = std::max(fromHour, 0);
+    for (int week = fromHour / HoursPerWeek; week < weekCount; ++week) {
+        for (int w = 0; w < WordsPerWeek; ++w) {
+            int base = week * HoursPerWeek + w * BitsPerWord;
+            int lo = std::max(fromHour - base, 0);
+            if (lo >= BitsPerWord)
+                continue;
+            std::uint64_t bits = words[week * WordsPerWeek + w] & bitRange(lo, BitsPerWord);
+            if (bits)
+                return base + __builtin_ctzll(bits);
+        }
+    }
+    return -1;
+}
+
+Planner::HourMask Planner::commonFreeHours(const std::vector<HourMask>& members) {
+    if (members.empty())
+        return HourMask(0, 0);
+    HourMask common = members.front();
+    for (std::size_t i = 1; i < members.size(); ++i)
+        common &= members[i];
+    return common;
+}
+
+Planner::GroupPlan Planner::planGroupSessions(const AssignmentStore& assignments,
+                                              const std::vector<const Availability*>& members, int firstDay, int weeks,
+                                              int maxHoursPerDay) {
+    PLANNER_TRACE_SCOPE("planGroupSessions");
+    PLANNER_MEMORY_SCOPE(Schedule);
+    std::vector<HourMask> masks;
+    masks.reserve(members.size());
+    for (const Availability* member : members)
+        masks.push_back(HourMask::fromAvailability(*member, firstDay, weeks));
+    HourMask common = members.empty() ? HourMask(firstDay, weeks) : commonFreeHours(masks);
+
+    // Study day i runs from dayStart + 24 * (i - 1) up to dayStart + 24 * i,
+    // so a session past midnight counts toward the evening it started on
+    int dayStart = DefaultStudyStartHour;
+    if (!members.empty()) {
+        dayStart = 0;
+        for (const Availability* member : members)
+            dayStart = std::max(dayStart, ((member->studyWindowStart() % 24) + 24) % 24);
+    }
+    std::vector<int> dayHours(static_cast<std::size_t>(common.hours() / 24 + 2), 0);
+
+    // Group assignments by the last day they can be worked on
+    const auto& handles = assignments.handles();
+    std::vector<std::pair<int, std::uint32_t>> order;
+    for (std::uint32_t i = 0; i < handles.size(); ++i) {
+        const Assignment& assignment = assignments[handles[i]];
+        if (assignment.isGroupWork() && assignment.getRealDuration() > 0)
+            order.emplace_back(assignments.epochDay() + assignment.getDeadline(), i);
+    }
+    std::sort(order.begin(), order.end());
+
+    GroupPlan plan;
+    for (const auto& [lastDay, index] : order) {
+        int needed = assignments[handles[index]].getRealDuration();
+        const int limit = std::min(common.hours(), (lastDay - firstDay + 1) * 24);
+
+        for (int hour = common.nextFree(0); needed > 0 && hour >= 0 && hour < limit; hour = common.nextFree(hour + 1)) {
+            const int studyDay = (hour - dayStart + 24) / 24;
+            if (dayHours[static_cast<std::size_t>(studyDay)] >= maxHoursPerDay) {
+                hour = studyDay * 24 + dayStart - 1; // On to the next study day
+                continue;
+            }
+            ++dayHours[static_cast<std::size_t>(studyDay)];
+            common.setFree(hour, false); // Taken for every member
+            --needed;
+
+            if (!plan.sessions.empty()) {
+                GroupSession& last = plan.sessions.back();
+                if (last.assignment == index && (last.day - firstDay) * 24 + last.startHour + last.hours == hour) {
+                    ++last.hours;
+                    continue;
+                }
+            }
+            plan.sessions.push_back({index, firstDay + hour / 24, hour % 24, 1});
+        }
+
+        if (needed > 0)
+            plan.shortfalls.push_back({index, needed});
+    }
+    return plan;
+}
+
+std::string Planner::groupSessionTag(const Assignment& assignment) {
+    return "group:" + assignment.getSubject() + "/" + assignment.getName();
+}
+
+int Planner::reservedGroupHours(const Assignment& assignment, const Availability& availability) {
+    if (!assignment.isGroupWork())
+        return 0;
+    return static_cast<int>(availability.reservedMinutes(groupSessionTag(assignment)) / 60);
+}
+
+void Planner::releaseGroupSessions(Availability& availability, const AssignmentStore& assignments) {
+    for (AssignmentHandle handle : assignments.handles()) {
+        if (assignments[handle].isGroupWork())
+            availability.release(groupSessionTag(assignments[handle]));
+    }
+}
+
+void Planner::reserveGroupSessions(Availability& availability, const AssignmentStore& assignments,
+                                   const std::vector<GroupSession>& sessions) {
+    const auto& handles = assignments.handles();
+    for (const GroupSession& session : sessions)
+        availability.release(groupSessionTag(assignments[handles[session.assignment]]));
+
+    for (const GroupSession& session : sessions) {
+        long long start = minuteAt(session.day, session.startHour);
+        availability.reserve(groupSessionTag(assignments[handles[session.assignment]]), start, start + session.hours * 60LL);
+    }
+}
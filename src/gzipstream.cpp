@@ -0,0 +1,232 @@
+#include "../include/gzipstream.hpp"
+#include <zlib.h>
+#include <sstream>
+
+namespace {
+    constexpr std::size_t ChunkSize = 64 * 1024;
+
+    // windowBits of 15 plus 16 selects the gzip wrapper instead of zlib's own
+    constexpr int GzipWindowBits = 15 + 16;
+}
+
+struct Planner::GzipInputBuffer::State {
+    std::streambuf* source;
+    z_stream stream;
+    bool failed;
+    bool inMember; // Input of a gzip member has been read, but not its end
+    Bytef compressed[ChunkSize];
+    char plain[ChunkSize];
+};
+
+Planner::GzipInputBuffer::GzipInputBuffer(std::streambuf* source) : state(std::make_unique<State>()) {
+    state->source = source;
+    z_stream& stream = state->stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    stream.next_in = Z_NULL;
+    stream.avail_in = 0;
+    state->failed = inflateInit2(&stream, GzipWindowBits) != Z_OK;
+    state->inMember = false;
+}
+
+Planner::GzipInputBuffer::~GzipInputBuffer() {
+    inflateEnd(&state->stream);
+}
+
+bool Planner::GzipInputBuffer::failed() const {
+    return state->failed;
+}
+
+Planner::GzipInputBuffer::int_type Planner::GzipInputBuffer::underflow() {
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+    if (state->failed)
+        return traits_type::eof();
+
+    z_stream& stream = state->stream;
+    for (;;) {
+        if (stream.avail_in == 0) {
+            std::streamsize read = state->source->sgetn(reinterpret_cast<char*>(state->compressed), ChunkSize);
+            if (read <= 0) {
+                // Cut off inside a member: its data and trailer never came
+                state->failed = state->inMember;
+                return traits_type::eof();
+            }
+            stream.next_in = state->compressed;
+            stream.avail_in = static_cast<uInt>(read);
+            state->inMember = true;
+        }
+
+        stream.next_out = reinterpret_cast<Bytef*>(state->plain);
+        stream.avail_out = ChunkSize;
+        int result = inflate(&stream, Z_NO_FLUSH);
+        if (result == Z_STREAM_END) {
+            inflateReset(&stream);
+            state->inMember = stream.avail_in > 0;
+        } else if (result != Z_OK && result != Z_BUF_ERROR) {
+            // Corrupt data ends the stream where it went bad
+            state->failed = true;
+        }
+
+        std::size_t produced = ChunkSize - stream.avail_out;
+        if (produced > 0) {
+            setg(state->plain, state->plain, state->plain + produced);
+            return traits_type::to_int_type(*gptr());
+        }
+        if (state->failed)
+            return traits_type::eof();
+    }
+}
+
+struct Planner::GzipOutputBuffer::State {
+    std::streambuf* sink;
+    z_stream stream;
+    bool failed;
+    bool finished;
+    char plain[ChunkSize];
+    Bytef compressed[ChunkSize];
+};
+
+Planner::GzipOutputBuffer::GzipOutputBuffer(std::streambuf* sink) : state(std::make_unique<State>()) {
+    state->sink = sink;
+    z_stream& stream = state->stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    state->failed = deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, GzipWindowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK;
+    state->finished = state->failed;
+    setp(state->plain, state->plain + ChunkSize);
+}
+
+Planner::GzipOutputBuffer::~GzipOutputBuffer() {
+    finish();
+}
+
+bool Planner::GzipOutputBuffer::finish() {
+    if (!state->finished) {
+        deflateChunk(Z_FINISH);
+        deflateEnd(&state->stream);
+        state->finished = true;
+        if (state->sink->pubsync() != 0)
+            state->failed = true;
+    }
+    return !state->failed;
+}
+
+Planner::GzipOutputBuffer::int_type Planner::GzipOutputBuffer::overflow(int_type c) {
+    if (state->finished || !deflateChunk(Z_NO_FLUSH))
+        return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+int Planner::GzipOutputBuffer::sync() {
+    if (state->finished)
+        return state->failed ? -1 : 0;
+    return deflateChunk(Z_NO_FLUSH) && state->sink->pubsync() == 0 ? 0 : -1;
+}
+
+bool Planner::GzipOutputBuffer::deflateChunk(int flush) {
+    z_stream& stream = state->stream;
+    stream.next_in = reinterpret_cast<Bytef*>(pbase());
+    stream.avail_in = static_cast<uInt>(pptr() - pbase());
+
+    int result;
+    do {
+        stream.next_out = state->compressed;
+        stream.avail_out = ChunkSize;
+        result = deflate(&stream, flush);
+        if (result == Z_STREAM_ERROR) {
+            state->failed = true;
+            break;
+        }
+
+        std::streamsize produced = static_cast<std::streamsize>(ChunkSize - stream.avail_out);
+        if (state->sink->sputn(reinterpret_cast<char*>(state->compressed), produced) != produced) {
+            state->failed = true;
+            break;
+        }
+    } while (flush == Z_FINISH ? result != Z_STREAM_END : stream.avail_out == 0);
+
+    setp(state->plain, state->plain + ChunkSize);
+    return !state->failed;
+}
+
+bool Planner::isGzipPath(const std::string& filename) {
+    return filename.size() >= 3 && filename.compare(filename.size() - 3, 3, ".gz") == 0;
+}
+
+bool Planner::isGzipData(const std::string& data) {
+    return data.size() >= 2 && static_cast<unsigned char>(data[0]) == 0x1f && static_cast<unsigned char>(data[1]) == 0x8b;
+}
+
+std::string Planner::gzipCompress(const std::string& data) {
+    std::stringbuf sink;
+    GzipOutputBuffer gzip(&sink);
+    gzip.sputn(data.data(), static_cast<std::streamsize>(data.size()));
+    gzip.finish();
+    return sink.str();
+}
+
+std::string Planner::gzipDecompress(const std::string& data) {
+    std::stringbuf source(data);
+    GzipInputBuffer gzip(&source);
+    std::string plain;
+    char chunk[ChunkSize];
+    for (std::streamsize read; (read = gzip.sgetn(chunk, sizeof(chunk))) > 0;)
+        plain.append(chunk, static_cast<std::size_t>(read));
+    return plain;
+}
+
+Planner::InputFile::InputFile(const std::string& filename) : file(filename, std::ios::binary), input(nullptr) {
+    if (!file.is_open())
+        return;
+
+    // Sniff the gzip magic, then rewind so either reader starts at byte 0
+    char magic[2] = {};
+    std::streamsize read = file.rdbuf()->sgetn(magic, 2);
+    file.rdbuf()->pubseekpos(0, std::ios::in);
+
+    if (read == 2 && isGzipData(std::string(magic, 2))) {
+        gzip = std::make_unique<GzipInputBuffer>(file.rdbuf());
+        input.rdbuf(gzip.get());
+    } else {
+        input.rdbuf(file.rdbuf());
+    }
+}
+
+Planner::InputFile::~InputFile() = default;
+
+Planner::OutputFile::OutputFile(const std::string& filename)
+    : file(filename, std::ios::binary | std::ios::trunc), output(nullptr) {
+    if (!file.is_open())
+        return;
+
+    if (isGzipPath(filename)) {
+        gzip = std::make_unique<GzipOutputBuffer>(file.rdbuf());
+        output.rdbuf(gzip.get());
+    } else {
+        output.rdbuf(file.rdbuf());
+    }
+}
+
+Planner::OutputFile::~OutputFile() {
+    if (file.is_open())
+        close();
+}
+
+bool Planner::OutputFile::close() {
+    if (!file.is_open())
+        return false;
+
+    output.flush();
+    bool ok = !output.fail();
+    if (gzip)
+        ok = gzip->finish() && ok;
+    file.close();
+    return !file.fail() && ok;
+}
@@ -0,0 +1,314 @@
+#include "../include/icsexport.hpp"
+#include "../include/icstext.hpp"
+#include "../include/calendar.hpp"
+#include "../include/trace.hpp"
+#include "../include/memtrack.hpp"
+#include "../include/gzipstream.hpp"
+#include <cstdint>
+#include <iostream>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <unordered_map>
+
+namespace {
+    // 64-bit FNV-1a, stable across platforms and runs
+    std::uint64_t fnv1a(const std::string& text, std::uint64_t hash = 14695981039346656037ULL) {
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // Local floating time of a clock hour, which may pass 24, on a day number
+    std::string formatLocal(int dayNumber, int hour) {
+        int year, month, day;
+        Planner::civilFromDayNumber(dayNumber + hour / 24, year, month, day);
+
+        char buffer[20];
+        std::snprintf(buffer, sizeof(buffer), "%04d%02d%02dT%02d0000", year, month, day, hour % 24);
+        return buffer;
+    }
+
+    using Planner::writeContentLine;
+
+    // Names are user text, so TEXT values are escaped and long lines folded
+    void writeEvent(std::ostream& output, const Planner::CalendarEvent& event, bool cancelled) {
+        writeContentLine(output, "BEGIN", "VEVENT");
+        writeContentLine(output, "UID", Planner::escapeText(event.uid));
+        writeContentLine(output, "DTSTAMP", event.stamp);
+        writeContentLine(output, "SEQUENCE", std::to_string(event.sequence));
+        writeContentLine(output, "SUMMARY", Planner::escapeText(event.summary));
+        writeContentLine(output, "DTSTART", event.start);
+        writeContentLine(output, "DTEND", event.end);
+        if (!event.rule.empty())
+            writeContentLine(output, "RRULE", event.rule);
+        writeContentLine(output, "DESCRIPTION", "Scheduled Assignment");
+        writeContentLine(output, "STATUS", cancelled ? "CANCELLED" : "CONFIRMED");
+        writeContentLine(output, "END", "VEVENT");
+    }
+
+    void writeHeader(std::ostream& output, const char* method, int revision) {
+        writeContentLine(output, "BEGIN", "VCALENDAR");
+        writeContentLine(output, "VERSION", "2.0");
+        writeContentLine(output, "PRODID", "-//Planner App//EN");
+        if (method)
+            writeContentLine(output, "METHOD", method);
+        writeContentLine(output, "X-PLANNER-REVISION", std::to_string(revision));
+    }
+
+    // Consecutive study hours of one assignment, repeated on `days` consecutive days
+    struct StudyBlock {
+        std::uint32_t assignment;
+        int day;
+        int startHour;
+        int hours;
+        int days;
+    };
+
+    bool sameSlot(const Planner::CalendarEvent& a, const Planner::CalendarEvent& b) {
+        return a.start == b.start && a.end == b.end && a.rule == b.rule && a.summary == b.summary;
+    }
+}
+
+std::string Planner::studyEventUid(const std::string& subject, const std::string& name, int occurrence, int dayNumber, int index) {
+    std::uint64_t hash = fnv1a(subject);
+    hash = fnv1a(std::string(1, '\x1f') + name, hash);
+    hash = fnv1a(std::string(1, '\x1f') + std::to_string(occurrence), hash);
+
+    int year, month, day;
+    civilFromDayNumber(dayNumber, year, month, day);
+
+    char buffer[80];
+    std::snprintf(buffer, sizeof(buffer), "%016llx-%04d%02d%02d-%d@study-planner", static_cast<unsigned long long>(hash),
+                  year, month, day, index);
+    return buffer;
+}
+
+std::vector<Planner::CalendarEvent> Planner::planEvents(const AssignmentStore& assignments, const SchedulePlan& plan, int startDay,
+                                                       const CalendarOptions& options) {
+    PLANNER_TRACE_SCOPE("planEvents");
+    PLANNER_MEMORY_SCOPE(Ics);
+    const auto& handles = assignments.handles();
+
+    // Assignments sharing a subject and name are numbered in store order
+    std::vector<int> occurrence(handles.size());
+    std::unordered_map<std::string, int> seen;
+    for (std::size_t i = 0; i < handles.size(); ++i) {
+        const Assignment& assignment = assignments[handles[i]];
+        occurrence[i] = seen[assignment.getSubject() + '\x1f' + assignment.getName()]++;
+    }
+
+    // Slots of a day come in hour order, so a block grows while the same
+    // assignment keeps the next clock hour
+    std::vector<StudyBlock> blocks;
+    blocks.reserve(plan.slots.size());
+    for (const ScheduledSlot& slot : plan.slots) {
+        if (options.coalesce && !blocks.empty()) {
+            StudyBlock& last = blocks.back();
+            if (last.assignment == slot.assignment && last.day == slot.day && last.startHour + last.hours == slot.startHour) {
+                ++last.hours;
+                continue;
+            }
+        }
+        blocks.push_back({slot.assignment, slot.day, slot.startHour, 1, 1});
+    }
+
+    // The same block on consecutive days becomes one daily series, as long
+    // as the assignment has nothing else in between
+    if (options.dailyRules) {
+        std::vector<std::size_t> tail(handles.size(), SIZE_MAX);
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            const StudyBlock& block = blocks[i];
+            std::size_t t = tail[block.assignment];
+            if (t != SIZE_MAX) {
+                StudyBlock& series = blocks[t];
+                if (series.day + series.days == block.day && series.startHour == block.startHour && series.hours == block.hours) {
+                    ++series.days;
+                    continue;
+                }
+            }
+            blocks[kept] = block;
+            tail[block.assignment] = kept++;
+        }
+        blocks.resize(kept);
+    }
+
+    // Blocks come in day order, so counting restarts when an assignment
+    // reaches a new day
+    std::vector<int> lastDay(handles.size(), -1);
+    std::vector<int> eventsOnDay(handles.size(), 0);
+    std::vector<CalendarEvent> events;
+    events.reserve(blocks.size());
+
+    for (const StudyBlock& block : blocks) {
+        const Assignment& assignment = assignments[handles[block.assignment]];
+        if (lastDay[block.assignment] != block.day) {
+            lastDay[block.assignment] = block.day;
+            eventsOnDay[block.assignment] = 0;
+        }
+        CalendarEvent event;
+        event.uid = studyEventUid(assignment.getSubject(), assignment.getName(), occurrence[block.assignment],
+                                  startDay + block.day, eventsOnDay[block.assignment]++);
+        event.summary = assignment.getName();
+        event.start = formatLocal(startDay + block.day, block.startHour);
+        event.end = formatLocal(startDay + block.day, block.startHour + block.hours);
+        if (block.days > 1)
+            event.rule = "FREQ=DAILY;COUNT=" + std::to_string(block.days);
+        events.push_back(std::move(event));
+    }
+
+    return events;
+}
+
+Planner::CalendarFeed Planner::readCalendarFeed(const std::string& filename) {
+    InputFile file(filename);
+    if (!file.isOpen())
+        return CalendarFeed();
+    CalendarFeed feed = readCalendarFeed(file.stream());
+    if (file.failed())
+        std::cerr << "Error: " << filename << " is truncated or corrupt.\n";
+    return feed;
+}
+
+Planner::CalendarFeed Planner::readCalendarFeed(std::istream& input) {
+    PLANNER_TRACE_SCOPE("readCalendarFeed");
+    PLANNER_MEMORY_SCOPE(Ics);
+    CalendarFeed feed;
+    UnfoldingReader reader(input);
+    std::string line;
+    CalendarEvent event;
+    bool inEvent = false;
+    bool cancelled = false;
+
+    while (reader.read(line)) {
+        std::size_t colon = line.find(':');
+        if (colon == std::string::npos)
+            continue;
+        std::string key = line.substr(0, colon);
+        std::string value = line.substr(colon + 1);
+
+        if (key == "BEGIN" && value == "VEVENT") {
+            event = CalendarEvent();
+            inEvent = true;
+            cancelled = false;
+        } else if (key == "END" && value == "VEVENT") {
+            if (inEvent && !cancelled && !event.uid.empty())
+                feed.events.push_back(std::move(event));
+            inEvent = false;
+        } else if (!inEvent) {
+            if (key == "X-PLANNER-REVISION")
+                feed.revision = std::atoi(value.c_str());
+        } else if (key == "UID") {
+            event.uid = unescapeText(value);
+        } else if (key == "SUMMARY") {
+            event.summary = unescapeText(value);
+        } else if (key == "DTSTART") {
+            event.start = value;
+        } else if (key == "DTEND") {
+            event.end = value;
+        } else if (key == "RRULE") {
+            event.rule = value;
+        } else if (key == "DTSTAMP") {
+            event.stamp = value;
+        } else if (key == "SEQUENCE") {
+            event.sequence = std::atoi(value.c_str());
+        } else if (key == "STATUS") {
+            cancelled = value == "CANCELLED";
+        }
+    }
+
+    return feed;
+}
+
+Planner::CalendarDelta Planner::diffCalendar(std::vector<CalendarEvent>& events, const CalendarFeed& previous, const std::string& stamp) {
+    PLANNER_TRACE_SCOPE("diffCalendar");
+    PLANNER_MEMORY_SCOPE(Ics);
+    CalendarDelta delta;
+
+    std::unordered_map<std::string, std::size_t> byUid;
+    byUid.reserve(previous.events.size());
+    for (std::size_t i = 0; i < previous.events.size(); ++i)
+        byUid.emplace(previous.events[i].uid, i);
+
+    // First pass: match events; the revision only moves if something changed
+    std::vector<char> kept(previous.events.size(), 0);
+    std::vector<char> changed(events.size(), 0);
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        auto it = byUid.find(events[i].uid);
+        if (it == byUid.end() || kept[it->second]) {
+            changed[i] = 1;
+            continue;
+        }
+
+        const CalendarEvent& old = previous.events[it->second];
+        kept[it->second] = 1;
+        if (sameSlot(old, events[i])) {
+            events[i].sequence = old.sequence;
+            events[i].stamp = old.stamp;
+            ++delta.unchanged;
+        } else {
+            changed[i] = 1;
+        }
+    }
+
+    std::size_t gone = 0;
+    for (char k : kept)
+        gone += !k;
+
+    bool anyChange = gone > 0 || delta.unchanged != events.size();
+    delta.revision = previous.revision + (anyChange ? 1 : 0);
+
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        if (!changed[i])
+            continue;
+        events[i].sequence = delta.revision;
+        events[i].stamp = stamp;
+        delta.changed.push_back(events[i]);
+    }
+
+    for (std::size_t i = 0; i < previous.events.size(); ++i) {
+        if (kept[i])
+            continue;
+        CalendarEvent event = previous.events[i];
+        event.sequence = delta.revision;
+        event.stamp = stamp;
+        delta.cancelled.push_back(std::move(event));
+    }
+
+    return delta;
+}
+
+void Planner::writeCalendar(std::ostream& output, const std::vector<CalendarEvent>& events, int revision) {
+    PLANNER_TRACE_SCOPE("writeCalendar");
+    PLANNER_MEMORY_SCOPE(Ics);
+    writeHeader(output, nullptr, revision);
+    for (const CalendarEvent& event : events)
+        writeEvent(output, event, false);
+    writeContentLine(output, "END", "VCALENDAR");
+}
+
+void Planner::writeCalendarDelta(std::ostream& output, const CalendarDelta& delta) {
+    writeHeader(output, "PUBLISH", delta.revision);
+    for (const CalendarEvent& event : delta.changed)
+        writeEvent(output, event, false);
+    writeContentLine(output, "END", "VCALENDAR");
+
+    // One calendar object carries one method, so removals follow as their own
+    if (delta.cancelled.empty())
+        return;
+    writeHeader(output, "CANCEL", delta.revision);
+    for (const CalendarEvent& event : delta.cancelled)
+        writeEvent(output, event, true);
+    writeContentLine(output, "END", "VCALENDAR");
+}
+
+std::string Planner::calendarTimestamp() {
+    std::time_t now = std::time(nullptr);
+    char buffer[20];
+    std::strftime(buffer, sizeof(buffer), "%Y%m%dT%H%M%SZ", std::gmtime(&now));
+    return buffer;
+}
@@ -0,0 +1,481 @@
+#include "../include/icsimport.hpp"
+#include "../include/icstext.hpp"
+#include "../include/calendar.hpp"
+#include "../include/trace.hpp"
+#include "../include/memtrack.hpp"
+#include "../include/gzipstream.hpp"
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace {
+    using Planner::MinutesPerDay;
+
+    bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+        if (a.size() != b.size())
+            return false;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (std::toupper(static_cast<unsigned char>(a[i])) != b[i])
+                return false;
+        }
+        return true;
+    }
+
+    // Parse an unsigned decimal field; returns false on anything else
+    bool parseNumber(std::string_view text, int& value) {
+        if (text.empty())
+            return false;
+        value = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9')
+                return false;
+            value = value * 10 + (c - '0');
+        }
+        return true;
+    }
+
+    // A DATE or DATE-TIME value as local minutes
+    struct TimeValue {
+        long long minute = 0;
+        bool dateOnly = false;
+    };
+
+    bool parseTime(std::string_view text, TimeValue& value) {
+        int year, month, day;
+        if (text.size() < 8 || !parseNumber(text.substr(0, 4), year) || !parseNumber(text.substr(4, 2), month) ||
+            !parseNumber(text.substr(6, 2), day) || month < 1 || month > 12 || day < 1 || day > 31)
+            return false;
+
+        int dayNumber = Planner::dayNumber(year, month, day);
+        if (text.size() == 8) {
+            value = {static_cast<long long>(dayNumber) * MinutesPerDay, true};
+            return true;
+        }
+
+        int hour, minute, second;
+        if (text.size() < 15 || text[8] != 'T' || !parseNumber(text.substr(9, 2), hour) ||
+            !parseNumber(text.substr(11, 2), minute) || !parseNumber(text.substr(13, 2), second))
+            return false;
+
+        if (text.size() > 15 && text[15] == 'Z') {
+            // UTC to local wall time
+            std::time_t utc = static_cast<std::time_t>(dayNumber) * 86400 + hour * 3600 + minute * 60 + second;
+            std::tm* local = std::localtime(&utc);
+            dayNumber = Planner::dayNumber(*local);
+            hour = local->tm_hour;
+            minute = local->tm_min;
+        }
+
+        value = {static_cast<long long>(dayNumber) * MinutesPerDay + hour * 60 + minute, false};
+        return true;
+    }
+
+    // ISO 8601 duration such as PT1H30M or P1D, in minutes; -1 if unreadable
+    long long parseDuration(std::string_view text) {
+        if (!text.empty() && (text[0] == '+' || text[0] == '-'))
+            text.remove_prefix(1);
+        if (text.empty() || text[0] != 'P')
+            return -1;
+
+        long long minutes = 0;
+        long long number = 0;
+        bool inTime = false;
+        for (char c : text.substr(1)) {
+            if (c >= '0' && c <= '9') {
+                number = number * 10 + (c - '0');
+                continue;
+            }
+            switch (c) {
+                case 'T': inTime = true; break;
+                case 'W': minutes += number * 7 * MinutesPerDay; break;
+                case 'D': minutes += number * MinutesPerDay; break;
+                case 'H': minutes += number * 60; break;
+                case 'M': minutes += inTime ? number : 0; break;
+                case 'S': minutes += number / 60; break;
+                default: return -1;
+            }
+            number = 0;
+        }
+        return minutes;
+    }
+
+    long long floorDiv(long long a, long long b) {
+        return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+    }
+
+    enum class Frequency { None, Daily, Weekly, Monthly, Yearly };
+
+    struct RecurrenceRule {
+        Frequency frequency = Frequency::None;
+        int interval = 1;
+        int count = -1; // -1 when unbounded
+        bool hasUntil = false;
+        long long until = 0; // Last allowed occurrence start, local minutes
+        unsigned char byDay = 0; // Bit per weekday, Monday = bit 0
+        bool supported = true; // False for parts this importer does not expand
+    };
+
+    int weekdayCode(std::string_view code) {
+        static const char* names[] = {"MO", "TU", "WE", "TH", "FR", "SA", "SU"};
+        for (int i = 0; i < 7; ++i) {
+            if (equalsIgnoreCase(code, names[i]))
+                return i;
+        }
+        return -1;
+    }
+
+    RecurrenceRule parseRule(std::string_view text) {
+        RecurrenceRule rule;
+        while (!text.empty()) {
+            std::size_t end = text.find(';');
+            std::string_view part = text.substr(0, end);
+            text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+
+            std::size_t equals = part.find('=');
+            if (equals == std::string_view::npos)
+                continue;
+            std::string_view key = part.substr(0, equals);
+            std::string_view value = part.substr(equals + 1);
+
+            if (equalsIgnoreCase(key, "FREQ")) {
+                if (equalsIgnoreCase(value, "DAILY"))
+                    rule.frequency = Frequency::Daily;
+                else if (equalsIgnoreCase(value, "WEEKLY"))
+                    rule.frequency = Frequency::Weekly;
+                else if (equalsIgnoreCase(value, "MONTHLY"))
+                    rule.frequency = Frequency::Monthly;
+                else if (equalsIgnoreCase(value, "YEARLY"))
+                    rule.frequency = Frequency::Yearly;
+                else
+                    rule.supported = false;
+            } else if (equalsIgnoreCase(key, "INTERVAL")) {
+                if (!parseNumber(value, rule.interval) || rule.interval < 1)
+                    rule.supported = false;
+            } else if (equalsIgnoreCase(key, "COUNT")) {
+                if (!parseNumber(value, rule.count))
+                    rule.supported = false;
+            } else if (equalsIgnoreCase(key, "UNTIL")) {
+                TimeValue until;
+                rule.hasUntil = parseTime(value, until);
+                // A date-only UNTIL includes the whole day
+                rule.until = until.minute + (until.dateOnly ? MinutesPerDay - 1 : 0);
+                rule.supported = rule.supported && rule.hasUntil;
+            } else if (equalsIgnoreCase(key, "BYDAY")) {
+                while (!value.empty()) {
+                    std::size_t comma = value.find(',');
+                    std::string_view code = value.substr(0, comma);
+                    value = comma == std::string_view::npos ? std::string_view() : value.substr(comma + 1);
+
+                    // Ordinal forms like 2MO only make sense for monthly and yearly rules
+                    int weekday = weekdayCode(code);
+                    if (weekday < 0)
+                        rule.supported = false;
+                    else
+                        rule.byDay |= static_cast<unsigned char>(1u << weekday);
+                }
+            } else if (!equalsIgnoreCase(key, "WKST")) {
+                rule.supported = false;
+            }
+        }
+
+        if (rule.frequency == Frequency::None)
+            rule.supported = false;
+        if (rule.byDay && rule.frequency != Frequency::Weekly)
+            rule.supported = false;
+        return rule;
+    }
+
+    // State of the VEVENT being read; reused so reading allocates nothing per event
+    struct EventState {
+        bool hasStart = false;
+        TimeValue start;
+        bool hasEnd = false;
+        TimeValue end;
+        long long duration = -1;
+        std::string rule;
+        bool free = false;
+        std::vector<TimeValue> exceptions;
+
+        void reset() {
+            hasStart = false;
+            hasEnd = false;
+            duration = -1;
+            rule.clear();
+            free = false;
+            exceptions.clear();
+        }
+    };
+
+    class Importer {
+    public:
+        Importer(Planner::Availability& availability, int firstDay, int lastDay)
+            : availability(availability), firstDay(firstDay), lastDay(lastDay),
+              horizonStart(static_cast<long long>(firstDay) * MinutesPerDay),
+              horizonEnd(static_cast<long long>(lastDay + 1) * MinutesPerDay) {}
+
+        void property(std::string_view name, std::string_view value) {
+            if (equalsIgnoreCase(name, "DTSTART")) {
+                event.hasStart = parseTime(value, event.start);
+            } else if (equalsIgnoreCase(name, "DTEND")) {
+                event.hasEnd = parseTime(value, event.end);
+            } else if (equalsIgnoreCase(name, "DURATION")) {
+                event.duration = parseDuration(value);
+            } else if (equalsIgnoreCase(name, "RRULE")) {
+                event.rule.assign(value.data(), value.size());
+            } else if (equalsIgnoreCase(name, "EXDATE")) {
+                while (!value.empty()) {
+                    std::size_t comma = value.find(',');
+                    TimeValue exception;
+                    if (parseTime(value.substr(0, comma), exception))
+                        event.exceptions.push_back(exception);
+                    value = comma == std::string_view::npos ? std::string_view() : value.substr(comma + 1);
+                }
+            } else if (equalsIgnoreCase(name, "TRANSP")) {
+                event.free = event.free || equalsIgnoreCase(value, "TRANSPARENT");
+            } else if (equalsIgnoreCase(name, "STATUS")) {
+                event.free = event.free || equalsIgnoreCase(value, "CANCELLED");
+            }
+        }
+
+        void beginEvent() {
+            event.reset();
+        }
+
+        void endEvent() {
+            ++stats.events;
+
+            long long length = 0;
+            if (event.hasEnd)
+                length = event.end.minute - event.start.minute;
+            else if (event.duration >= 0)
+                length = event.duration;
+            else if (event.start.dateOnly)
+                length = MinutesPerDay;
+
+            if (!event.hasStart || event.free || length <= 0) {
+                ++stats.skipped;
+                return;
+            }
+
+            RecurrenceRule rule;
+            if (!event.rule.empty())
+                rule = parseRule(event.rule);
+
+            if (event.rule.empty() || !rule.supported) {
+                // Unexpandable rules keep their first occurrence only
+                if (!event.rule.empty())
+                    ++stats.skipped;
+                addOccurrence(event.start.minute, length);
+            } else if (!addWeeklyPattern(rule, length)) {
+                expand(rule, length);
+            }
+        }
+
+        Planner::IcsImportStats stats;
+
+    private:
+        void addOccurrence(long long start, long long length) {
+            if (start < horizonEnd && start + length > horizonStart) {
+                availability.addBusy(start, start + length);
+                ++stats.occurrences;
+            }
+        }
+
+        bool excluded(long long start) const {
+            for (const TimeValue& exception : event.exceptions) {
+                if (exception.dateOnly ? floorDiv(exception.minute, MinutesPerDay) == floorDiv(start, MinutesPerDay)
+                                       : exception.minute == start)
+                    return true;
+            }
+            return false;
+        }
+
+        // Plain weekly rules become one weekly pattern per weekday, valid
+        // from the first occurrence to the last one inside the horizon
+        bool addWeeklyPattern(const RecurrenceRule& rule, long long length) {
+            if (rule.frequency != Frequency::Weekly || rule.interval != 1 || rule.count >= 0 || !event.exceptions.empty())
+                return false;
+
+            const int startDay = static_cast<int>(floorDiv(event.start.minute, MinutesPerDay));
+            const int startMinute = static_cast<int>(event.start.minute - static_cast<long long>(startDay) * MinutesPerDay);
+            const int lengthDays = static_cast<int>((length + MinutesPerDay - 1) / MinutesPerDay);
+
+            int first = std::max(startDay, firstDay - lengthDays);
+            int last = lastDay;
+            if (rule.hasUntil)
+                last = std::min<long long>(last, floorDiv(rule.until - startMinute, MinutesPerDay));
+            if (first > last)
+                return true;
+
+            unsigned char days = rule.byDay ? rule.byDay : static_cast<unsigned char>(1u << Planner::Availability::weekdayOf(startDay));
+            for (int weekday = 0; weekday < 7; ++weekday) {
+                if (days & (1u << weekday))
+                    availability.addWeekly(weekday, startMinute, static_cast<int>(startMinute + length), first, last);
+            }
+            ++stats.weeklyPatterns;
+            return true;
+        }
+
+        // Walk occurrences in order, stopping at the end of the horizon,
+        // UNTIL or COUNT. Unbounded rules skip whole periods before the horizon.
+        void expand(const RecurrenceRule& rule, long long length) {
+            const int startDay = static_cast<int>(floorDiv(event.start.minute, MinutesPerDay));
+            const long long startMinute = event.start.minute - static_cast<long long>(startDay) * MinutesPerDay;
+            const int lengthDays = static_cast<int>((length + MinutesPerDay - 1) / MinutesPerDay);
+            const int earliest = firstDay - lengthDays; // First day whose occurrence can reach the horizon
+            int produced = 0;
+
+            // Returns false once no later occurrence can matter
+            auto emit = [&](int day) {
+                long long start = static_cast<long long>(day) * MinutesPerDay + startMinute;
+                if ((rule.hasUntil && start > rule.until) || (rule.count >= 0 && produced >= rule.count) || day > lastDay)
+                    return false;
+                ++produced;
+                if (!excluded(start))
+                    addOccurrence(start, length);
+                return true;
+            };
+
+            long long skip = 0;
+            switch (rule.frequency) {
+                case Frequency::Daily: {
+                    if (rule.count < 0 && earliest > startDay)
+                        skip = (earliest - startDay) / rule.interval;
+                    for (long long k = skip;; ++k) {
+                        if (!emit(static_cast<int>(startDay + k * rule.interval)))
+                            break;
+                    }
+                    break;
+                }
+                case Frequency::Weekly: {
+                    const int weekStart = startDay - Planner::Availability::weekdayOf(startDay);
+                    const long long stride = 7LL * rule.interval;
+                    unsigned char days = rule.byDay ? rule.byDay : static_cast<unsigned char>(1u << Planner::Availability::weekdayOf(startDay));
+                    if (rule.count < 0 && earliest > weekStart)
+                        skip = (earliest - weekStart) / stride;
+
+                    for (long long k = skip;; ++k) {
+                        bool more = true;
+                        for (int weekday = 0; weekday < 7 && more; ++weekday) {
+                            int day = static_cast<int>(weekStart + k * stride + weekday);
+                            if ((days & (1u << weekday)) && day >= startDay)
+                                more = emit(day);
+                        }
+                        if (!more)
+                            break;
+                    }
+                    break;
+                }
+                case Frequency::Monthly:
+                case Frequency::Yearly: {
+                    int year, month, dayOfMonth;
+                    Planner::civilFromDayNumber(startDay, year, month, dayOfMonth);
+                    const int stride = rule.frequency == Frequency::Monthly ? rule.interval : 12 * rule.interval;
+
+                    if (rule.count < 0 && earliest > startDay) {
+                        int earliestYear, earliestMonth, earliestDay;
+                        Planner::civilFromDayNumber(earliest, earliestYear, earliestMonth, earliestDay);
+                        int months = (earliestYear - year) * 12 + (earliestMonth - month) - 1;
+                        skip = std::max(months, 0) / stride;
+                    }
+
+                    for (long long k = skip;; ++k) {
+                        long long index = (month - 1) + k * stride;
+                        int occurrenceYear = static_cast<int>(year + index / 12);
+                        int occurrenceMonth = static_cast<int>(index % 12) + 1;
+
+                        // Dates like February 30 do not exist and are skipped
+                        if (dayOfMonth > Planner::daysInMonth(occurrenceYear, occurrenceMonth)) {
+                            if (Planner::dayNumber(occurrenceYear, occurrenceMonth, 1) > lastDay)
+                                break;
+                            continue;
+                        }
+                        if (!emit(Planner::dayNumber(occurrenceYear, occurrenceMonth, dayOfMonth)))
+                            break;
+                    }
+                    break;
+                }
+                case Frequency::None:
+                    break;
+            }
+        }
+
+        Planner::Availability& availability;
+        const int firstDay;
+        const int lastDay;
+        const long long horizonStart;
+        const long long horizonEnd;
+        EventState event;
+    };
+}
+
+Planner::IcsImportStats Planner::importICS(std::istream& input, Availability& availability, int firstDay, int lastDay) {
+    PLANNER_TRACE_SCOPE("importICS");
+    PLANNER_MEMORY_SCOPE(Ics);
+    Importer importer(availability, firstDay, lastDay);
+    UnfoldingReader reader(input);
+    Availability::Batch batch(availability);
+
+    std::string line;
+    bool inEvent = false;
+    int nested = 0; // Depth of components inside the event, such as VALARM
+
+    while (reader.read(line)) {
+        std::string_view view(line);
+
+        // The value starts at the first colon outside a quoted parameter
+        std::size_t colon = std::string_view::npos;
+        bool quoted = false;
+        for (std::size_t i = 0; i < view.size(); ++i) {
+            if (view[i] == '"')
+                quoted = !quoted;
+            else if (view[i] == ':' && !quoted) {
+                colon = i;
+                break;
+            }
+        }
+        if (colon == std::string_view::npos)
+            continue;
+
+        std::string_view head = view.substr(0, colon);
+        std::string_view value = view.substr(colon + 1);
+        std::size_t semicolon = head.find(';');
+        std::string_view name = head.substr(0, semicolon); // Parameters such as TZID are not needed
+
+        if (equalsIgnoreCase(name, "BEGIN")) {
+            if (inEvent)
+                ++nested;
+            else if (equalsIgnoreCase(value, "VEVENT")) {
+                inEvent = true;
+                importer.beginEvent();
+            }
+        } else if (equalsIgnoreCase(name, "END")) {
+            if (nested > 0)
+                --nested;
+            else if (inEvent && equalsIgnoreCase(value, "VEVENT")) {
+                inEvent = false;
+                importer.endEvent();
+            }
+        } else if (inEvent && nested == 0) {
+            importer.property(name, value);
+        }
+    }
+
+    return importer.stats;
+}
+
+Planner::IcsImportStats Planner::importICSFile(const std::string& filename, Availability& availability, int firstDay, int lastDay) {
+    InputFile file(filename);
+    if (!file.isOpen()) {
+        std::cerr << "Error: Could not open file " << filename << " for reading.\n";
+        return IcsImportStats();
+    }
+
+    IcsImportStats stats = importICS(file.stream(), availability, firstDay, lastDay);
+    if (file.failed())
+        std::cerr << "Error: " << filename << " is truncated or corrupt.\n";
+    return stats;
+}
@@ -0,0 +1,88 @@
+#include "../include/icstext.hpp"
+
+namespace {
+    constexpr std::size_t MaxLineOctets = 75;
+
+    bool isContinuationByte(char c) {
+        return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+    }
+}
+
+std::string Planner::escapeText(std::string_view text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (c == '\\' || c == ';' || c == ',') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\r' && i + 1 < text.size() && text[i + 1] == '\n') {
+            continue; // CRLF becomes one escaped newline
+        } else if (c == '\n' || c == '\r') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+std::string Planner::unescapeText(std::string_view text) {
+    std::string plain;
+    plain.reserve(text.size());
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (text[i] != '\\' || i + 1 == text.size()) {
+            plain += text[i];
+            continue;
+        }
+        char c = text[++i];
+        plain += (c == 'n' || c == 'N') ? '\n' : c;
+    }
+    return plain;
+}
+
+void Planner::writeContentLine(std::ostream& output, std::string_view name, std::string_view value) {
+    std::string line;
+    line.reserve(name.size() + 1 + value.size());
+    line.append(name).append(1, ':').append(value);
+
+    // Continuation lines spend one octet on the leading space
+    std::size_t start = 0;
+    std::size_t room = MaxLineOctets;
+    while (line.size() - start > room) {
+        std::size_t end = start + room;
+        while (end > start + 1 && isContinuationByte(line[end]))
+            --end;
+        output.write(line.data() + start, static_cast<std::streamsize>(end - start));
+        output << "\r\n ";
+        start = end;
+        room = MaxLineOctets - 1;
+    }
+    output.write(line.data() + start, static_cast<std::streamsize>(line.size() - start));
+    output << "\r\n";
+}
+
+Planner::UnfoldingReader::UnfoldingReader(std::istream& input) : input(input) {
+    hasNext = fetch(next);
+}
+
+bool Planner::UnfoldingReader::read(std::string& line) {
+    if (!hasNext)
+        return false;
+
+    line.swap(next);
+    hasNext = fetch(next);
+    while (hasNext && !next.empty() && (next[0] == ' ' || next[0] == '\t')) {
+        line.append(next, 1, std::string::npos);
+        hasNext = fetch(next);
+    }
+    return true;
+}
+
+bool Planner::UnfoldingReader::fetch(std::string& line) {
+    if (!std::getline(input, line))
+        return false;
+    if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+    return true;
+}
@@ -0,0 +1,226 @@
+#include "../include/lazyplan.hpp"
+#include "../include/persistence.hpp"
+#include "../include/calendar.hpp"
+#include "../include/json.hpp"
+#include "../include/trace.hpp"
+#include "../include/memtrack.hpp"
+#include <algorithm>
+#include <iostream>
+#include <set>
+
+using json = nlohmann::json;
+
+namespace {
+    // One assignment line, with its deadline moved by shift days
+    std::string assignmentLine(const Assignment& assignment, int shift) {
+        json line = {
+            {"subject", assignment.getSubject()},
+            {"name", assignment.getName()},
+            {"deadline", assignment.getDeadline() + shift},
+            {"duration", assignment.getDuration()},
+            {"weight", assignment.getWeight()},
+            {"size", assignment.getSize()},
+            {"group_work", assignment.isGroupWork()},
+            {"group_size", assignment.getGroupSize()}
+        };
+        return line.dump();
+    }
+
+    void emplaceAssignment(Planner::AssignmentStore& assignments, const json& obj) {
+        assignments.emplace(
+            obj.at("subject").get<std::string>(),
+            obj.at("name").get<std::string>(),
+            obj.at("deadline").get<int>(),
+            obj.at("duration").get<int>(),
+            obj.at("weight").get<float>(),
+            obj.at("size").get<int>(),
+            obj.at("group_work").get<bool>(),
+            obj.at("group_size").get<int>()
+        );
+    }
+
+    std::string headerLine(const Planner::PlanSummary& summary) {
+        json header = {
+            {"epoch", summary.epoch},
+            {"count", summary.count},
+            {"subjects", summary.subjects}
+        };
+        return header.dump();
+    }
+
+    void addSubject(std::vector<std::string>& subjects, const std::string& subject) {
+        auto at = std::lower_bound(subjects.begin(), subjects.end(), subject);
+        if (at == subjects.end() || *at != subject)
+            subjects.insert(at, subject);
+    }
+}
+
+std::string Planner::formatPlanRecord(const AssignmentStore& assignments) {
+    PlanSummary summary;
+    summary.epoch = assignments.epochDay();
+    summary.count = assignments.size();
+    std::set<std::string> subjects;
+    for (AssignmentHandle handle : assignments.handles())
+        subjects.insert(assignments[handle].getSubject());
+    summary.subjects.assign(subjects.begin(), subjects.end());
+
+    std::string record = headerLine(summary) + "\n";
+    for (AssignmentHandle handle : assignments.handles())
+        record += assignmentLine(assignments[handle], 0) + "\n";
+    return record;
+}
+
+Planner::AssignmentStore Planner::parsePlanRecord(const std::string& record) {
+    AssignmentStore assignments;
+
+    try {
+        std::size_t end = std::min(record.find('\n'), record.size());
+        json header = json::parse(record.begin(), record.begin() + static_cast<std::ptrdiff_t>(end));
+        assignments.setEpochDay(header.at("epoch").get<int>());
+
+        if (header.contains("assignments")) {
+            // Records written as a single object before the header line existed
+            for (const auto& obj : header.at("assignments"))
+                emplaceAssignment(assignments, obj);
+        } else {
+            while (end < record.size()) {
+                std::size_t start = end + 1;
+                end = std::min(record.find('\n', start), record.size());
+                if (end > start)
+                    emplaceAssignment(assignments, json::parse(record.begin() + static_cast<std::ptrdiff_t>(start),
+                                                               record.begin() + static_cast<std::ptrdiff_t>(end)));
+            }
+        }
+    } catch (const json::exception& e) {
+        std::cerr << "Error: Failed to parse JSON - " << e.what() << "\n";
+    }
+
+    // Count deadlines from today so stored due dates never go stale
+    assignments.rebase(today());
+    return assignments;
+}
+
+Planner::PlanSummary Planner::parsePlanHeader(const std::string& header) {
+    PlanSummary summary;
+    summary.epoch = today();
+
+    try {
+        json data = json::parse(header);
+        summary.epoch = data.at("epoch").get<int>();
+
+        if (data.contains("assignments")) {
+            const json& records = data.at("assignments");
+            summary.count = records.size();
+            for (const auto& obj : records)
+                addSubject(summary.subjects, obj.at("subject").get<std::string>());
+        } else {
+            summary.count = data.at("count").get<std::size_t>();
+            summary.subjects = data.at("subjects").get<std::vector<std::string>>();
+        }
+    } catch (const json::exception& e) {
+        std::cerr << "Error: Failed to parse JSON - " << e.what() << "\n";
+    }
+    return summary;
+}
+
+std::string Planner::appendPlanRecord(const std::string& record, const PlanSummary& summary,
+                                      const std::vector<Assignment>& added) {
+    std::size_t headerEnd = record.find('\n');
+    if (!record.empty() && headerEnd == std::string::npos) {
+        // A single-object record has no lines to append to
+        AssignmentStore assignments = parsePlanRecord(record);
+        for (const Assignment& assignment : added)
+            assignments.emplace(assignment);
+        return formatPlanRecord(assignments);
+    }
+
+    // Append to the stored lines as they are; only the header is rebuilt.
+    // Deadlines of new assignments count from today, stored ones from the epoch.
+    const int shift = today() - summary.epoch;
+    std::string updated = headerLine(summary) + "\n";
+    if (headerEnd != std::string::npos)
+        updated.append(record, headerEnd + 1, std::string::npos);
+    for (const Assignment& assignment : added)
+        updated += assignmentLine(assignment, shift) + "\n";
+    return updated;
+}
+
+Planner::AssignmentStore Planner::loadFromFile(UserDatabase& database, const std::string& userName) {
+    PLANNER_TRACE_SCOPE("loadFromDatabase");
+    PLANNER_MEMORY_SCOPE(Load);
+    std::string record;
+    if (!database.read(userName, record))
+        return AssignmentStore(); // A user without a record has no assignments yet
+    return parsePlanRecord(record);
+}
+
+void Planner::saveToFile(UserDatabase& database, const std::string& userName, const AssignmentStore& assignments) {
+    PLANNER_TRACE_SCOPE("saveToDatabase");
+    PLANNER_MEMORY_SCOPE(Save);
+    if (!database.write(userName, formatPlanRecord(assignments)))
+        std::cerr << "Error: Could not save " << userName << " to the database.\n";
+}
+
+Planner::LazyPlan::LazyPlan(UserDatabase& database, const std::string& userName, PersistenceWriter* writer)
+    : database(database), userName(userName), writer(writer) {
+    PLANNER_TRACE_SCOPE("openPlan");
+    if (writer)
+        writer->wait(); // The record must include every write already handed over
+    std::string header;
+    if (database.readPrefix(userName, '\n', header))
+        summary = parsePlanHeader(header);
+    else
+        summary.epoch = today();
+}
+
+std::size_t Planner::LazyPlan::size() const {
+    return loaded ? store.size() : summary.count + pending.size();
+}
+
+Planner::AssignmentStore& Planner::LazyPlan::assignments() {
+    if (!loaded) {
+        if (writer)
+            writer->wait();
+        store = loadFromFile(database, userName);
+        for (const Assignment& assignment : pending)
+            store.emplace(assignment);
+        pending.clear();
+        loaded = true;
+    }
+    return store;
+}
+
+void Planner::LazyPlan::add(const Assignment& assignment) {
+    if (loaded) {
+        store.emplace(assignment);
+        return;
+    }
+    pending.push_back(assignment);
+    addSubject(summary.subjects, assignment.getSubject());
+}
+
+bool Planner::LazyPlan::save() {
+    PLANNER_TRACE_SCOPE("savePlan");
+    PLANNER_MEMORY_SCOPE(Save);
+    if (loaded) {
+        if (!writer)
+            return database.write(userName, formatPlanRecord(store));
+        writer->savePlan(userName, store);
+        return true;
+    }
+    if (pending.empty())
+        return true;
+
+    std::string record;
+    if (!writer && !database.read(userName, record) && database.contains(userName))
+        return false; // Appending to a partly read record would overwrite the plan
+
+    summary.count += pending.size();
+    std::vector<Assignment> added;
+    added.swap(pending);
+    if (writer) {
+        writer->appendToPlan(userName, summary, std::move(added));
+        return true;
+    }
+    return database.write(userName, appendPlanRecord(record, summary, added));
+}
@@ -1,11 +1,21 @@
 #include "FileException.hpp"
 #include "../include/planner.hpp"
 #include "../include/displayfunctions.hpp"
+#include "../include/sweep.hpp"
+#include "../include/feasibility.hpp"
+#include "../include/focus.hpp"
+#include "../include/groupslots.hpp"
+#include "../include/textindex.hpp"
+#include "../include/icsimport.hpp"
+#include "../include/trace.hpp"
+#include "../include/memtrack.hpp"
+#include "../include/gzipstream.hpp"
+#include "../include/lazyplan.hpp"
+#include "../include/persistence.hpp"
 #include <iostream>
 #include <string>
 #include <vector>
 #include <filesystem>
-#include <fstream>
 
 // Ensure the Data directory exists
 void ensureDataDirectoryExists() {
@@ -16,15 +26,71 @@ void ensureDataDirectoryExists() {
     }
 }
 
-// Check if user data file exists
-void checkUserFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw FileException("File not found: " + filename);
+// Legacy per-user file of a user, plain or compressed, or "" if there is none
+std::string legacyUserFile(const std::string& name) {
+    std::string userFile = "Data/" + name + ".json";
+    if (std::filesystem::exists(userFile + ".gz"))
+        return userFile + ".gz";
+    return std::filesystem::exists(userFile) ? userFile : "";
+}
+
+// True if a name can be part of a file name under Data/ without leaving it
+bool isSafeName(const std::string& name) {
+    if (name.empty() || name.size() > Planner::UserDatabase::MaxUserNameLength || name[0] == '.')
+        return false;
+    return name.find_first_of("/\\:") == std::string::npos;
+}
+
+// Write the Chrome trace requested with --trace, if any
+void finishTrace(const std::string& tracePath) {
+    if (tracePath.empty())
+        return;
+
+    Planner::stopTracing();
+    if (Planner::writeTrace(tracePath)) {
+        std::cout << "Trace written to " << tracePath << " (open it in ui.perfetto.dev)\n";
+    } else {
+        std::cerr << "Error: Could not write trace to " << tracePath << "\n";
     }
 }
 
-int main() {
+// Report saves that failed on the persistence thread since the last report
+void reportSaveErrors(Planner::PersistenceWriter& writer) {
+    for (const std::string& error : writer.takeErrors())
+        std::cerr << "Error: " << error << "\n";
+}
+
+// Print the heap usage per phase requested with --mem-report
+void finishMemoryReport(bool memoryReport) {
+    if (!memoryReport)
+        return;
+
+    Planner::stopMemoryTracking();
+    std::cout << "\nHeap usage by phase:\n";
+    Planner::writeMemoryReport(std::cout);
+}
+
+int main(int argc, char* argv[]) {
+    // --trace FILE records phase timings for the whole session;
+    // --mem-report prints the heap usage of each phase on exit;
+    // --compress stores the user's plan and calendar gzip-compressed
+    std::string tracePath;
+    bool memoryReport = false;
+    bool compress = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string flag = argv[i];
+        if (flag == "--trace" && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (flag == "--mem-report")
+            memoryReport = true;
+        else if (flag == "--compress")
+            compress = true;
+    }
+    if (!tracePath.empty())
+        Planner::startTracing();
+    if (memoryReport)
+        Planner::startMemoryTracking();
+
     try {
         // Step 1: Ensure the Data directory exists
         try {
@@ -34,55 +100,91 @@ int main() {
             return 1; // Exit if the directory cannot be created
         }
 
-        // Step 2: Get user name and file
+        // Every user lives in one database file
+        Planner::UserDatabase database(Planner::DefaultDatabasePath);
+        if (!database.isOpen()) {
+            std::cerr << "Critical Error: Could not open " << Planner::DefaultDatabasePath << "\n";
+            return 1;
+        }
+
+        // Step 2: Get user name
         std::cout << "Enter your name: ";
         std::string name;
         std::cin >> name;
+        if (!isSafeName(name)) {
+            std::cerr << "Names are limited to " << Planner::UserDatabase::MaxUserNameLength
+                      << " characters, may not start with '.' and may not contain '/', '\\' or ':'.\n";
+            return 1;
+        }
 
-        std::string userFile = "Data/" + name + ".json";
-
-        // Step 3: Check if the user file exists
-        try {
-            checkUserFile(userFile);
-            std::cout << "Welcome back, " << name << "!\n";
-        } catch (const FileException& e) {
-            std::cout << e.what() << "\nCreating a new file...\n";
-
-            // Create the file
-            std::ofstream MyFile(userFile);
-            if (!MyFile) {
-                throw FileException("Could not create the file for the user at: " + userFile);
+        // Step 3: Find the user, moving them over from a legacy file if needed.
+        // A plan stays compressed once it is stored compressed.
+        std::string legacyFile;
+        if (database.contains(name)) {
+            if (compress && !database.isCompressed(name)) {
+                std::string record;
+                if (database.read(name, record))
+                    database.write(name, record, true);
             }
-            MyFile << "[]"; // Initialize the file with an empty JSON array
-            MyFile.close();
-            std::cout << "Welcome, " << name << "! A new file has been created for you.\n";
+            std::cout << "Welcome back, " << name << "!\n";
+        } else if (!(legacyFile = legacyUserFile(name)).empty()) {
+            database.write(name, Planner::formatPlanRecord(Planner::loadFromFile(legacyFile)),
+                           compress || Planner::isGzipPath(legacyFile));
+            std::cout << "Welcome back, " << name << "! Your plan was moved from " << legacyFile << " into the database.\n";
+        } else {
+            database.write(name, Planner::formatPlanRecord(Planner::AssignmentStore()), compress);
+            std::cout << "Welcome, " << name << "! A new plan has been created for you.\n";
         }
+        const bool compressCalendar = database.isCompressed(name);
 
-        // Step 4: Load assignments
-        std::vector<Planner::AssignmentPtr> assignments;
-        try {
-            assignments = Planner::loadFromFile(userFile);
-        } catch (const std::exception& e) {
-            std::cerr << "Error while loading assignments: " << e.what() << "\n";
-            return 2; // Exit if assignments cannot be loaded
-        }
+        // Saves run on a background thread; Ctrl+C still writes what is queued
+        Planner::PersistenceWriter writer(database);
+        Planner::SignalDrain signalDrain(writer);
+
+        // Step 4: Open the plan; only its header is read until an
+        // operation needs the assignments themselves
+        Planner::LazyPlan plan(database, name, &writer);
+        std::cout << "You have " << plan.size() << " assignments";
+        for (std::size_t i = 0; i < plan.subjects().size(); ++i)
+            std::cout << (i == 0 ? " in " : ", ") << plan.subjects()[i];
+        std::cout << ".\n";
+
+        // Classes, shifts and other commitments the scheduler plans around
+        std::string availabilityFile = "Data/" + name + "_availability.json";
+        Planner::Availability availability = Planner::loadAvailability(availabilityFile);
+
+        // Dates with their own study budget, such as holidays, one "YYYY-MM-DD hours" line each
+        std::vector<Planner::Holiday> holidays = Planner::loadHolidays("Data/" + name + "_holidays.txt");
+
+        // Names and subjects by trigram, built on the first search and kept up to date after it
+        Planner::TextIndex searchIndex;
+        bool searchIndexBuilt = false;
 
         // Step 5: Main menu loop
         while (true) {
+            reportSaveErrors(writer);
             try {
                 std::cout << "\nMain Menu:\n";
                 std::cout << "1. Add an Assignment\n";
                 std::cout << "2. Delete an Assignment\n";
-                std::cout << "3. Run Priority-Based Scheduler\n";
+                std::cout << "3. Run Scheduler\n";
                 std::cout << "4. Display Options\n";
                 std::cout << "5. Exit\n";
+                std::cout << "6. Sweep Study-Hour Budgets\n";
+                std::cout << "7. Find Minimum Daily Study Budget\n";
+                std::cout << "8. Add a Weekly Commitment\n";
+                std::cout << "9. Import Busy Times from a Calendar File\n";
+                std::cout << "10. Show the Plan for the Next 7 Days\n";
+                std::cout << "11. What Should I Work on Today?\n";
+                std::cout << "12. Plan Group Sessions\n";
+                std::cout << "13. Search Assignments\n";
                 std::cout << "Enter your choice: ";
 
                 int choice;
                 std::cin >> choice;
 
                 // Input validation
-                if (std::cin.fail() || choice < 1 || choice > 5) {
+                if (std::cin.fail() || choice < 1 || choice > 13) {
                     std::cin.clear(); // Clear the input buffer
                     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                     std::cout << "Invalid choice. Please try again.\n";
@@ -92,7 +194,7 @@ int main() {
                 switch (choice) {
                     case 1: {
                         // Adding an assignment
-                        std::string subject, name;
+                        std::string subject, assignmentName;
                         int deadline, duration, size, groupSize;
                         float weight;
                         bool groupWork;
@@ -102,7 +204,7 @@ int main() {
                         std::cout << "Subject: ";
                         std::getline(std::cin, subject);
                         std::cout << "Name: ";
-                        std::getline(std::cin, name);
+                        std::getline(std::cin, assignmentName);
                         std::cout << "Deadline (in days): ";
                         std::cin >> deadline;
                         std::cout << "Duration (in hours): ";
@@ -121,25 +223,30 @@ int main() {
                             groupSize = 1;
                         }
 
-                        auto newAssignment = std::make_shared<Assignment>(
-                            subject, name, deadline, duration, weight, size, groupWork, groupSize);
-                        assignments.push_back(newAssignment);
+                        plan.add(Assignment(subject, assignmentName, deadline, duration, weight, size, groupWork, groupSize));
+                        if (searchIndexBuilt) {
+                            const Planner::AssignmentStore& assignments = plan.assignments();
+                            Planner::AssignmentHandle added = assignments.handles().back();
+                            searchIndex.add(added, Planner::searchableFields(assignments[added]));
+                        }
 
-                        // Save changes to the file
-                        Planner::saveToFile(userFile, assignments);
+                        // Save changes to the database
+                        plan.save();
                         std::cout << "Assignment added successfully.\n";
                         break;
                     }
                     case 2: {
                         // Deleting an assignment
+                        Planner::AssignmentStore& assignments = plan.assignments();
                         if (assignments.empty()) {
                             std::cout << "No assignments to delete.\n";
                             break;
                         }
 
                         std::cout << "Select the assignment to delete:\n";
-                        for (size_t i = 0; i < assignments.size(); ++i) {
-                            std::cout << i + 1 << ". " << assignments[i]->getName() << "\n";
+                        const auto& handles = assignments.handles();
+                        for (size_t i = 0; i < handles.size(); ++i) {
+                            std::cout << i + 1 << ". " << assignments[handles[i]].getName() << "\n";
                         }
                         std::cout << "Enter your choice: ";
 
@@ -147,10 +254,21 @@ int main() {
                         std::cin >> deleteIndex;
 
                         if (deleteIndex > 0 && deleteIndex <= assignments.size()) {
-                            assignments.erase(assignments.begin() + (deleteIndex - 1));
+                            Planner::AssignmentHandle handle = assignments.handles()[deleteIndex - 1];
+
+                            // Shared sessions reserved for it would otherwise block study time for good
+                            if (assignments[handle].isGroupWork()) {
+                                availability.release(Planner::groupSessionTag(assignments[handle]));
+                                writer.submit(availabilityFile, [availabilityFile, availability] {
+                                    return Planner::saveAvailability(availabilityFile, availability);
+                                });
+                            }
 
-                            // Save changes to the file
-                            Planner::saveToFile(userFile, assignments);
+                            searchIndex.remove(handle);
+                            assignments.remove(handle);
+
+                            // Save changes to the database
+                            plan.save();
                             std::cout << "Assignment deleted successfully.\n";
                         } else {
                             std::cout << "Invalid choice.\n";
@@ -158,34 +276,241 @@ int main() {
                         break;
                     }
                     case 3: {
-                        // Run priority-based scheduler
-                        if (assignments.empty()) {
+                        // Run the scheduler with the chosen engine
+                        if (plan.empty()) {
                             std::cout << "No assignments to schedule.\n";
                             break;
                         }
 
                         int weekdayHours, weekendHours;
+                        bool earliestDeadline, deltaOnly;
                         std::cout << "Enter weekday study hours: ";
                         std::cin >> weekdayHours;
                         std::cout << "Enter weekend study hours: ";
                         std::cin >> weekendHours;
+                        std::cout << "Use earliest-deadline-first scheduling (1 for Yes, 0 for No): ";
+                        std::cin >> earliestDeadline;
+                        std::cout << "Also write only the changes since the last run (1 for Yes, 0 for No): ";
+                        std::cin >> deltaOnly;
 
-                        Planner::scheduler(assignments, weekdayHours, weekendHours, name);
+                        auto engine = earliestDeadline ? Planner::SchedulerEngine::EarliestDeadline
+                                                       : Planner::SchedulerEngine::Priority;
+                        auto output = deltaOnly ? Planner::CalendarOutput::Delta : Planner::CalendarOutput::Full;
+                        // Weekends and holidays fall on their real dates
+                        auto capacity = Planner::calendarCapacity(Planner::today(), weekdayHours, weekendHours, holidays,
+                                                                  Planner::DefaultImportHorizonDays);
+                        Planner::scheduler(plan.assignments(), weekdayHours, weekendHours, name, engine, &availability, output, &capacity,
+                                           compressCalendar);
                         std::cout << "\nSchedule saved to Data/" << name << "_schedule.ics\n";
+                        if (deltaOnly)
+                            std::cout << "Changes saved to Data/" << name << "_schedule_delta.ics\n";
                         break;
                     }
                     case 4: {
                         // Display options menu
-                        DisplayFunctions::displayMenu(assignments);
+                        DisplayFunctions::displayMenu(plan.assignments());
                         break;
                     }
                     case 5: {
                         // Exit program
                         std::cout << "Goodbye!\\n";
 
-                        // Save changes before exiting
-                        Planner::saveToFile(userFile, assignments);
-                        return 0;
+                        // Save changes and wait for every queued write before exiting
+                        plan.save();
+                        bool saved = writer.drain();
+                        reportSaveErrors(writer);
+                        finishTrace(tracePath);
+                        finishMemoryReport(memoryReport);
+                        return saved ? 0 : 1;
+                    }
+                    case 6: {
+                        // Sweep weekday/weekend budgets to find the cheapest one without misses
+                        if (plan.empty()) {
+                            std::cout << "No assignments to schedule.\n";
+                            break;
+                        }
+
+                        int maxWeekdayHours, maxWeekendHours;
+                        std::cout << "Enter maximum weekday study hours: ";
+                        std::cin >> maxWeekdayHours;
+                        std::cout << "Enter maximum weekend study hours: ";
+                        std::cin >> maxWeekendHours;
+
+                        // Plan each budget the way menu 3 would, on real dates
+                        Planner::ScheduleOptions options;
+                        options.availability = &availability;
+                        options.startDay = Planner::today();
+                        auto result = Planner::sweepStudyHours(plan.assignments(), maxWeekdayHours, maxWeekendHours, options,
+                                                               holidays, Planner::DefaultImportHorizonDays);
+                        DisplayFunctions::displaySweepResult(result);
+                        break;
+                    }
+                    case 7: {
+                        // Smallest uniform daily budget that can meet every deadline
+                        if (plan.empty()) {
+                            std::cout << "No assignments to schedule.\n";
+                            break;
+                        }
+
+                        int budget = Planner::minimalBudget(plan.assignments(), Planner::today(), holidays);
+                        if (budget < 0) {
+                            std::cout << "No daily budget up to 24 hours can meet every deadline.\n";
+                        } else {
+                            std::cout << "At least " << budget << " study hours per day are needed to meet every deadline.\n";
+                        }
+                        break;
+                    }
+                    case 8: {
+                        // Recurring busy time, such as a class or a work shift
+                        int weekday, startHour, endHour;
+                        std::cout << "Weekday (1 = Monday ... 7 = Sunday): ";
+                        std::cin >> weekday;
+                        std::cout << "Start hour (0-23): ";
+                        std::cin >> startHour;
+                        std::cout << "End hour (may pass 24 for overnight commitments): ";
+                        std::cin >> endHour;
+
+                        if (weekday < 1 || weekday > 7 || startHour < 0 || startHour > 23 || endHour <= startHour) {
+                            std::cout << "Invalid commitment.\n";
+                            break;
+                        }
+
+                        availability.addWeekly(weekday - 1, startHour * 60, endHour * 60);
+                        writer.submit(availabilityFile, [availabilityFile, availability] {
+                            return Planner::saveAvailability(availabilityFile, availability);
+                        });
+                        std::cout << "Commitment added successfully.\n";
+                        break;
+                    }
+                    case 9: {
+                        // Busy time from an existing timetable, one year ahead
+                        std::string calendarFile;
+                        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                        std::cout << "Path to the .ics file: ";
+                        std::getline(std::cin, calendarFile);
+
+                        int firstDay = Planner::today();
+                        auto stats = Planner::importICSFile(calendarFile, availability, firstDay,
+                                                            firstDay + Planner::DefaultImportHorizonDays);
+                        writer.submit(availabilityFile, [availabilityFile, availability] {
+                            return Planner::saveAvailability(availabilityFile, availability);
+                        });
+                        std::cout << "Imported " << stats.events << " events (" << stats.weeklyPatterns << " weekly, "
+                                  << stats.occurrences << " busy intervals, " << stats.skipped << " skipped).\n";
+                        break;
+                    }
+                    case 10: {
+                        // Only the coming week is simulated, however long the plan runs
+                        if (plan.empty()) {
+                            std::cout << "No assignments to schedule.\n";
+                            break;
+                        }
+
+                        Planner::ScheduleOptions options;
+                        std::cout << "Enter weekday study hours: ";
+                        std::cin >> options.weekdayStudyHours;
+                        std::cout << "Enter weekend study hours: ";
+                        std::cin >> options.weekendStudyHours;
+                        options.availability = &availability;
+                        options.startDay = Planner::today();
+                        auto capacity = Planner::calendarCapacity(options.startDay, options.weekdayStudyHours, options.weekendStudyHours,
+                                                                  holidays, Planner::DefaultImportHorizonDays);
+                        options.capacity = &capacity;
+                        DisplayFunctions::displayDaysAhead(plan.assignments(), options, 7);
+                        break;
+                    }
+                    case 11: {
+                        // Only today's hours are handed out; no later day is simulated
+                        if (plan.empty()) {
+                            std::cout << "No assignments to work on.\n";
+                            break;
+                        }
+
+                        Planner::ScheduleOptions options;
+                        std::cout << "Enter weekday study hours: ";
+                        std::cin >> options.weekdayStudyHours;
+                        std::cout << "Enter weekend study hours: ";
+                        std::cin >> options.weekendStudyHours;
+                        options.availability = &availability;
+                        options.startDay = Planner::today();
+                        auto capacity = Planner::calendarCapacity(options.startDay, options.weekdayStudyHours, options.weekendStudyHours,
+                                                                  holidays, Planner::DefaultImportHorizonDays);
+                        options.capacity = &capacity;
+                        DisplayFunctions::displayTodaysFocus(plan.assignments(), Planner::todaysFocus(plan.assignments(), options));
+                        break;
+                    }
+                    case 12: {
+                        // Common free time of every group member over the term
+                        int others, hoursPerDay;
+                        std::cout << "Number of other group members: ";
+                        std::cin >> others;
+                        if (std::cin.fail() || others < 0) {
+                            std::cout << "Invalid number of members.\n";
+                            break;
+                        }
+
+                        std::vector<std::string> memberFiles;
+                        std::vector<Planner::Availability> memberAvailability;
+                        for (int i = 0; i < others; ++i) {
+                            std::string member;
+                            std::cout << "Name of member " << (i + 1) << ": ";
+                            std::cin >> member;
+                            if (!isSafeName(member)) {
+                                std::cout << "Invalid member name.\n";
+                                break;
+                            }
+                            memberFiles.push_back("Data/" + member + "_availability.json");
+                            memberAvailability.push_back(Planner::loadAvailability(memberFiles.back()));
+                        }
+                        if (static_cast<int>(memberFiles.size()) < others)
+                            break;
+
+                        std::cout << "Most hours the group meets per day: ";
+                        std::cin >> hoursPerDay;
+                        if (std::cin.fail() || hoursPerDay < 1) {
+                            std::cout << "Invalid number of hours.\n";
+                            break;
+                        }
+
+                        // Sessions from an earlier plan are given back before planning again
+                        const Planner::AssignmentStore& assignments = plan.assignments();
+                        Planner::releaseGroupSessions(availability, assignments);
+                        for (auto& member : memberAvailability)
+                            Planner::releaseGroupSessions(member, assignments);
+
+                        std::vector<const Planner::Availability*> members{&availability};
+                        for (const auto& member : memberAvailability)
+                            members.push_back(&member);
+                        auto groupPlan = Planner::planGroupSessions(assignments, members, Planner::today() + 1,
+                                                                    Planner::DefaultTermWeeks, hoursPerDay);
+                        DisplayFunctions::displayGroupPlan(assignments, groupPlan);
+
+                        // Every member's own plan works around the shared sessions
+                        Planner::reserveGroupSessions(availability, assignments, groupPlan.sessions);
+                        writer.submit(availabilityFile, [availabilityFile, availability] {
+                            return Planner::saveAvailability(availabilityFile, availability);
+                        });
+                        for (std::size_t i = 0; i < memberFiles.size(); ++i) {
+                            Planner::reserveGroupSessions(memberAvailability[i], assignments, groupPlan.sessions);
+                            writer.submit(memberFiles[i], [file = memberFiles[i], reserved = memberAvailability[i]] {
+                                return Planner::saveAvailability(file, reserved);
+                            });
+                        }
+                        break;
+                    }
+                    case 13: {
+                        // Find assignments by a fragment of their name or subject
+                        std::string query;
+                        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                        std::cout << "Search for: ";
+                        std::getline(std::cin, query);
+
+                        if (!searchIndexBuilt) {
+                            Planner::indexAssignments(searchIndex, plan.assignments());
+                            searchIndexBuilt = true;
+                        }
+                        DisplayFunctions::displaySearchResults(plan.assignments(), searchIndex, query);
+                        break;
                     }
                 }
             } catch (const std::exception& e) {
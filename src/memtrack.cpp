@@ -0,0 +1,166 @@
+#include "../include/memtrack.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+namespace {
+    constexpr std::size_t TagCount = static_cast<std::size_t>(Planner::MemoryTag::Count);
+
+    // Marks blocks allocated while tracking was off; freeing them changes nothing
+    constexpr unsigned char Uncounted = 0xFF;
+
+    // Written in front of every block so a free knows its size and phase.
+    // Padded to max_align_t so the block after it stays suitably aligned.
+    struct alignas(std::max_align_t) BlockHeader {
+        std::size_t size;
+        unsigned char tag;
+    };
+
+    struct TagCounters {
+        std::atomic<std::uint64_t> allocations{0};
+        std::atomic<std::uint64_t> frees{0};
+        std::atomic<std::uint64_t> bytesAllocated{0};
+        std::atomic<std::int64_t> liveBytes{0};
+        std::atomic<std::int64_t> peakBytes{0};
+    };
+
+    // Plain constant-initialized statics: operator new may run before any
+    // dynamic initializer, so nothing here may need a constructor call
+    TagCounters counters[TagCount];
+    std::atomic<bool> enabled{false};
+    thread_local Planner::MemoryTag currentTag = Planner::MemoryTag::Untagged;
+
+#if PLANNER_MEMORY_TRACKING
+    void* allocate(std::size_t size) noexcept {
+        void* raw = std::malloc(sizeof(BlockHeader) + size);
+        if (!raw)
+            return nullptr;
+
+        auto* header = static_cast<BlockHeader*>(raw);
+        header->size = size;
+        header->tag = Uncounted;
+
+        if (enabled.load(std::memory_order_relaxed)) {
+            header->tag = static_cast<unsigned char>(currentTag);
+            TagCounters& tag = counters[header->tag];
+            tag.allocations.fetch_add(1, std::memory_order_relaxed);
+            tag.bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+
+            std::int64_t live = tag.liveBytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed) +
+                                static_cast<std::int64_t>(size);
+            std::int64_t peak = tag.peakBytes.load(std::memory_order_relaxed);
+            while (live > peak && !tag.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+            }
+        }
+        return header + 1;
+    }
+
+    void* allocateOrThrow(std::size_t size) {
+        for (;;) {
+            if (void* block = allocate(size))
+                return block;
+            std::new_handler handler = std::get_new_handler();
+            if (!handler)
+                throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    void release(void* block) noexcept {
+        if (!block)
+            return;
+
+        auto* header = static_cast<BlockHeader*>(block) - 1;
+        if (header->tag != Uncounted) {
+            TagCounters& tag = counters[header->tag];
+            tag.frees.fetch_add(1, std::memory_order_relaxed);
+            tag.liveBytes.fetch_sub(static_cast<std::int64_t>(header->size), std::memory_order_relaxed);
+        }
+        std::free(header);
+    }
+#endif
+}
+
+#if PLANNER_MEMORY_TRACKING
+// Over-aligned new keeps the standard library's own implementation; only
+// the ordinary forms below are accounted for.
+void* operator new(std::size_t size) { return allocateOrThrow(size); }
+void* operator new[](std::size_t size) { return allocateOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void operator delete(void* block) noexcept { release(block); }
+void operator delete[](void* block) noexcept { release(block); }
+void operator delete(void* block, std::size_t) noexcept { release(block); }
+void operator delete[](void* block, std::size_t) noexcept { release(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { release(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { release(block); }
+#endif
+
+void Planner::startMemoryTracking() {
+    enabled.store(false, std::memory_order_relaxed);
+    for (TagCounters& tag : counters) {
+        tag.allocations.store(0, std::memory_order_relaxed);
+        tag.frees.store(0, std::memory_order_relaxed);
+        tag.bytesAllocated.store(0, std::memory_order_relaxed);
+        tag.liveBytes.store(0, std::memory_order_relaxed);
+        tag.peakBytes.store(0, std::memory_order_relaxed);
+    }
+    enabled.store(PLANNER_MEMORY_TRACKING != 0, std::memory_order_relaxed);
+}
+
+void Planner::stopMemoryTracking() {
+    enabled.store(false, std::memory_order_relaxed);
+}
+
+bool Planner::memoryTrackingEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+Planner::MemoryUsage Planner::memoryUsage(MemoryTag tag) {
+    const TagCounters& counter = counters[static_cast<std::size_t>(tag)];
+    MemoryUsage usage;
+    usage.allocations = counter.allocations.load(std::memory_order_relaxed);
+    usage.frees = counter.frees.load(std::memory_order_relaxed);
+    usage.bytesAllocated = counter.bytesAllocated.load(std::memory_order_relaxed);
+    usage.liveBytes = counter.liveBytes.load(std::memory_order_relaxed);
+    usage.peakBytes = counter.peakBytes.load(std::memory_order_relaxed);
+    return usage;
+}
+
+const char* Planner::memoryTagName(MemoryTag tag) {
+    switch (tag) {
+        case MemoryTag::Load: return "load";
+        case MemoryTag::Schedule: return "schedule";
+        case MemoryTag::Ics: return "ics";
+        case MemoryTag::Save: return "save";
+        case MemoryTag::Display: return "display";
+        default: return "other";
+    }
+}
+
+void Planner::writeMemoryReport(std::ostream& output) {
+    output << std::left << std::setw(10) << "Phase" << std::right << std::setw(14) << "Allocations"
+           << std::setw(16) << "Bytes" << std::setw(14) << "Peak bytes" << std::setw(14) << "Live bytes" << "\n";
+    if (!PLANNER_MEMORY_TRACKING) {
+        output << "(heap accounting not built in; configure with -DPLANNER_MEMORY_TRACKING=ON)\n";
+        return;
+    }
+    for (std::size_t i = 0; i < TagCount; ++i) {
+        MemoryTag tag = static_cast<MemoryTag>(i);
+        MemoryUsage usage = memoryUsage(tag);
+        if (usage.allocations == 0)
+            continue;
+        output << std::left << std::setw(10) << memoryTagName(tag) << std::right << std::setw(14) << usage.allocations
+               << std::setw(16) << usage.bytesAllocated << std::setw(14) << usage.peakBytes << std::setw(14)
+               << usage.liveBytes << "\n";
+    }
+}
+
+Planner::MemoryScope::MemoryScope(MemoryTag tag) : previous(currentTag) {
+    currentTag = tag;
+}
+
+Planner::MemoryScope::~MemoryScope() {
+    currentTag = previous;
+}
@@ -0,0 +1,245 @@
+#include "../include/persistence.hpp"
+#include "../include/calendar.hpp"
+#include "../include/trace.hpp"
+#include "../include/memtrack.hpp"
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <iterator>
+#include <pthread.h>
+
+namespace {
+    // Wait until ready() holds. Timed waits only: condition_variable::wait
+    // needs GLIBCXX_3.4.30, which older runtime libstdc++ builds lack.
+    template <typename Predicate>
+    void waitUntilReady(std::condition_variable& condition, std::unique_lock<std::mutex>& lock, Predicate ready) {
+        while (!ready())
+            condition.wait_for(lock, std::chrono::hours(1));
+    }
+}
+
+Planner::PersistenceWriter::PersistenceWriter(UserDatabase& database, std::chrono::milliseconds coalesceWindow)
+    : database(database), coalesceWindow(coalesceWindow) {
+    // The thread inherits a mask with every signal blocked, so signals only
+    // ever reach the threads that expect them
+    sigset_t all, previous;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &previous);
+    thread = std::thread(&PersistenceWriter::run, this);
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+}
+
+Planner::PersistenceWriter::~PersistenceWriter() {
+    drain();
+}
+
+void Planner::PersistenceWriter::savePlan(const std::string& userName, const AssignmentStore& assignments) {
+    // Copy before locking; the thread then owns the snapshot outright
+    PlanChange change;
+    change.snapshot = std::make_unique<AssignmentStore>();
+    change.snapshot->setEpochDay(assignments.epochDay());
+    for (AssignmentHandle handle : assignments.handles())
+        change.snapshot->emplace(assignments[handle]);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (stopped) {
+        lock.unlock();
+        attempt(userName, [&] { return writePlan(userName, change); });
+        return;
+    }
+
+    bool wasEmpty = queueEmpty();
+    bool merged = plans.count(userName) != 0;
+    plans[userName] = std::move(change);
+    queued(wasEmpty, merged);
+}
+
+void Planner::PersistenceWriter::appendToPlan(const std::string& userName, const PlanSummary& summary,
+                                              std::vector<Assignment> added) {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto found = plans.find(userName);
+    if (stopped || found == plans.end()) {
+        PlanChange change;
+        change.summary = summary;
+        change.added = std::move(added);
+        if (stopped) {
+            lock.unlock();
+            attempt(userName, [&] { return writePlan(userName, change); });
+            return;
+        }
+        bool wasEmpty = queueEmpty();
+        plans.emplace(userName, std::move(change));
+        queued(wasEmpty, false);
+        return;
+    }
+
+    // Fold into the queued change: a snapshot takes the new assignments
+    // itself, queued additions grow by them
+    PlanChange& change = found->second;
+    if (change.snapshot) {
+        change.snapshot->rebase(today());
+        for (const Assignment& assignment : added)
+            change.snapshot->emplace(assignment);
+    } else {
+        change.summary = summary;
+        change.added.insert(change.added.end(), std::make_move_iterator(added.begin()),
+                            std::make_move_iterator(added.end()));
+    }
+    queued(false, true);
+}
+
+void Planner::PersistenceWriter::submit(const std::string& key, std::function<bool()> write) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (stopped) {
+        lock.unlock();
+        attempt(key, write);
+        return;
+    }
+
+    bool wasEmpty = queueEmpty();
+    bool merged = files.count(key) != 0;
+    files[key] = std::move(write);
+    queued(wasEmpty, merged);
+}
+
+void Planner::PersistenceWriter::queued(bool wasEmpty, bool merged) {
+    if (merged)
+        ++coalesced;
+    if (wasEmpty)
+        burstStart = std::chrono::steady_clock::now();
+    wake.notify_one();
+}
+
+void Planner::PersistenceWriter::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    ++waiters;
+    wake.notify_one(); // Someone is waiting: cut the burst window short
+    waitUntilReady(idle, lock, [this] { return stopped || (!writing && queueEmpty()); });
+    --waiters;
+}
+
+bool Planner::PersistenceWriter::drain() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        wake.notify_one();
+    }
+    // Exit paths may race to drain; only one joins, the others wait for it
+    std::call_once(joined, [this] {
+        if (thread.joinable())
+            thread.join();
+    });
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return errors.empty();
+}
+
+std::vector<std::string> Planner::PersistenceWriter::takeErrors() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> taken;
+    taken.swap(errors);
+    return taken;
+}
+
+std::size_t Planner::PersistenceWriter::writeCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return writes;
+}
+
+std::size_t Planner::PersistenceWriter::coalescedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return coalesced;
+}
+
+void Planner::PersistenceWriter::attempt(const std::string& what, const std::function<bool()>& write) {
+    // An escaping exception would end the thread and lose the rest of the queue
+    try {
+        record(write(), what);
+    } catch (const std::exception& e) {
+        record(false, what + ": " + e.what());
+    }
+}
+
+void Planner::PersistenceWriter::record(bool ok, const std::string& what) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++writes;
+    if (!ok)
+        errors.push_back("Could not save " + what);
+}
+
+bool Planner::PersistenceWriter::writePlan(const std::string& userName, const PlanChange& change) {
+    PLANNER_TRACE_SCOPE("persistPlan");
+    PLANNER_MEMORY_SCOPE(Save);
+    if (change.snapshot)
+        return database.write(userName, formatPlanRecord(*change.snapshot));
+
+    // Appending to a partly read record would overwrite the plan
+    std::string record;
+    if (!database.read(userName, record) && database.contains(userName))
+        return false;
+    return database.write(userName, appendPlanRecord(record, change.summary, change.added));
+}
+
+void Planner::PersistenceWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        waitUntilReady(wake, lock, [this] { return stopping || !queueEmpty(); });
+        if (queueEmpty())
+            break; // Stopping with nothing left to write
+
+        // Hold the burst open so follow-up changes fold into it, unless
+        // the program is waiting for it
+        wake.wait_until(lock, burstStart + coalesceWindow, [this] { return stopping || waiters > 0; });
+
+        std::map<std::string, PlanChange> takenPlans;
+        std::map<std::string, std::function<bool()>> takenFiles;
+        takenPlans.swap(plans);
+        takenFiles.swap(files);
+        writing = true;
+        lock.unlock();
+
+        for (const auto& entry : takenPlans)
+            attempt(entry.first, [&] { return writePlan(entry.first, entry.second); });
+        for (const auto& [key, write] : takenFiles)
+            attempt(key, write);
+
+        lock.lock();
+        writing = false;
+        if (queueEmpty())
+            idle.notify_all();
+    }
+
+    stopped = true;
+    idle.notify_all();
+}
+
+Planner::SignalDrain::SignalDrain(PersistenceWriter& writer) {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &signals, &previousMask);
+
+    // A plain thread takes the signal, so draining needs no signal-safe code
+    thread = std::thread([this, &writer, signals] {
+        int signal = 0;
+        if (sigwait(&signals, &signal) != 0 || stopping.load())
+            return;
+
+        bool ok = writer.drain();
+        for (const std::string& error : writer.takeErrors())
+            std::cerr << "Error: " << error << "\n";
+        std::cerr << "\nInterrupted; " << (ok ? "every change was saved.\n" : "some changes were not saved.\n");
+        std::_Exit(128 + signal);
+    });
+}
+
+Planner::SignalDrain::~SignalDrain() {
+    // Wake the thread with one of its own signals, aimed at it alone
+    stopping.store(true);
+    pthread_kill(thread.native_handle(), SIGHUP);
+    thread.join();
+    pthread_sigmask(SIG_SETMASK, &previousMask, nullptr);
+}
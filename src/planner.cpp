@@ -1,36 +1,48 @@
 #include "../include/planner.hpp"
 #include "../include/json.hpp"
+#include "../include/simulation.hpp"
+#include "../include/icsexport.hpp"
+#include "../include/icstext.hpp"
+#include "../include/trace.hpp"
+#include "../include/memtrack.hpp"
+#include "../include/gzipstream.hpp"
 #include <iostream>
 #include <fstream>
-#include <queue>
+#include <filesystem>
 #include <algorithm>
 #include <iterator>
+#include <memory>
 #include <iomanip>
 #include <ctime>
 #include <sstream>
+#include <utility>
 
 // Use the nlohmann JSON namespace
 using json = nlohmann::json;
 
-// Implementation of loadFromFile
-std::vector<Planner::AssignmentPtr> Planner::loadFromFile(const std::string& filename) {
-    std::vector<AssignmentPtr> assignments;
-
-    // Open the file
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << " for reading.\n";
-        return assignments; // Return an empty vector
-    }
+// Parse a saved plan from a stream or from text already in memory
+template <typename Input>
+static Planner::AssignmentStore parseAssignments(Input&& input) {
+    Planner::AssignmentStore assignments;
 
     try {
         // Parse the JSON file
         json jsonData;
-        file >> jsonData;
+        {
+            PLANNER_TRACE_SCOPE("parseJson");
+            jsonData = json::parse(std::forward<Input>(input));
+        }
+
+        // Legacy files are a bare array with deadlines relative to today
+        const json* records = &jsonData;
+        if (jsonData.is_object()) {
+            assignments.setEpochDay(jsonData.at("epoch").get<int>());
+            records = &jsonData.at("assignments");
+        }
 
         // Convert JSON objects to Assignment instances
-        for (const auto& obj : jsonData) {
-            auto assignment = std::make_shared<Assignment>(
+        for (const auto& obj : *records) {
+            assignments.emplace(
                 obj.at("subject").get<std::string>(),
                 obj.at("name").get<std::string>(),
                 obj.at("deadline").get<int>(),
@@ -40,16 +52,93 @@ std::vector<Planner::AssignmentPtr> Planner::loadFromFile(const std::string& fil
                 obj.at("group_work").get<bool>(),
                 obj.at("group_size").get<int>()
             );
-
-            assignments.push_back(assignment);
         }
     } catch (const json::exception& e) {
         std::cerr << "Error: Failed to parse JSON - " << e.what() << "\n";
     }
 
+    // Count deadlines from today so stored due dates never go stale
+    assignments.rebase(Planner::today());
     return assignments;
 }
 
+// Reads a string in place, for parsers that take a stream
+class StringViewBuffer : public std::streambuf {
+public:
+    explicit StringViewBuffer(const std::string& text) {
+        char* begin = const_cast<char*>(text.data());
+        setg(begin, begin, begin + text.size());
+    }
+};
+
+// Write the saved form of a plan, its epoch and every assignment, one
+// assignment at a time instead of building the whole document first. The
+// text is exactly what json::dump(4) gives, keys in sorted order.
+static void writeAssignments(std::ostream& output, const Planner::AssignmentStore& assignments) {
+    output << "{\n    \"assignments\": [";
+    const char* separator = "\n";
+    for (Planner::AssignmentHandle handle : assignments.handles()) {
+        const Assignment& assignment = assignments[handle];
+        output << separator << "        {\n"
+               << "            \"deadline\": " << assignment.getDeadline() << ",\n"
+               << "            \"duration\": " << assignment.getDuration() << ",\n"
+               << "            \"group_size\": " << assignment.getGroupSize() << ",\n"
+               << "            \"group_work\": " << (assignment.isGroupWork() ? "true" : "false") << ",\n"
+               << "            \"name\": " << json(assignment.getName()).dump() << ",\n"
+               << "            \"size\": " << assignment.getSize() << ",\n"
+               << "            \"subject\": " << json(assignment.getSubject()).dump() << ",\n"
+               << "            \"weight\": " << json(assignment.getWeight()).dump() << "\n"
+               << "        }";
+        separator = ",\n";
+    }
+
+    // Deadlines are stored as day numbers from the persisted plan epoch
+    output << (assignments.empty() ? "]" : "\n    ]") << ",\n    \"epoch\": " << assignments.epochDay() << "\n}";
+}
+
+// Implementation of loadFromFile
+Planner::AssignmentStore Planner::loadFromFile(const std::string& filename) {
+    PLANNER_TRACE_SCOPE("loadFromFile");
+    PLANNER_MEMORY_SCOPE(Load);
+
+    // Open the file; gzip-compressed files are inflated as they are parsed
+    InputFile file(filename);
+    if (!file.isOpen()) {
+        std::cerr << "Error: Could not open file " << filename << " for reading.\n";
+        return AssignmentStore(); // Return an empty store
+    }
+
+    AssignmentStore assignments = parseAssignments(file.stream());
+    if (file.failed())
+        std::cerr << "Error: " << filename << " is truncated or corrupt.\n";
+    return assignments;
+}
+
+
+Planner::AssignmentStore Planner::parsePlanFile(const std::string& contents) {
+    PLANNER_TRACE_SCOPE("parsePlanFile");
+    PLANNER_MEMORY_SCOPE(Load);
+    if (!isGzipData(contents))
+        return parseAssignments(contents);
+
+    // Inflated as it is parsed, without a second copy of the file
+    StringViewBuffer source(contents);
+    GzipInputBuffer gzip(&source);
+    std::istream input(&gzip);
+    AssignmentStore assignments = parseAssignments(input);
+    if (gzip.failed())
+        std::cerr << "Error: Compressed plan is truncated or corrupt.\n";
+    return assignments;
+}
+
+std::string Planner::formatPlanFile(const AssignmentStore& assignments) {
+    PLANNER_TRACE_SCOPE("formatPlanFile");
+    PLANNER_MEMORY_SCOPE(Save);
+    std::ostringstream contents;
+    writeAssignments(contents, assignments);
+    return contents.str();
+}
+
 void Planner::addToICSFile(const std::string& icsFilePath, const std::string& assignmentName, int dayOffset, int hour) {
     std::ofstream icsFile(icsFilePath, std::ios::app);
 
@@ -64,7 +153,7 @@ void Planner::addToICSFile(const std::string& icsFilePath, const std::string& as
 
     // Add the day offset and set the event start and end times
     timeInfo->tm_mday += dayOffset;
-    timeInfo->tm_hour = 18 + hour;  // Start time: 6 PM + scheduled hour
+    timeInfo->tm_hour = DefaultStudyStartHour + hour;  // Start time: 6 PM + scheduled hour
     timeInfo->tm_min = 0;
     timeInfo->tm_sec = 0;
     std::time_t startTime = std::mktime(timeInfo);
@@ -78,163 +167,183 @@ void Planner::addToICSFile(const std::string& icsFilePath, const std::string& as
     std::strftime(endBuffer, sizeof(endBuffer), "%Y%m%dT%H%M%S", std::localtime(&endTime));
 
     // Write the event details to the ICS file
-    icsFile << "BEGIN:VEVENT\n";
-    icsFile << "SUMMARY:" << assignmentName << "\n";
-    icsFile << "DTSTART:" << startBuffer << "\n";
-    icsFile << "DTEND:" << endBuffer << "\n";
-    icsFile << "DESCRIPTION:Scheduled Assignment\n";
-    icsFile << "STATUS:CONFIRMED\n";
-    icsFile << "END:VEVENT\n";
+    writeContentLine(icsFile, "BEGIN", "VEVENT");
+    writeContentLine(icsFile, "SUMMARY", escapeText(assignmentName));
+    writeContentLine(icsFile, "DTSTART", startBuffer);
+    writeContentLine(icsFile, "DTEND", endBuffer);
+    writeContentLine(icsFile, "DESCRIPTION", "Scheduled Assignment");
+    writeContentLine(icsFile, "STATUS", "CONFIRMED");
+    writeContentLine(icsFile, "END", "VEVENT");
 
     icsFile.close();
 }
 
-void Planner::saveToFile(const std::string& filename, const std::vector<AssignmentPtr>& assignments) {
-    std::ofstream file(filename, std::ios::trunc); // Open file in truncate mode to overwrite existing data
-    if (!file.is_open()) {
+void Planner::saveToFile(const std::string& filename, const AssignmentStore& assignments) {
+    PLANNER_TRACE_SCOPE("saveToFile");
+    PLANNER_MEMORY_SCOPE(Save);
+    OutputFile file(filename); // Truncates; a .gz name is written compressed
+    if (!file.isOpen()) {
         std::cerr << "Error: Could not open file " << filename << " for writing.\n";
         return;
     }
 
-    nlohmann::json jsonData;
-
-    // Serialize each assignment into JSON format
-    for (const auto& assignment : assignments) {
-        jsonData.push_back({
-            {"subject", assignment->getSubject()},
-            {"name", assignment->getName()},
-            {"deadline", assignment->getDeadline()},
-            {"duration", assignment->getDuration()},
-            {"weight", assignment->getWeight()},
-            {"size", assignment->getSize()},
-            {"group_work", assignment->isGroupWork()},
-            {"group_size", assignment->getGroupSize()}
-        });
-    }
-
-    // Write JSON data to file
-    file << jsonData.dump(4); // Pretty print with 4-space indentation
-    file.close();
+    // Stream JSON data to file, pretty printed with 4-space indentation,
+    // without building the whole text or document in memory first
+    writeAssignments(file.stream(), assignments);
+    if (!file.close())
+        std::cerr << "Error: Failed writing " << filename << "\n";
 }
 
 
 // Helper function to calculate priority
 int Planner::calculatePriority(const Assignment& assignment, int studyHoursPerDay) {
-    int remainingHours = assignment.getDeadline() * studyHoursPerDay;
+    return calculatePriority(assignment.getDeadline(), assignment.getRealDuration(),
+                             assignment.getWeight(), assignment.getSize(), studyHoursPerDay);
+}
+
+int Planner::calculatePriority(int deadline, int realDuration, float weight, int size, int studyHoursPerDay) {
+    int remainingHours = deadline * studyHoursPerDay;
     int priority = 0;
 
     // Add priority based on deadline
-    if (assignment.getDeadline() < 2)
+    if (deadline < 2)
         priority += 10;
-    else if (assignment.getDeadline() < 4)
+    else if (deadline < 4)
         priority += 8;
-    else if (assignment.getDeadline() < 6)
+    else if (deadline < 6)
         priority += 6;
-    else if (assignment.getDeadline() < 8)
+    else if (deadline < 8)
         priority += 4;
 
     // Add priority based on remaining time
-    if ((remainingHours - assignment.getRealDuration()) < 2)
+    if ((remainingHours - realDuration) < 2)
         priority += 20;
-    else if ((remainingHours - assignment.getRealDuration()) < 4)
+    else if ((remainingHours - realDuration) < 4)
         priority += 15;
-    else if ((remainingHours - assignment.getRealDuration()) < 6)
+    else if ((remainingHours - realDuration) < 6)
         priority += 10;
 
     // Add priority based on weight
-    if (assignment.getWeight() > 20)
+    if (weight > 20)
         priority += 6;
-    else if (assignment.getWeight() > 15)
+    else if (weight > 15)
         priority += 4;
-    else if (assignment.getWeight() > 10)
+    else if (weight > 10)
         priority += 2;
 
     // Add priority based on size
-    if (assignment.getSize() == 1)
+    if (size == 1)
         priority += 3;
-    else if (assignment.getSize() == 2)
+    else if (size == 2)
         priority += 2;
-    else if (assignment.getSize() == 3)
+    else if (size == 3)
         priority += 1;
 
     return priority;
 }
 
-// Scheduler implementation using a priority queue
-void Planner::scheduler(const std::vector<AssignmentPtr>& assignments, int weekdayStudyHours, int weekendStudyHours, const std::string& userName) {
-    // Define the ICS file path based on the user name
-    std::string icsFilePath = "Data/" + userName + "_schedule.ics";
-
-    // Ensure the ICS file starts with a proper calendar header
-    std::ofstream icsFile(icsFilePath, std::ios::trunc);
-    if (icsFile.is_open()) {
-        icsFile << "BEGIN:VCALENDAR\n";
-        icsFile << "VERSION:2.0\n";
-        icsFile << "PRODID:-//Planner App//EN\n";
-        icsFile.close();
-    } else {
-        std::cerr << "Error: Could not create ICS file.\n";
-        return;
-    }
+// Print a simulated plan day by day
+static void printPlan(const Planner::AssignmentStore& assignments, const Planner::SchedulePlan& plan, int days) {
+    PLANNER_TRACE_SCOPE("printPlan");
+    PLANNER_MEMORY_SCOPE(Display);
+    const auto& handles = assignments.handles();
+    auto slot = plan.slots.begin();
+    auto missed = plan.missed.begin();
 
-    std::vector<AssignmentPtr> assignmentList(assignments);
-    int day = 1;
-
-    while (!assignmentList.empty()) {
+    for (int day = 1; day <= days; ++day) {
         std::cout << "\nDay " << day << ":\n";
-        int studyHours = (day % 6 == 0 || day % 7 == 0) ? weekendStudyHours : weekdayStudyHours;
-        auto compare = [](const AssignmentPtr& a, const AssignmentPtr& b) {
-            return a->getPriority() < b->getPriority();
-        };
-        std::priority_queue<AssignmentPtr, std::vector<AssignmentPtr>, decltype(compare)> priorityQueue(compare);
-
-        for (const auto& assignment : assignmentList) {
-            int priority = calculatePriority(*assignment, studyHours);
-            assignment->setPriority(priority);
-            priorityQueue.push(assignment);
-        }
 
-        for (int i = 0; i < studyHours; ++i) {
-            if (priorityQueue.empty())
-                break;
+        for (; slot != plan.slots.end() && slot->day == day; ++slot) {
+            std::cout << "Hour " << (slot->hour + 1) << ": " << assignments[handles[slot->assignment]].getName() << "\n";
+        }
 
-            auto currentAssignment = priorityQueue.top();
-            priorityQueue.pop();
+        for (; missed != plan.missed.end() && missed->day == day; ++missed) {
+            std::cout << "Missed deadline for assignment: " << assignments[handles[missed->assignment]].getName() << "\n";
+        }
+    }
+}
 
-            std::cout << "Hour " << (i + 1) << ": " << currentAssignment->getName() << "\n";
-            currentAssignment->decreaseDuration(1);
+// Simulate a plan starting today on a private working array; the
+// caller's assignments are never modified
+static Planner::ScheduleStats simulateFromToday(const Planner::AssignmentStore& assignments, int weekdayStudyHours,
+                                                int weekendStudyHours, Planner::SchedulerEngine engine,
+                                                const Planner::Availability* availability, const Planner::CapacityTable* capacity,
+                                                Planner::SchedulePlan& plan) {
+    auto items = Planner::makeWorkItems(assignments, availability);
+    Planner::ScheduleOptions options;
+    options.weekdayStudyHours = weekdayStudyHours;
+    options.weekendStudyHours = weekendStudyHours;
+    options.engine = engine;
+    options.availability = availability;
+    options.capacity = capacity;
+    options.startDay = Planner::today();
+    return Planner::simulate(items, options, &plan);
+}
 
-            // Add the scheduled assignment to the ICS file
-            addToICSFile(icsFilePath, currentAssignment->getName(), day, i);
+// Scheduler implementation on top of the simulation engines
+void Planner::scheduler(const AssignmentStore& assignments, int weekdayStudyHours, int weekendStudyHours, const std::string& userName,
+                        SchedulerEngine engine, const Availability* availability, CalendarOutput output,
+                        const CapacityTable* capacity, bool compress) {
+    PLANNER_TRACE_SCOPE("scheduler");
+    PLANNER_MEMORY_SCOPE(Schedule);
+    // Define the ICS file path based on the user name
+    std::string icsFilePath = "Data/" + userName + "_schedule.ics";
+    std::string compressedSuffix;
+    if (compress || std::filesystem::exists(icsFilePath + ".gz"))
+        compressedSuffix = ".gz";
+    icsFilePath += compressedSuffix;
 
-            if (currentAssignment->getRealDuration() <= 0) {
-                auto it = std::find(assignmentList.begin(), assignmentList.end(), currentAssignment);
-                if (it != assignmentList.end())
-                    assignmentList.erase(it);
-            } else {
-                currentAssignment->setPriority(calculatePriority(*currentAssignment, studyHours));
-                priorityQueue.push(currentAssignment);
-            }
-        }
+    SchedulePlan plan;
+    auto stats = simulateFromToday(assignments, weekdayStudyHours, weekendStudyHours, engine, availability, capacity, plan);
+    printPlan(assignments, plan, stats.days);
 
-        for (auto it = assignmentList.begin(); it != assignmentList.end();) {
-            (*it)->decreaseDeadline(1);
-            if ((*it)->getDeadline() <= 0) {
-                std::cout << "Missed deadline for assignment: " << (*it)->getName() << "\n";
-                it = assignmentList.erase(it);
-            } else {
-                ++it;
-            }
-        }
+    // Compare with the previous run so unchanged events keep their sequence
+    auto events = planEvents(assignments, plan, today());
+    auto delta = diffCalendar(events, readCalendarFeed(icsFilePath), calendarTimestamp());
 
-        ++day;
+    OutputFile icsFile(icsFilePath);
+    if (!icsFile.isOpen()) {
+        std::cerr << "Error: Could not create ICS file.\n";
+        return;
     }
-
-    // Add the ICS footer
-    icsFile.open(icsFilePath, std::ios::app);
-    if (icsFile.is_open()) {
-        icsFile << "END:VCALENDAR\n";
-        icsFile.close();
+    writeCalendar(icsFile.stream(), events, delta.revision);
+    if (!icsFile.close())
+        std::cerr << "Error: Failed writing ICS file.\n";
+
+    if (output == CalendarOutput::Delta) {
+        OutputFile deltaFile("Data/" + userName + "_schedule_delta.ics" + compressedSuffix);
+        if (!deltaFile.isOpen()) {
+            std::cerr << "Error: Could not create ICS delta file.\n";
+            return;
+        }
+        writeCalendarDelta(deltaFile.stream(), delta);
+        if (!deltaFile.close())
+            std::cerr << "Error: Failed writing ICS delta file.\n";
     }
 }
 
+std::string Planner::scheduleCalendar(const AssignmentStore& assignments, int weekdayStudyHours, int weekendStudyHours,
+                                      SchedulerEngine engine, const std::string& previousFeed, const Availability* availability,
+                                      const CapacityTable* capacity) {
+    PLANNER_TRACE_SCOPE("scheduleCalendar");
+    PLANNER_MEMORY_SCOPE(Schedule);
+    SchedulePlan plan;
+    simulateFromToday(assignments, weekdayStudyHours, weekendStudyHours, engine, availability, capacity, plan);
+
+    // The previous feed is read in place, inflated on the way if compressed
+    StringViewBuffer source(previousFeed);
+    std::unique_ptr<GzipInputBuffer> gzip;
+    if (isGzipData(previousFeed))
+        gzip = std::make_unique<GzipInputBuffer>(&source);
+    std::istream previous(gzip ? static_cast<std::streambuf*>(gzip.get()) : &source);
+    auto previousEvents = readCalendarFeed(previous);
+    if (gzip && gzip->failed())
+        std::cerr << "Error: Previous calendar feed is truncated or corrupt.\n";
+
+    auto events = planEvents(assignments, plan, today());
+    auto delta = diffCalendar(events, previousEvents, calendarTimestamp());
+
+    std::ostringstream feed;
+    writeCalendar(feed, events, delta.revision);
+    return feed.str();
+}
@@ -0,0 +1,342 @@
+#include "../include/simulation.hpp"
+#include "../include/groupslots.hpp"
+#include "../include/trace.hpp"
+#include "../include/memtrack.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+int Planner::studyHoursForDay(int day, int weekdayStudyHours, int weekendStudyHours) {
+    return (day % 6 == 0 || day % 7 == 0) ? weekendStudyHours : weekdayStudyHours;
+}
+
+// Build the working state from the user's assignments. Due days are
+// counted from today, which is day 0 of the simulation.
+std::vector<Planner::WorkItem> Planner::makeWorkItems(const AssignmentStore& assignments, const Availability* availability) {
+    PLANNER_TRACE_SCOPE("makeWorkItems");
+    PLANNER_MEMORY_SCOPE(Schedule);
+    std::vector<WorkItem> items;
+    items.reserve(assignments.size());
+    const int elapsed = today() - assignments.epochDay();
+
+    for (AssignmentHandle handle : assignments.handles()) {
+        const Assignment& assignment = assignments[handle];
+        items.push_back({assignment.getRealDuration(), assignment.getDeadline() - elapsed, 0,
+                         assignment.getWeight(), assignment.getSize()});
+
+        const int reserved = availability ? reservedGroupHours(assignment, *availability) : 0;
+        if (reserved > 0) {
+            WorkItem& item = items.back();
+            item.remainingHours = std::max(item.remainingHours - reserved, 0);
+            item.covered = item.remainingHours == 0;
+        }
+    }
+
+    return items;
+}
+
+namespace {
+    using Planner::WorkItem;
+
+    // Heap entry carrying its own score so comparisons stay in cache
+    struct HeapEntry {
+        int score;
+        std::uint32_t index;
+    };
+
+    // Orders by score only, exactly like the scheduler's priority_queue
+    bool lowerScore(const HeapEntry& a, const HeapEntry& b) {
+        return a.score < b.score;
+    }
+
+    // Heap entry keyed on the due day
+    struct DeadlineEntry {
+        int deadline;
+        std::uint32_t index;
+    };
+
+    // Min-heap order on due day, ties broken by insertion order
+    bool laterDeadline(const DeadlineEntry& a, const DeadlineEntry& b) {
+        return a.deadline != b.deadline ? a.deadline > b.deadline : a.index > b.index;
+    }
+
+    // Study hours of each simulated day and the clock hours they start at.
+    // Without an availability every day starts at the default study hour.
+    class DayCapacity {
+    public:
+        explicit DayCapacity(const Planner::ScheduleOptions& options) : options(options) {}
+
+        int hoursFor(int day) {
+            int budget = Planner::studyHoursForDay(day, options);
+            if (!options.availability)
+                return budget;
+            return options.availability->freeStudyHours(options.startDay + day, budget, freeHours);
+        }
+
+        int startHour(int hour) const {
+            return options.availability ? freeHours[hour] : Planner::DefaultStudyStartHour + hour;
+        }
+
+    private:
+        const Planner::ScheduleOptions& options;
+        std::vector<int> freeHours;
+    };
+
+    // Min-heap of every item by the last day it can be worked on. Day 1 is
+    // always available, even for assignments that are already due.
+    std::vector<DeadlineEntry> makeDeadlineHeap(const std::vector<WorkItem>& items) {
+        std::vector<DeadlineEntry> heap;
+        heap.reserve(items.size());
+        for (std::uint32_t i = 0; i < items.size(); ++i) {
+            if (!items[i].covered)
+                heap.push_back({std::max(items[i].dueDay, 1), i});
+        }
+        std::make_heap(heap.begin(), heap.end(), laterDeadline);
+        return heap;
+    }
+
+}
+
+// An engine's state between simulated days
+class Planner::DayEngine {
+public:
+    virtual ~DayEngine() = default;
+
+    // True once nothing is left to schedule
+    virtual bool finished() const = 0;
+
+    // Simulate the next day, adding to stats and, if given, to plan
+    virtual void step(ScheduleStats& stats, SchedulePlan* plan) = 0;
+};
+
+namespace {
+    // Priority ladder. Every day each open assignment is rescored and queued,
+    // and each hour goes to the highest score. The heap is driven with the
+    // same push order and comparator as the original priority_queue loop,
+    // so ties are broken exactly as before. Expiry pops a deadline min-heap,
+    // so only assignments due that day are touched at the end of a day.
+    class PriorityEngine final : public Planner::DayEngine {
+    public:
+        PriorityEngine(std::vector<WorkItem>& items, const Planner::ScheduleOptions& options)
+            : items(items), capacity(options), active(items.size()), closed(items.size(), 0), open(items.size()),
+              deadlines(makeDeadlineHeap(items)) {
+            // Indices of assignments still in play, kept in insertion order
+            // and compacted lazily while rescoring
+            for (std::uint32_t i = 0; i < active.size(); ++i) {
+                active[i] = i;
+                if (items[i].covered) {
+                    closed[i] = 1;
+                    --open;
+                }
+            }
+            heap.reserve(items.size());
+        }
+
+        bool finished() const override { return open == 0; }
+
+        void step(Planner::ScheduleStats& stats, Planner::SchedulePlan* plan) override {
+            PLANNER_TRACE_SCOPE("day");
+            int studyHours = capacity.hoursFor(day);
+
+            {
+                PLANNER_TRACE_SCOPE("rescore");
+                heap.clear();
+                std::size_t kept = 0;
+                for (std::uint32_t index : active) {
+                    if (closed[index])
+                        continue;
+                    active[kept++] = index;
+
+                    WorkItem& item = items[index];
+                    item.score = Planner::calculatePriority(item.dueDay - day + 1, item.remainingHours, item.weight, item.size, studyHours);
+                    heap.push_back({item.score, index});
+                    std::push_heap(heap.begin(), heap.end(), lowerScore);
+                }
+                active.resize(kept);
+            }
+
+            for (int i = 0; i < studyHours; ++i) {
+                if (heap.empty())
+                    break;
+
+                std::pop_heap(heap.begin(), heap.end(), lowerScore);
+                std::uint32_t current = heap.back().index;
+                heap.pop_back();
+
+                WorkItem& item = items[current];
+                item.remainingHours -= 1;
+                ++stats.scheduledHours;
+                if (plan)
+                    plan->slots.push_back({current, day, i, capacity.startHour(i)});
+
+                if (item.remainingHours > 0) {
+                    item.score = Planner::calculatePriority(item.dueDay - day + 1, item.remainingHours, item.weight, item.size, studyHours);
+                    heap.push_back({item.score, current});
+                    std::push_heap(heap.begin(), heap.end(), lowerScore);
+                } else {
+                    closed[current] = 1;
+                    --open;
+                }
+            }
+
+            // Only assignments due today are touched
+            while (!deadlines.empty() && deadlines.front().deadline <= day) {
+                std::uint32_t index = deadlines.front().index;
+                std::pop_heap(deadlines.begin(), deadlines.end(), laterDeadline);
+                deadlines.pop_back();
+                if (closed[index])
+                    continue;
+
+                ++stats.missedDeadlines;
+                stats.totalLateness += items[index].remainingHours;
+                if (plan)
+                    plan->missed.push_back({index, day});
+                closed[index] = 1;
+                --open;
+            }
+
+            stats.days = day++;
+        }
+
+    private:
+        std::vector<WorkItem>& items;
+        DayCapacity capacity;
+        std::vector<std::uint32_t> active;
+        std::vector<char> closed;
+        std::size_t open;
+        std::vector<DeadlineEntry> deadlines;
+        std::vector<HeapEntry> heap;
+        int day = 1;
+    };
+
+    // Earliest deadline first. Each hour goes to the open assignment due
+    // soonest, at O(log n) per slot. Assignments that pass their deadline
+    // are counted as missed but still finished, oldest deadline first,
+    // which is what minimizes the maximum lateness.
+    class EarliestDeadlineEngine final : public Planner::DayEngine {
+    public:
+        EarliestDeadlineEngine(std::vector<WorkItem>& items, const Planner::ScheduleOptions& options)
+            : items(items), capacity(options), heap(makeDeadlineHeap(items)),
+              canWork(options.weekdayStudyHours > 0 || options.weekendStudyHours > 0) {}
+
+        bool finished() const override {
+            return heap.empty() && !(canWork && !late.empty() && idleDays < MaxIdleDays);
+        }
+
+        void step(Planner::ScheduleStats& stats, Planner::SchedulePlan* plan) override {
+            int studyHours = capacity.hoursFor(day);
+            idleDays = studyHours > 0 ? 0 : idleDays + 1;
+
+            for (int i = 0; i < studyHours; ++i) {
+                bool fromLate = !late.empty();
+                if (!fromLate && heap.empty())
+                    break;
+
+                std::uint32_t current = fromLate ? late.front() : heap.front().index;
+                WorkItem& item = items[current];
+                item.remainingHours -= 1;
+                ++stats.scheduledHours;
+                if (plan)
+                    plan->slots.push_back({current, day, i, capacity.startHour(i)});
+
+                if (item.remainingHours <= 0) {
+                    if (fromLate) {
+                        stats.maxLateness = std::max(stats.maxLateness, day - std::max(item.dueDay, 1));
+                        late.pop_front();
+                    } else {
+                        std::pop_heap(heap.begin(), heap.end(), laterDeadline);
+                        heap.pop_back();
+                    }
+                }
+            }
+
+            // Only assignments due today are touched
+            while (!heap.empty() && heap.front().deadline <= day) {
+                std::uint32_t index = heap.front().index;
+                std::pop_heap(heap.begin(), heap.end(), laterDeadline);
+                heap.pop_back();
+
+                ++stats.missedDeadlines;
+                stats.totalLateness += items[index].remainingHours;
+                if (plan)
+                    plan->missed.push_back({index, day});
+                late.push_back(index);
+            }
+
+            stats.days = day++;
+        }
+
+    private:
+        // Give up on late work after a year without a single free hour
+        static constexpr int MaxIdleDays = 366;
+
+        std::vector<WorkItem>& items;
+        DayCapacity capacity;
+        std::vector<DeadlineEntry> heap;
+        std::deque<std::uint32_t> late; // Overdue assignments in deadline order; they always come first
+        const bool canWork;
+        int idleDays = 0;
+        int day = 1;
+    };
+
+    template <typename Engine>
+    Planner::ScheduleStats run(Engine engine, Planner::SchedulePlan* plan) {
+        Planner::ScheduleStats stats;
+        while (!engine.finished())
+            engine.step(stats, plan);
+        return stats;
+    }
+
+    std::unique_ptr<Planner::DayEngine> makeEngine(std::vector<WorkItem>& items, const Planner::ScheduleOptions& options) {
+        if (options.engine == Planner::SchedulerEngine::EarliestDeadline)
+            return std::make_unique<EarliestDeadlineEngine>(items, options);
+        return std::make_unique<PriorityEngine>(items, options);
+    }
+}
+
+Planner::ScheduleStats Planner::simulate(std::vector<WorkItem>& items, int weekdayStudyHours, int weekendStudyHours,
+                                         SchedulerEngine engine, SchedulePlan* plan) {
+    ScheduleOptions options;
+    options.weekdayStudyHours = weekdayStudyHours;
+    options.weekendStudyHours = weekendStudyHours;
+    options.engine = engine;
+    return simulate(items, options, plan);
+}
+
+Planner::ScheduleStats Planner::simulate(std::vector<WorkItem>& items, const ScheduleOptions& options, SchedulePlan* plan) {
+    PLANNER_MEMORY_SCOPE(Schedule);
+    if (options.engine == SchedulerEngine::EarliestDeadline) {
+        PLANNER_TRACE_SCOPE("simulateEarliestDeadline");
+        return run(EarliestDeadlineEngine(items, options), plan);
+    }
+    PLANNER_TRACE_SCOPE("simulatePriority");
+    return run(PriorityEngine(items, options), plan);
+}
+
+Planner::ScheduleGenerator::ScheduleGenerator(std::vector<WorkItem> items, const ScheduleOptions& options)
+    : items(std::move(items)), options(options) {
+    PLANNER_MEMORY_SCOPE(Schedule);
+    engine = makeEngine(this->items, this->options);
+}
+
+Planner::ScheduleGenerator::ScheduleGenerator(const AssignmentStore& assignments, const ScheduleOptions& options)
+    : ScheduleGenerator(makeWorkItems(assignments, options.availability), options) {}
+
+Planner::ScheduleGenerator::~ScheduleGenerator() = default;
+
+bool Planner::ScheduleGenerator::done() const {
+    return engine->finished();
+}
+
+bool Planner::ScheduleGenerator::next(ScheduleDay& day) {
+    PLANNER_MEMORY_SCOPE(Schedule);
+    day.slots.clear();
+    day.missed.clear();
+    if (engine->finished())
+        return false;
+
+    engine->step(totals, &day);
+    day.day = totals.days;
+    return true;
+}
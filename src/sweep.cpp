@@ -0,0 +1,94 @@
+#include "../include/sweep.hpp"
+#include "../include/trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+int Planner::weeklyStudyHours(int weekdayStudyHours, int weekendStudyHours) {
+    return 5 * weekdayStudyHours + 2 * weekendStudyHours;
+}
+
+namespace {
+    // Simulate every cell of the grid in parallel with simulateCell(items, cell)
+    template <typename SimulateCell>
+    Planner::SweepResult runSweep(const std::vector<Planner::WorkItem>& baseItems, int maxWeekdayHours,
+                                  int maxWeekendHours, unsigned threadCount, SimulateCell simulateCell) {
+        using namespace Planner;
+        SweepResult result;
+        if (maxWeekdayHours < 1 || maxWeekendHours < 1)
+            return result;
+
+        for (int weekday = 1; weekday <= maxWeekdayHours; ++weekday) {
+            for (int weekend = 1; weekend <= maxWeekendHours; ++weekend) {
+                result.cells.push_back({weekday, weekend, ScheduleStats{}});
+            }
+        }
+
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        threadCount = std::min<unsigned>(threadCount, static_cast<unsigned>(result.cells.size()));
+
+        std::atomic<std::size_t> nextCell{0};
+        auto worker = [&]() {
+            std::vector<WorkItem> items;
+            items.reserve(baseItems.size());
+
+            for (std::size_t cell = nextCell++; cell < result.cells.size(); cell = nextCell++) {
+                PLANNER_TRACE_SCOPE("sweepCell");
+                SweepCell& current = result.cells[cell];
+                items = baseItems;
+                current.stats = simulateCell(items, current);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned i = 1; i < threadCount; ++i)
+            threads.emplace_back(worker);
+        worker();
+        for (auto& thread : threads)
+            thread.join();
+
+        // Cheapest budget with zero misses, preferring fewer weekday hours on ties
+        for (std::size_t cell = 0; cell < result.cells.size(); ++cell) {
+            const SweepCell& current = result.cells[cell];
+            if (current.stats.missedDeadlines != 0)
+                continue;
+
+            if (result.cheapest < 0 ||
+                weeklyStudyHours(current.weekdayStudyHours, current.weekendStudyHours) <
+                    weeklyStudyHours(result.cells[result.cheapest].weekdayStudyHours,
+                                     result.cells[result.cheapest].weekendStudyHours)) {
+                result.cheapest = static_cast<int>(cell);
+            }
+        }
+
+        return result;
+    }
+}
+
+Planner::SweepResult Planner::sweepStudyHours(const AssignmentStore& assignments, int maxWeekdayHours,
+                                              int maxWeekendHours, SchedulerEngine engine, unsigned threadCount) {
+    PLANNER_TRACE_SCOPE("sweepStudyHours");
+    // Every run starts from a private copy of this state
+    return runSweep(makeWorkItems(assignments), maxWeekdayHours, maxWeekendHours, threadCount,
+                    [engine](std::vector<WorkItem>& items, const SweepCell& cell) {
+                        return simulate(items, cell.weekdayStudyHours, cell.weekendStudyHours, engine);
+                    });
+}
+
+Planner::SweepResult Planner::sweepStudyHours(const AssignmentStore& assignments, int maxWeekdayHours,
+                                              int maxWeekendHours, const ScheduleOptions& options,
+                                              const std::vector<Holiday>& holidays, int horizon,
+                                              unsigned threadCount) {
+    PLANNER_TRACE_SCOPE("sweepStudyHours");
+    return runSweep(makeWorkItems(assignments, options.availability), maxWeekdayHours, maxWeekendHours, threadCount,
+                    [&](std::vector<WorkItem>& items, const SweepCell& cell) {
+                        CapacityTable capacity = calendarCapacity(options.startDay, cell.weekdayStudyHours,
+                                                                  cell.weekendStudyHours, holidays, horizon);
+                        ScheduleOptions cellOptions = options;
+                        cellOptions.weekdayStudyHours = cell.weekdayStudyHours;
+                        cellOptions.weekendStudyHours = cell.weekendStudyHours;
+                        cellOptions.capacity = &capacity;
+                        return simulate(items, cellOptions);
+                    });
+}
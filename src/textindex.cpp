@@ -0,0 +1,315 @@
+#include "../include/textindex.hpp"
+#include "../include/trace.hpp"
+#include "../include/memtrack.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <string_view>
+
+namespace {
+    // Lists this many times longer than the candidates are not decoded;
+    // checking each candidate's text is cheaper
+    constexpr std::size_t IntersectRatio = 16;
+
+    // Between the fields of a text; fragments never contain it, so neither
+    // trigrams nor substring checks reach across fields
+    constexpr char FieldSeparator = '\0';
+
+    std::string lowercase(const std::string& text) {
+        std::string lower(text);
+        for (char& c : lower)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return lower;
+    }
+
+    // Lowercase with a space on each side, so the first and last letters
+    // start and end trigrams of their own
+    std::string normalise(const std::string& text) {
+        return " " + lowercase(text) + " ";
+    }
+
+    std::uint32_t trigramAt(const std::string& text, std::size_t at) {
+        return static_cast<std::uint32_t>(static_cast<unsigned char>(text[at])) << 16 |
+               static_cast<std::uint32_t>(static_cast<unsigned char>(text[at + 1])) << 8 |
+               static_cast<unsigned char>(text[at + 2]);
+    }
+
+    // Distinct trigrams of a text, sorted
+    std::vector<std::uint32_t> trigramsOf(const std::string& text) {
+        std::vector<std::uint32_t> trigrams;
+        for (std::size_t at = 0; at + 3 <= text.size(); ++at) {
+            if (text[at] != FieldSeparator && text[at + 1] != FieldSeparator && text[at + 2] != FieldSeparator)
+                trigrams.push_back(trigramAt(text, at));
+        }
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+        return trigrams;
+    }
+}
+
+void Planner::TextIndex::PostingList::append(std::uint32_t id) {
+    if (count > 0 && id <= last) {
+        // Out of order, such as a reused id: rebuild the list around it
+        std::vector<std::uint32_t> ids = decode();
+        auto at = std::lower_bound(ids.begin(), ids.end(), id);
+        if (at == ids.end() || *at != id)
+            ids.insert(at, id);
+        assign(ids);
+        return;
+    }
+
+    std::uint32_t delta = id - (count > 0 ? last : 0);
+    while (delta >= 0x80) {
+        bytes.push_back(static_cast<std::uint8_t>(delta | 0x80));
+        delta >>= 7;
+    }
+    bytes.push_back(static_cast<std::uint8_t>(delta));
+    last = id;
+    ++count;
+}
+
+std::vector<std::uint32_t> Planner::TextIndex::PostingList::decode() const {
+    std::vector<std::uint32_t> ids;
+    ids.reserve(count);
+    std::uint32_t value = 0;
+    const std::uint8_t* at = bytes.data();
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::uint32_t delta = 0;
+        int shift = 0;
+        while (*at & 0x80) {
+            delta |= static_cast<std::uint32_t>(*at++ & 0x7f) << shift;
+            shift += 7;
+        }
+        delta |= static_cast<std::uint32_t>(*at++) << shift;
+        value += delta;
+        ids.push_back(value);
+    }
+    return ids;
+}
+
+void Planner::TextIndex::PostingList::assign(const std::vector<std::uint32_t>& ids) {
+    bytes.clear();
+    count = 0;
+    last = 0;
+    for (std::uint32_t id : ids)
+        append(id);
+}
+
+bool Planner::TextIndex::contains(std::uint32_t id) const {
+    return id < documents.size() && documents[id].state == State::Live;
+}
+
+bool Planner::TextIndex::containsText(std::uint32_t id, const std::string& fragment) const {
+    if (!contains(id))
+        return false;
+    std::string_view text(arena.data() + documents[id].start, documents[id].length);
+    return text.find(fragment) != std::string_view::npos;
+}
+
+void Planner::TextIndex::add(std::uint32_t id, const std::string& text) {
+    addNormalised(id, normalise(text));
+}
+
+void Planner::TextIndex::add(std::uint32_t id, const std::vector<std::string>& fields) {
+    std::string normalised;
+    for (const std::string& field : fields) {
+        if (!normalised.empty())
+            normalised += FieldSeparator;
+        normalised += normalise(field);
+    }
+    addNormalised(id, normalised);
+}
+
+void Planner::TextIndex::addNormalised(std::uint32_t id, const std::string& normalised) {
+    PLANNER_MEMORY_SCOPE(Display);
+    if (id < documents.size() && documents[id].state != State::Absent) {
+        if (documents[id].state == State::Live)
+            --live;
+        else
+            --removed;
+        unlink(id);
+    }
+    if (id >= documents.size())
+        documents.resize(static_cast<std::size_t>(id) + 1);
+
+    documents[id] = {static_cast<std::uint32_t>(arena.size()), static_cast<std::uint32_t>(normalised.size()), State::Live};
+    arena += normalised;
+    ++live;
+
+    for (std::uint32_t trigram : trigramsOf(normalised))
+        postings[trigram].append(id);
+}
+
+void Planner::TextIndex::remove(std::uint32_t id) {
+    if (!contains(id))
+        return;
+    documents[id].state = State::Removed;
+    --live;
+    ++removed;
+
+    // Dropping removed ids costs a pass over every list, so wait for a batch
+    if (removed >= 64 && removed * 4 > live)
+        compact();
+}
+
+void Planner::TextIndex::unlink(std::uint32_t id) {
+    for (std::uint32_t trigram : trigramsOf(textOf(id))) {
+        auto list = postings.find(trigram);
+        if (list == postings.end())
+            continue;
+        std::vector<std::uint32_t> ids = list->second.decode();
+        ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+        if (ids.empty())
+            postings.erase(list);
+        else
+            list->second.assign(ids);
+    }
+    documents[id].state = State::Absent;
+}
+
+void Planner::TextIndex::compact() {
+    PLANNER_TRACE_SCOPE("compactTextIndex");
+    PLANNER_MEMORY_SCOPE(Display);
+    for (auto list = postings.begin(); list != postings.end();) {
+        std::vector<std::uint32_t> ids = list->second.decode();
+        ids.erase(std::remove_if(ids.begin(), ids.end(), [&](std::uint32_t id) { return !contains(id); }), ids.end());
+        if (ids.empty()) {
+            list = postings.erase(list);
+        } else {
+            list->second.assign(ids);
+            ++list;
+        }
+    }
+
+    // Removed and replaced texts leave gaps in the arena
+    std::string packed;
+    packed.reserve(arena.size());
+    for (Document& document : documents) {
+        if (document.state != State::Live) {
+            document = Document();
+            continue;
+        }
+        std::uint32_t start = static_cast<std::uint32_t>(packed.size());
+        packed.append(arena, document.start, document.length);
+        document.start = start;
+    }
+    arena.swap(packed);
+    removed = 0;
+}
+
+std::vector<std::uint32_t> Planner::TextIndex::search(const std::string& fragment) const {
+    PLANNER_TRACE_SCOPE("textSearch");
+    PLANNER_MEMORY_SCOPE(Display);
+    std::vector<std::uint32_t> matches;
+    const std::string needle = lowercase(fragment);
+
+    if (needle.size() < 3) {
+        for (std::uint32_t id = 0; id < documents.size(); ++id) {
+            if (containsText(id, needle))
+                matches.push_back(id);
+        }
+        return matches;
+    }
+
+    // Every trigram of the fragment must be in the text; start from the rarest
+    std::vector<const PostingList*> lists;
+    for (std::uint32_t trigram : trigramsOf(needle)) {
+        auto list = postings.find(trigram);
+        if (list == postings.end())
+            return matches;
+        lists.push_back(&list->second);
+    }
+    std::sort(lists.begin(), lists.end(), [](const PostingList* a, const PostingList* b) { return a->count < b->count; });
+
+    std::vector<std::uint32_t> candidates = lists.front()->decode();
+    for (std::size_t i = 1; i < lists.size() && lists[i]->count <= candidates.size() * IntersectRatio; ++i) {
+        std::vector<std::uint32_t> ids = lists[i]->decode();
+        std::vector<std::uint32_t> both;
+        std::set_intersection(candidates.begin(), candidates.end(), ids.begin(), ids.end(), std::back_inserter(both));
+        candidates.swap(both);
+    }
+
+    // Trigrams can all be present without the fragment being there in one piece
+    for (std::uint32_t id : candidates) {
+        if (containsText(id, needle))
+            matches.push_back(id);
+    }
+    return matches;
+}
+
+std::vector<Planner::TextMatch> Planner::TextIndex::searchFuzzy(const std::string& query, std::size_t limit) const {
+    PLANNER_TRACE_SCOPE("textSearchFuzzy");
+    PLANNER_MEMORY_SCOPE(Display);
+    std::vector<TextMatch> matches;
+    const std::string padded = normalise(query);
+    std::vector<std::uint32_t> trigrams = trigramsOf(padded);
+    if (trigrams.empty() || limit == 0)
+        return matches;
+
+    // A text sharing need of q trigrams has at least one of any q - need + 1
+    // of them, so only the rarest q - need + 1 lists are read
+    const int need = static_cast<int>(trigrams.size() + 2) / 3;
+    auto countOf = [&](std::uint32_t trigram) {
+        auto list = postings.find(trigram);
+        return list == postings.end() ? 0u : list->second.count;
+    };
+    std::vector<std::uint32_t> rarest(trigrams);
+    std::sort(rarest.begin(), rarest.end(), [&](std::uint32_t a, std::uint32_t b) { return countOf(a) < countOf(b); });
+    rarest.resize(trigrams.size() - static_cast<std::size_t>(need) + 1);
+
+    std::vector<std::uint32_t> candidates;
+    for (std::uint32_t trigram : rarest) {
+        auto list = postings.find(trigram);
+        if (list == postings.end())
+            continue;
+        std::vector<std::uint32_t> ids = list->second.decode();
+        candidates.insert(candidates.end(), ids.begin(), ids.end());
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    for (std::uint32_t id : candidates) {
+        if (!contains(id))
+            continue;
+        std::string_view text(arena.data() + documents[id].start, documents[id].length);
+        int score = 0;
+        for (std::uint32_t trigram : trigrams) {
+            const char piece[3] = {static_cast<char>(trigram >> 16), static_cast<char>(trigram >> 8), static_cast<char>(trigram)};
+            score += text.find(std::string_view(piece, 3)) != std::string_view::npos;
+        }
+        if (score >= need)
+            matches.push_back({id, score});
+    }
+
+    auto better = [&](const TextMatch& a, const TextMatch& b) {
+        if (a.score != b.score)
+            return a.score > b.score;
+        if (documents[a.id].length != documents[b.id].length)
+            return documents[a.id].length < documents[b.id].length;
+        return a.id < b.id;
+    };
+    if (matches.size() > limit) {
+        std::partial_sort(matches.begin(), matches.begin() + static_cast<std::ptrdiff_t>(limit), matches.end(), better);
+        matches.resize(limit);
+    } else {
+        std::sort(matches.begin(), matches.end(), better);
+    }
+    return matches;
+}
+
+std::size_t Planner::TextIndex::postingBytes() const {
+    std::size_t bytes = 0;
+    for (const auto& list : postings)
+        bytes += list.second.bytes.size();
+    return bytes;
+}
+
+std::vector<std::string> Planner::searchableFields(const Assignment& assignment) {
+    return {assignment.getName(), assignment.getSubject()};
+}
+
+void Planner::indexAssignments(TextIndex& index, const AssignmentStore& assignments) {
+    PLANNER_TRACE_SCOPE("indexAssignments");
+    for (AssignmentHandle handle : assignments.handles())
+        index.add(handle, searchableFields(assignments[handle]));
+}
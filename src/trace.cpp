@@ -0,0 +1,115 @@
+#include "../include/trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    struct TraceEvent {
+        const char* name;
+        std::int64_t start; // Nanoseconds on the steady clock
+        std::int64_t end;
+    };
+
+    // One per thread. Only its owner appends, so recording takes no lock;
+    // the registry keeps it alive after the thread exits.
+    struct ThreadBuffer {
+        int threadId;
+        std::vector<TraceEvent> events;
+    };
+
+    std::atomic<bool> enabled{false};
+    std::atomic<std::uint64_t> generation{0}; // Bumped by startTracing to retire old buffers
+
+    std::mutex registryMutex; // Taken once per thread and per start, never per span
+    std::vector<std::shared_ptr<ThreadBuffer>> registry;
+    int nextThreadId = 1;
+
+    ThreadBuffer& localBuffer() {
+        thread_local std::shared_ptr<ThreadBuffer> buffer;
+        thread_local std::uint64_t bufferGeneration = 0;
+
+        std::uint64_t current = generation.load(std::memory_order_acquire);
+        if (!buffer || bufferGeneration != current) {
+            auto fresh = std::make_shared<ThreadBuffer>();
+            fresh->events.reserve(4096);
+
+            std::lock_guard<std::mutex> lock(registryMutex);
+            fresh->threadId = nextThreadId++;
+            registry.push_back(fresh);
+            buffer = std::move(fresh);
+            bufferGeneration = current;
+        }
+        return *buffer;
+    }
+}
+
+void Planner::startTracing() {
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.clear();
+        nextThreadId = 1;
+    }
+    generation.fetch_add(1, std::memory_order_acq_rel);
+    enabled.store(true, std::memory_order_release);
+}
+
+void Planner::stopTracing() {
+    enabled.store(false, std::memory_order_release);
+}
+
+bool Planner::tracingEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+std::size_t Planner::traceEventCount() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::size_t count = 0;
+    for (const auto& buffer : registry)
+        count += buffer->events.size();
+    return count;
+}
+
+std::int64_t Planner::TraceSpan::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Planner::TraceSpan::record(const char* name, std::int64_t start, std::int64_t end) {
+    localBuffer().events.push_back({name, start, end});
+}
+
+bool Planner::writeTrace(const std::string& filename) {
+    std::FILE* file = std::fopen(filename.c_str(), "w");
+    if (!file)
+        return false;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    // Timestamps are made relative to the first span so they stay readable
+    std::int64_t origin = INT64_MAX;
+    for (const auto& buffer : registry) {
+        for (const TraceEvent& event : buffer->events)
+            origin = std::min(origin, event.start);
+    }
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    bool first = true;
+    for (const auto& buffer : registry) {
+        std::fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+                     first ? "" : ",", buffer->threadId, buffer->threadId);
+        first = false;
+
+        // Span names are identifiers from the code, so they need no escaping
+        for (const TraceEvent& event : buffer->events) {
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                         event.name, buffer->threadId, (event.start - origin) / 1000.0, (event.end - event.start) / 1000.0);
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+
+    bool ok = std::ferror(file) == 0;
+    return std::fclose(file) == 0 && ok;
+}
@@ -0,0 +1,631 @@
+#include "../include/userdatabase.hpp"
+#include "../include/gzipstream.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+    using Planner::UserDatabase;
+
+    constexpr char Magic[8] = {'P', 'L', 'A', 'N', 'D', 'B', '0', '2'};
+    constexpr char LegacyMagic[8] = {'P', 'L', 'A', 'N', 'D', 'B', '0', '1'};
+
+    // Page 0 holds two header slots; commits alternate between them, so a
+    // torn slot write leaves the other one intact
+    constexpr std::size_t SlotSize = 128;
+
+    // Node pages: type, entry count, link, then fixed-size entries
+    constexpr unsigned char LeafType = 1;
+    constexpr unsigned char InnerType = 2;
+    constexpr std::size_t NodeHeaderSize = 8;
+    constexpr std::size_t KeySize = UserDatabase::MaxUserNameLength + 1;
+    constexpr std::size_t LeafEntrySize = KeySize + 4 + 8;
+    constexpr std::size_t InnerEntrySize = KeySize + 4;
+    constexpr std::size_t MaxLeafEntries = (UserDatabase::PageSize - NodeHeaderSize) / LeafEntrySize;
+    constexpr std::size_t MaxInnerEntries = (UserDatabase::PageSize - NodeHeaderSize) / InnerEntrySize;
+
+    // Data pages: next page of the chain, bytes used, then the bytes
+    constexpr std::size_t DataHeaderSize = 8;
+    constexpr std::size_t DataCapacity = UserDatabase::PageSize - DataHeaderSize;
+
+    // Free list pages: next page of the list, entries used, then page numbers
+    constexpr std::size_t ListHeaderSize = 8;
+    constexpr std::size_t ListCapacity = (UserDatabase::PageSize - ListHeaderSize) / 4;
+
+    // Little-endian fields, so a database moves between machines as is
+    void put32(unsigned char* at, std::uint32_t value) {
+        for (int i = 0; i < 4; ++i)
+            at[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+
+    void put64(unsigned char* at, std::uint64_t value) {
+        for (int i = 0; i < 8; ++i)
+            at[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+
+    std::uint32_t get32(const unsigned char* at) {
+        std::uint32_t value = 0;
+        for (int i = 3; i >= 0; --i)
+            value = (value << 8) | at[i];
+        return value;
+    }
+
+    std::uint64_t get64(const unsigned char* at) {
+        std::uint64_t value = 0;
+        for (int i = 7; i >= 0; --i)
+            value = (value << 8) | at[i];
+        return value;
+    }
+
+    // FNV-1a, enough to tell a torn header slot from a whole one
+    std::uint32_t checksum(const unsigned char* data, std::size_t size) {
+        std::uint32_t hash = 2166136261u;
+        for (std::size_t i = 0; i < size; ++i)
+            hash = (hash ^ data[i]) * 16777619u;
+        return hash;
+    }
+
+    off_t pageOffset(std::uint32_t page) {
+        return static_cast<off_t>(page) * static_cast<off_t>(UserDatabase::PageSize);
+    }
+
+    bool readFully(int fd, unsigned char* buffer, std::size_t size, off_t offset) {
+        while (size > 0) {
+            ssize_t done = ::pread(fd, buffer, size, offset);
+            if (done < 0 && errno == EINTR)
+                continue;
+            if (done <= 0)
+                return false;
+            buffer += done;
+            size -= static_cast<std::size_t>(done);
+            offset += done;
+        }
+        return true;
+    }
+
+    bool writeFully(int fd, const unsigned char* buffer, std::size_t size, off_t offset) {
+        while (size > 0) {
+            ssize_t done = ::pwrite(fd, buffer, size, offset);
+            if (done < 0 && errno == EINTR)
+                continue;
+            if (done <= 0)
+                return false;
+            buffer += done;
+            size -= static_cast<std::size_t>(done);
+            offset += done;
+        }
+        return true;
+    }
+
+    bool validName(const std::string& userName) {
+        return !userName.empty() && userName.size() <= UserDatabase::MaxUserNameLength &&
+               userName.find('\0') == std::string::npos;
+    }
+}
+
+Planner::UserDatabase::UserDatabase(const std::string& filename) {
+    fd = ::open(filename.c_str(), O_RDWR);
+    if (fd < 0 && errno == ENOENT) {
+        // A new database: a blank header page and an empty root leaf
+        fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+        if (fd < 0) {
+            std::cerr << "Error: Could not create database " << filename << "\n";
+            return;
+        }
+        unsigned char blank[PageSize] = {};
+        writePage(0, blank);
+        pages = 1;
+        root = writeNode(Node());
+        open = commit();
+        return;
+    }
+    if (fd < 0)
+        return;
+
+    if (!readHeader()) {
+        std::cerr << "Error: " << filename << " is not a planner database.\n";
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+    open = true;
+}
+
+Planner::UserDatabase::~UserDatabase() {
+    if (fd >= 0)
+        ::close(fd);
+}
+
+void Planner::UserDatabase::readPage(std::uint32_t page, unsigned char* buffer) {
+    if (!readFully(fd, buffer, PageSize, pageOffset(page))) {
+        std::memset(buffer, 0, PageSize);
+        failed = true;
+    }
+}
+
+void Planner::UserDatabase::writePage(std::uint32_t page, const unsigned char* buffer) {
+    if (!writeFully(fd, buffer, PageSize, pageOffset(page)))
+        failed = true;
+}
+
+// The newest valid slot of the header page names the committed state
+bool Planner::UserDatabase::readHeader() {
+    unsigned char header[PageSize];
+    failed = false;
+    readPage(0, header);
+    if (failed)
+        return false;
+
+    bool found = false;
+    bool legacy = false;
+    for (std::size_t slot = 0; slot < 2; ++slot) {
+        const unsigned char* at = header + slot * SlotSize;
+        if (get32(at + 8) != PageSize)
+            continue;
+        Commit state;
+        state.root = get32(at + 12);
+        state.pages = get32(at + 16);
+        state.freeList = get32(at + 20);
+        state.users = get64(at + 24);
+        if (state.root == 0 || state.root >= state.pages || state.freeList >= state.pages)
+            continue;
+
+        if (std::memcmp(at, Magic, sizeof(Magic)) == 0 && get32(at + 44) == checksum(at, 44)) {
+            state.sequence = get64(at + 32);
+        } else if (slot == 0 && std::memcmp(at, LegacyMagic, sizeof(LegacyMagic)) == 0) {
+            state.sequence = 0; // Written before header slots, with a free list threaded through the pages
+        } else {
+            continue;
+        }
+        if (!found || state.sequence > committed.sequence) {
+            committed = state;
+            legacy = state.sequence == 0;
+            found = true;
+        }
+    }
+    if (!found)
+        return false;
+
+    root = committed.root;
+    pages = committed.pages;
+    users = committed.users;
+    return readFreeList(committed.freeList, legacy);
+}
+
+bool Planner::UserDatabase::readFreeList(std::uint32_t first, bool legacy) {
+    unsigned char buffer[PageSize];
+    for (std::uint32_t page = first; page != 0; page = get32(buffer)) {
+        if (page >= pages || listPages.size() + freePages.size() >= pages)
+            return false; // A cycle or a page past the end
+        readPage(page, buffer);
+        if (legacy) {
+            freePages.push_back(page);
+            continue;
+        }
+        listPages.push_back(page);
+        std::size_t count = std::min<std::size_t>(get32(buffer + 4), ListCapacity);
+        for (std::size_t i = 0; i < count; ++i)
+            freePages.push_back(get32(buffer + ListHeaderSize + 4 * i));
+    }
+    return !failed;
+}
+
+// Write the free list to free pages, make everything durable, then
+// publish the new state in the header slot the last commit did not use
+bool Planner::UserDatabase::commit() {
+    released.insert(released.end(), listPages.begin(), listPages.end());
+
+    std::vector<std::uint32_t> newList;
+    auto needed = [&] { return (freePages.size() + released.size() + ListCapacity - 1) / ListCapacity; };
+    while (newList.size() < needed())
+        newList.push_back(allocatePage());
+
+    std::vector<std::uint32_t> listed(freePages);
+    listed.insert(listed.end(), released.begin(), released.end());
+    unsigned char buffer[PageSize];
+    for (std::size_t i = 0; i < newList.size(); ++i) {
+        std::size_t offset = i * ListCapacity;
+        std::size_t count = std::min(ListCapacity, listed.size() - offset);
+        std::memset(buffer, 0, PageSize);
+        put32(buffer, i + 1 < newList.size() ? newList[i + 1] : 0);
+        put32(buffer + 4, static_cast<std::uint32_t>(count));
+        for (std::size_t j = 0; j < count; ++j)
+            put32(buffer + ListHeaderSize + 4 * j, listed[offset + j]);
+        writePage(newList[i], buffer);
+    }
+    if (failed || ::fsync(fd) != 0)
+        return false;
+
+    Commit next;
+    next.sequence = committed.sequence + 1;
+    next.root = root;
+    next.pages = pages;
+    next.freeList = newList.empty() ? 0 : newList.front();
+    next.users = users;
+
+    unsigned char slot[SlotSize] = {};
+    std::memcpy(slot, Magic, sizeof(Magic));
+    put32(slot + 8, PageSize);
+    put32(slot + 12, next.root);
+    put32(slot + 16, next.pages);
+    put32(slot + 20, next.freeList);
+    put64(slot + 24, next.users);
+    put64(slot + 32, next.sequence);
+    put32(slot + 44, checksum(slot, 44));
+    off_t at = static_cast<off_t>((next.sequence % 2) * SlotSize);
+    if (!writeFully(fd, slot, SlotSize, at) || ::fsync(fd) != 0)
+        return false;
+
+    committed = next;
+    listPages.swap(newList);
+    freePages.swap(listed);
+    taken.clear();
+    released.clear();
+    return true;
+}
+
+// Forget the write in progress; the last commit is still what the file holds
+void Planner::UserDatabase::rollback() {
+    freePages.insert(freePages.end(), taken.begin(), taken.end());
+    taken.clear();
+    released.clear();
+    root = committed.root;
+    pages = committed.pages;
+    users = committed.users;
+    failed = false;
+}
+
+Planner::UserDatabase::Node Planner::UserDatabase::readNode(std::uint32_t page) {
+    unsigned char buffer[PageSize];
+    readPage(page, buffer);
+
+    Node node;
+    node.leaf = buffer[0] == LeafType;
+    node.link = get32(buffer + 4);
+    std::size_t count = static_cast<std::size_t>(buffer[2]) | (static_cast<std::size_t>(buffer[3]) << 8);
+    std::size_t entrySize = node.leaf ? LeafEntrySize : InnerEntrySize;
+
+    node.entries.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const unsigned char* at = buffer + NodeHeaderSize + i * entrySize;
+        Entry& entry = node.entries[i];
+        entry.key.assign(reinterpret_cast<const char*>(at), strnlen(reinterpret_cast<const char*>(at), KeySize));
+        entry.page = get32(at + KeySize);
+        if (node.leaf)
+            entry.length = get64(at + KeySize + 4);
+    }
+    return node;
+}
+
+std::uint32_t Planner::UserDatabase::writeNode(const Node& node) {
+    unsigned char buffer[PageSize] = {};
+    buffer[0] = node.leaf ? LeafType : InnerType;
+    buffer[2] = static_cast<unsigned char>(node.entries.size());
+    buffer[3] = static_cast<unsigned char>(node.entries.size() >> 8);
+    put32(buffer + 4, node.link);
+
+    std::size_t entrySize = node.leaf ? LeafEntrySize : InnerEntrySize;
+    for (std::size_t i = 0; i < node.entries.size(); ++i) {
+        unsigned char* at = buffer + NodeHeaderSize + i * entrySize;
+        const Entry& entry = node.entries[i];
+        std::memcpy(at, entry.key.data(), entry.key.size());
+        put32(at + KeySize, entry.page);
+        if (node.leaf)
+            put64(at + KeySize + 4, entry.length);
+    }
+
+    std::uint32_t page = allocatePage();
+    writePage(page, buffer);
+    return page;
+}
+
+std::uint32_t Planner::UserDatabase::allocatePage() {
+    if (freePages.empty())
+        return pages++;
+
+    std::uint32_t page = freePages.back();
+    freePages.pop_back();
+    taken.push_back(page);
+    return page;
+}
+
+// Leaves in key order, found through the inner levels alone
+std::vector<std::uint32_t> Planner::UserDatabase::leafPages() {
+    std::vector<std::uint32_t> level{root};
+    for (;;) {
+        Node first = readNode(level.front());
+        if (first.leaf || failed)
+            return level;
+
+        std::vector<std::uint32_t> below;
+        for (std::size_t i = 0; i < level.size(); ++i) {
+            Node node = i == 0 ? first : readNode(level[i]);
+            below.push_back(node.link);
+            for (const Entry& entry : node.entries)
+                below.push_back(entry.page);
+        }
+        level.swap(below);
+    }
+}
+
+bool Planner::UserDatabase::find(const std::string& userName, Entry& entry) {
+    auto byKey = [](const std::string& key, const Entry& e) { return key < e.key; };
+
+    Node node = readNode(root);
+    while (!node.leaf) {
+        // The last separator not above the key leads to the child holding it
+        auto next = std::upper_bound(node.entries.begin(), node.entries.end(), userName, byKey);
+        node = readNode(next == node.entries.begin() ? node.link : std::prev(next)->page);
+    }
+
+    auto found = std::lower_bound(node.entries.begin(), node.entries.end(), userName,
+                                  [](const Entry& e, const std::string& key) { return e.key < key; });
+    if (found == node.entries.end() || found->key != userName)
+        return false;
+    entry = *found;
+    return true;
+}
+
+// Insert or replace an entry below page, writing every node on the way
+// down to a new page. Returns the copy of page, and its new right sibling
+// with the separator if it split.
+Planner::UserDatabase::Insertion Planner::UserDatabase::insert(std::uint32_t page, const Entry& entry) {
+    auto byKey = [](const std::string& key, const Entry& e) { return key < e.key; };
+    Node node = readNode(page);
+    releasePage(page);
+
+    if (node.leaf) {
+        auto at = std::lower_bound(node.entries.begin(), node.entries.end(), entry.key,
+                                   [](const Entry& e, const std::string& key) { return e.key < key; });
+        if (at != node.entries.end() && at->key == entry.key) {
+            *at = entry;
+        } else {
+            node.entries.insert(at, entry);
+            ++users;
+        }
+    } else {
+        auto next = std::upper_bound(node.entries.begin(), node.entries.end(), entry.key, byKey);
+        std::uint32_t& child = next == node.entries.begin() ? node.link : std::prev(next)->page;
+
+        Insertion below = insert(child, entry);
+        child = below.page;
+        if (below.right != 0) {
+            Entry separator;
+            separator.key = below.splitKey;
+            separator.page = below.right;
+            node.entries.insert(std::upper_bound(node.entries.begin(), node.entries.end(), separator.key, byKey), separator);
+        }
+    }
+
+    Insertion result;
+    if (node.entries.size() <= (node.leaf ? MaxLeafEntries : MaxInnerEntries)) {
+        result.page = writeNode(node);
+        return result;
+    }
+
+    // Split in half. A leaf copies its first key up; an inner node moves
+    // its middle key up.
+    std::size_t middle = node.entries.size() / 2;
+    Node right;
+    right.leaf = node.leaf;
+    if (node.leaf) {
+        right.entries.assign(node.entries.begin() + static_cast<std::ptrdiff_t>(middle), node.entries.end());
+        result.splitKey = right.entries.front().key;
+    } else {
+        result.splitKey = node.entries[middle].key;
+        right.link = node.entries[middle].page;
+        right.entries.assign(node.entries.begin() + static_cast<std::ptrdiff_t>(middle) + 1, node.entries.end());
+    }
+    node.entries.resize(middle);
+
+    result.page = writeNode(node);
+    result.right = writeNode(right);
+    return result;
+}
+
+// Write a record into a chain of free pages, releasing the pages of the
+// old chain. Returns the first page.
+std::uint32_t Planner::UserDatabase::writeChain(const std::string& record, std::uint32_t old) {
+    unsigned char buffer[PageSize];
+    for (std::uint32_t page = old; page != 0 && !failed; page = get32(buffer)) {
+        readPage(page, buffer);
+        releasePage(page);
+    }
+
+    std::vector<std::uint32_t> chain((record.size() + DataCapacity - 1) / DataCapacity);
+    for (std::uint32_t& page : chain)
+        page = allocatePage();
+
+    for (std::size_t i = 0; i < chain.size(); ++i) {
+        std::size_t offset = i * DataCapacity;
+        std::size_t used = std::min(DataCapacity, record.size() - offset);
+        std::memset(buffer, 0, PageSize);
+        put32(buffer, i + 1 < chain.size() ? chain[i + 1] : 0);
+        put32(buffer + 4, static_cast<std::uint32_t>(used));
+        std::memcpy(buffer + DataHeaderSize, record.data() + offset, used);
+        writePage(chain[i], buffer);
+    }
+    return chain.empty() ? 0 : chain.front();
+}
+
+// Bytes of a stored record, read from its chain a page at a time
+class Planner::UserDatabase::ChainBuffer : public std::streambuf {
+public:
+    ChainBuffer(UserDatabase& database, const Entry& entry)
+        : database(database), next(entry.page), remaining(entry.length) {}
+
+    // True if the record was stored gzip-compressed
+    bool compressed() {
+        if (traits_type::eq_int_type(sgetc(), traits_type::eof()) || egptr() - gptr() < 2)
+            return false;
+        return static_cast<unsigned char>(gptr()[0]) == 0x1f && static_cast<unsigned char>(gptr()[1]) == 0x8b;
+    }
+
+protected:
+    int_type underflow() override {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+        if (next == 0 || remaining == 0)
+            return traits_type::eof();
+
+        database.readPage(next, page);
+        next = get32(page);
+        std::size_t used = static_cast<std::size_t>(std::min<std::uint64_t>(
+            std::min<std::size_t>(get32(page + 4), DataCapacity), remaining));
+        remaining -= used;
+        char* data = reinterpret_cast<char*>(page + DataHeaderSize);
+        setg(data, data, data + used);
+        return used > 0 ? traits_type::to_int_type(*gptr()) : traits_type::eof();
+    }
+
+private:
+    UserDatabase& database;
+    std::uint32_t next;
+    std::uint64_t remaining;
+    unsigned char page[PageSize];
+};
+
+// A record as it was written, inflated on the way if it is stored compressed
+std::string Planner::UserDatabase::readRecord(const Entry& entry, char delimiter, bool stopAtDelimiter) {
+    ChainBuffer chain(*this, entry);
+    std::unique_ptr<GzipInputBuffer> gzip;
+    std::streambuf* source = &chain;
+    if (chain.compressed()) {
+        gzip = std::make_unique<GzipInputBuffer>(&chain);
+        source = gzip.get();
+    }
+
+    std::string record;
+    if (!stopAtDelimiter && !gzip)
+        record.reserve(entry.length);
+    char chunk[PageSize];
+    for (std::streamsize read; (read = source->sgetn(chunk, sizeof(chunk))) > 0;) {
+        if (stopAtDelimiter) {
+            if (const void* found = std::memchr(chunk, delimiter, static_cast<std::size_t>(read))) {
+                record.append(chunk, static_cast<const char*>(found) - chunk);
+                break;
+            }
+        }
+        record.append(chunk, static_cast<std::size_t>(read));
+    }
+    if (gzip && gzip->failed())
+        failed = true;
+    return record;
+}
+
+bool Planner::UserDatabase::contains(const std::string& userName) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    Entry entry;
+    failed = false;
+    return open && validName(userName) && find(userName, entry) && !failed;
+}
+
+bool Planner::UserDatabase::read(const std::string& userName, std::string& record) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    Entry entry;
+    failed = false;
+    if (!open || !validName(userName) || !find(userName, entry))
+        return false;
+    record = readRecord(entry);
+    return !failed;
+}
+
+bool Planner::UserDatabase::readPrefix(const std::string& userName, char delimiter, std::string& prefix) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    Entry entry;
+    failed = false;
+    if (!open || !validName(userName) || !find(userName, entry))
+        return false;
+    prefix = readRecord(entry, delimiter, true);
+    return !failed;
+}
+
+bool Planner::UserDatabase::isCompressed(const std::string& userName) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    Entry entry;
+    failed = false;
+    if (!open || !validName(userName) || !find(userName, entry))
+        return false;
+    return ChainBuffer(*this, entry).compressed();
+}
+
+bool Planner::UserDatabase::write(const std::string& userName, const std::string& record, bool compress) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (!open || !validName(userName))
+        return false;
+
+    failed = false;
+    Entry entry;
+    std::uint32_t old = 0;
+    if (find(userName, entry)) {
+        old = entry.page;
+        compress = compress || ChainBuffer(*this, entry).compressed();
+    }
+    const std::string stored = compress ? gzipCompress(record) : std::string();
+    entry.key = userName;
+    entry.page = writeChain(compress ? stored : record, old);
+    entry.length = compress ? stored.size() : record.size();
+
+    Insertion top = insert(root, entry);
+    root = top.page;
+    if (top.right != 0) {
+        // The root split: grow the tree by one level
+        Node newRoot;
+        newRoot.leaf = false;
+        newRoot.link = top.page;
+        Entry separator;
+        separator.key = top.splitKey;
+        separator.page = top.right;
+        newRoot.entries.push_back(separator);
+        root = writeNode(newRoot);
+    }
+
+    if (failed || !commit()) {
+        rollback();
+        return false;
+    }
+    return true;
+}
+
+void Planner::UserDatabase::forEachUser(const std::function<void(const std::string&, const std::string&)>& visit) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (!open)
+        return;
+
+    // A rewrite replaces only the leaf being visited, so the later leaves
+    // listed up front stay where they are
+    failed = false;
+    for (std::uint32_t page : leafPages()) {
+        Node node = readNode(page);
+        for (const Entry& entry : node.entries)
+            visit(entry.key, readRecord(entry));
+    }
+}
+
+std::vector<std::string> Planner::UserDatabase::userNames() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<std::string> names;
+    if (!open)
+        return names;
+
+    failed = false;
+    for (std::uint32_t page : leafPages()) {
+        for (const Entry& entry : readNode(page).entries)
+            names.push_back(entry.key);
+    }
+    return names;
+}
+
+std::uint64_t Planner::UserDatabase::userCount() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return users;
+}
+
+std::uint32_t Planner::UserDatabase::pageCount() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return pages;
+}
@@ -0,0 +1,171 @@
+#include "differential.hpp"
+#include "../include/calendar.hpp"
+#include <sstream>
+#include <utility>
+
+namespace {
+    // splitmix64, so a seed means the same case on every platform
+    class Random {
+    public:
+        explicit Random(std::uint64_t seed) : state(seed) {}
+
+        std::uint64_t next() {
+            std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        // Uniform integer in [low, high]
+        int between(int low, int high) {
+            return low + static_cast<int>(next() % static_cast<std::uint64_t>(high - low + 1));
+        }
+
+    private:
+        std::uint64_t state;
+    };
+
+    // Every way of making a case one step simpler, most drastic first
+    std::vector<Differential::Case> simplifications(const Differential::Case& testCase) {
+        std::vector<Differential::Case> candidates;
+        const std::size_t count = testCase.records.size();
+
+        // Drop halves, then quarters, ... then single assignments
+        for (std::size_t chunk = count / 2; chunk >= 1; chunk /= 2) {
+            for (std::size_t start = 0; start + chunk <= count; start += chunk) {
+                Differential::Case smaller = testCase;
+                smaller.records.erase(smaller.records.begin() + static_cast<std::ptrdiff_t>(start),
+                                      smaller.records.begin() + static_cast<std::ptrdiff_t>(start + chunk));
+                candidates.push_back(std::move(smaller));
+            }
+        }
+
+        // Move one number towards its simplest value
+        auto shrinkValue = [&candidates, &testCase](auto field, int simplest) {
+            Differential::Case simpler = testCase;
+            int& value = field(simpler);
+            if (value == simplest)
+                return;
+            for (int next : {simplest, simplest + (value - simplest) / 2, value + (value > simplest ? -1 : 1)}) {
+                if (next == value)
+                    continue;
+                Differential::Case candidate = testCase;
+                field(candidate) = next;
+                candidates.push_back(std::move(candidate));
+            }
+        };
+
+        shrinkValue([](Differential::Case& c) -> int& { return c.weekdayStudyHours; }, 0);
+        shrinkValue([](Differential::Case& c) -> int& { return c.weekendStudyHours; }, 0);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            shrinkValue([i](Differential::Case& c) -> int& { return c.records[i].deadline; }, 1);
+            shrinkValue([i](Differential::Case& c) -> int& { return c.records[i].duration; }, 1);
+            shrinkValue([i](Differential::Case& c) -> int& { return c.records[i].size; }, 1);
+            shrinkValue([i](Differential::Case& c) -> int& { return c.records[i].groupSize; }, 1);
+
+            const Differential::Record& record = testCase.records[i];
+            if (record.groupWork) {
+                Differential::Case candidate = testCase;
+                candidate.records[i].groupWork = false;
+                candidates.push_back(std::move(candidate));
+            }
+            if (record.weight != 0.0f) {
+                Differential::Case candidate = testCase;
+                candidate.records[i].weight = 0.0f;
+                candidates.push_back(std::move(candidate));
+                candidate = testCase;
+                candidate.records[i].weight = static_cast<float>(static_cast<int>(record.weight));
+                if (candidate.records[i].weight != record.weight)
+                    candidates.push_back(std::move(candidate));
+            }
+            if (record.subject != "S" || record.name != "A" + std::to_string(i)) {
+                Differential::Case candidate = testCase;
+                candidate.records[i].subject = "S";
+                candidate.records[i].name = "A" + std::to_string(i);
+                candidates.push_back(std::move(candidate));
+            }
+        }
+
+        return candidates;
+    }
+}
+
+Differential::Case Differential::randomCase(std::uint64_t seed, int maxRecords) {
+    static const char* subjects[] = {"Math", "Physics", "History", "Ünïcode Studies", "Quote \"Q\"", "Back\\slash", "Tab\tbed"};
+    Random random(seed);
+
+    Case testCase;
+    testCase.weekdayStudyHours = random.between(0, 8);
+    testCase.weekendStudyHours = random.between(0, 10);
+    testCase.engine = random.between(0, 1) ? Planner::SchedulerEngine::EarliestDeadline : Planner::SchedulerEngine::Priority;
+
+    int count = random.between(0, maxRecords);
+    for (int i = 0; i < count; ++i) {
+        Record record;
+        record.subject = subjects[random.between(0, 6)];
+        int variant = random.between(0, 9);
+        record.name = "Assignment " + std::to_string(i);
+        if (variant == 0)
+            record.name += " \"draft\"\n";
+        else if (variant == 1)
+            record.name += ", part 2; see \\notes for the long ünïcode title that needs folding ünïcode";
+        record.deadline = random.between(-3, 30);
+        record.duration = random.between(0, 25);
+        // Whole and half weights land on and around the 10/15/20 thresholds
+        record.weight = static_cast<float>(random.between(0, 60)) / 2.0f;
+        record.size = random.between(0, 4);
+        record.groupWork = random.between(0, 3) == 0;
+        record.groupSize = record.groupWork ? random.between(1, 6) : 1;
+        testCase.records.push_back(std::move(record));
+    }
+    return testCase;
+}
+
+void Differential::fillStore(const Case& testCase, Planner::AssignmentStore& assignments) {
+    assignments.setEpochDay(Planner::today());
+    for (const Record& record : testCase.records) {
+        assignments.emplace(record.subject, record.name, record.deadline, record.duration, record.weight, record.size,
+                            record.groupWork, record.groupSize);
+    }
+}
+
+std::string Differential::describe(const Case& testCase) {
+    std::ostringstream output;
+    output << "weekday " << testCase.weekdayStudyHours << ", weekend " << testCase.weekendStudyHours << ", engine "
+           << (testCase.engine == Planner::SchedulerEngine::EarliestDeadline ? "EarliestDeadline" : "Priority") << "\n";
+    for (const Record& record : testCase.records) {
+        output << "  emplace(\"" << record.subject << "\", \"" << record.name << "\", " << record.deadline << ", "
+               << record.duration << ", " << record.weight << "f, " << record.size << ", "
+               << (record.groupWork ? "true" : "false") << ", " << record.groupSize << ")\n";
+    }
+    return output.str();
+}
+
+Differential::Case Differential::shrink(Case failing, const Check& check) {
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (Case& candidate : simplifications(failing)) {
+            if (!check(candidate).empty()) {
+                failing = std::move(candidate);
+                progress = true;
+                break;
+            }
+        }
+    }
+    return failing;
+}
+
+std::string Differential::run(const Check& check, std::uint64_t seed, int count, int maxRecords) {
+    for (int i = 0; i < count; ++i) {
+        std::uint64_t caseSeed = seed + static_cast<std::uint64_t>(i);
+        Case testCase = randomCase(caseSeed, maxRecords);
+        if (check(testCase).empty())
+            continue;
+
+        Case minimal = shrink(testCase, check);
+        return "seed " + std::to_string(caseSeed) + " fails; minimal case:\n" + describe(minimal) + check(minimal);
+    }
+    return "";
+}
@@ -0,0 +1,55 @@
+#ifndef DIFFERENTIAL_HPP
+#define DIFFERENTIAL_HPP
+
+#include "../include/planner.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Randomized differential testing: seeded synthetic cases are fed to a
+// reference and an optimized path, and a failing case is shrunk to a
+// minimal reproducer before it is reported.
+namespace Differential {
+    // One assignment of a case, as the user would have entered it
+    struct Record {
+        std::string subject;
+        std::string name;
+        int deadline;
+        int duration;
+        float weight;
+        int size;
+        bool groupWork;
+        int groupSize;
+    };
+
+    struct Case {
+        std::vector<Record> records;
+        int weekdayStudyHours = 0;
+        int weekendStudyHours = 0;
+        Planner::SchedulerEngine engine = Planner::SchedulerEngine::Priority;
+    };
+
+    // Compares both paths on a case; returns what differs, or "" if nothing does
+    using Check = std::function<std::string(const Case&)>;
+
+    // Deterministic case from a seed: up to maxRecords assignments with
+    // scores near the priority thresholds and names that need escaping
+    Case randomCase(std::uint64_t seed, int maxRecords = 40);
+
+    // Fill a store with the case's assignments, epoch today
+    void fillStore(const Case& testCase, Planner::AssignmentStore& assignments);
+
+    // Readable dump of a case, enough to paste into a unit test
+    std::string describe(const Case& testCase);
+
+    // Greedily simplify a failing case until no single simplification still
+    // fails: fewer assignments, smaller numbers, plainer names
+    Case shrink(Case failing, const Check& check);
+
+    // Run check on count cases starting at seed. Returns "" when all pass,
+    // otherwise the shrunk reproducer and its difference.
+    std::string run(const Check& check, std::uint64_t seed, int count, int maxRecords = 40);
+}
+
+#endif // DIFFERENTIAL_HPP
@@ -0,0 +1,336 @@
+#include "reference_planner.hpp"
+#include "../include/calendar.hpp"
+#include "../include/json.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <queue>
+#include <vector>
+
+namespace {
+    using AssignmentPtr = std::shared_ptr<Assignment>;
+
+    // calculatePriority exactly as the original planner had it
+    int calculatePriority(const Assignment& assignment, int studyHoursPerDay) {
+        int remainingHours = assignment.getDeadline() * studyHoursPerDay;
+        int priority = 0;
+
+        // Add priority based on deadline
+        if (assignment.getDeadline() < 2)
+            priority += 10;
+        else if (assignment.getDeadline() < 4)
+            priority += 8;
+        else if (assignment.getDeadline() < 6)
+            priority += 6;
+        else if (assignment.getDeadline() < 8)
+            priority += 4;
+
+        // Add priority based on remaining time
+        if ((remainingHours - assignment.getRealDuration()) < 2)
+            priority += 20;
+        else if ((remainingHours - assignment.getRealDuration()) < 4)
+            priority += 15;
+        else if ((remainingHours - assignment.getRealDuration()) < 6)
+            priority += 10;
+
+        // Add priority based on weight
+        if (assignment.getWeight() > 20)
+            priority += 6;
+        else if (assignment.getWeight() > 15)
+            priority += 4;
+        else if (assignment.getWeight() > 10)
+            priority += 2;
+
+        // Add priority based on size
+        if (assignment.getSize() == 1)
+            priority += 3;
+        else if (assignment.getSize() == 2)
+            priority += 2;
+        else if (assignment.getSize() == 3)
+            priority += 1;
+
+        return priority;
+    }
+
+    // Copies of the store's assignments with deadlines as days left, the
+    // form the original scheduler worked on
+    std::vector<AssignmentPtr> copyAssignments(const Planner::AssignmentStore& assignments) {
+        std::vector<AssignmentPtr> copies;
+        const int elapsed = Planner::today() - assignments.epochDay();
+        for (Planner::AssignmentHandle handle : assignments.handles()) {
+            copies.push_back(std::make_shared<Assignment>(assignments[handle]));
+            copies.back()->decreaseDeadline(elapsed);
+        }
+        return copies;
+    }
+
+    // Planner::scheduler as originally written, with the console lines and
+    // ICS appends replaced by recording the slot or missed deadline
+    void schedulePriority(const std::vector<AssignmentPtr>& assignments, int weekdayStudyHours, int weekendStudyHours,
+                          Planner::SchedulePlan& plan) {
+        auto indexOf = [&assignments](const AssignmentPtr& assignment) {
+            return static_cast<std::uint32_t>(std::find(assignments.begin(), assignments.end(), assignment) - assignments.begin());
+        };
+
+        std::vector<AssignmentPtr> assignmentList(assignments);
+        int day = 1;
+
+        while (!assignmentList.empty()) {
+            int studyHours = (day % 6 == 0 || day % 7 == 0) ? weekendStudyHours : weekdayStudyHours;
+            auto compare = [](const AssignmentPtr& a, const AssignmentPtr& b) {
+                return a->getPriority() < b->getPriority();
+            };
+            std::priority_queue<AssignmentPtr, std::vector<AssignmentPtr>, decltype(compare)> priorityQueue(compare);
+
+            for (const auto& assignment : assignmentList) {
+                int priority = calculatePriority(*assignment, studyHours);
+                assignment->setPriority(priority);
+                priorityQueue.push(assignment);
+            }
+
+            for (int i = 0; i < studyHours; ++i) {
+                if (priorityQueue.empty())
+                    break;
+
+                auto currentAssignment = priorityQueue.top();
+                priorityQueue.pop();
+
+                plan.slots.push_back({indexOf(currentAssignment), day, i, Planner::DefaultStudyStartHour + i});
+                currentAssignment->decreaseDuration(1);
+
+                if (currentAssignment->getRealDuration() <= 0) {
+                    auto it = std::find(assignmentList.begin(), assignmentList.end(), currentAssignment);
+                    if (it != assignmentList.end())
+                        assignmentList.erase(it);
+                } else {
+                    currentAssignment->setPriority(calculatePriority(*currentAssignment, studyHours));
+                    priorityQueue.push(currentAssignment);
+                }
+            }
+
+            for (auto it = assignmentList.begin(); it != assignmentList.end();) {
+                (*it)->decreaseDeadline(1);
+                if ((*it)->getDeadline() <= 0) {
+                    plan.missed.push_back({indexOf(*it), day});
+                    it = assignmentList.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            ++day;
+        }
+    }
+
+    // The working state the earliest-deadline engine ran on
+    struct WorkItem {
+        int remainingHours; // Real duration still to be scheduled
+        int dueDay; // Last day of the plan the assignment can be worked on
+    };
+
+    struct DeadlineEntry {
+        int deadline;
+        std::uint32_t index;
+    };
+
+    bool laterDeadline(const DeadlineEntry& a, const DeadlineEntry& b) {
+        return a.deadline != b.deadline ? a.deadline > b.deadline : a.index > b.index;
+    }
+
+    // The earliest deadline first engine as it stood once deadlines became
+    // day numbers: a min-heap on the due day, overdue work finished from a
+    // FIFO before anything else
+    void scheduleEarliestDeadline(const std::vector<AssignmentPtr>& assignments, int weekdayStudyHours, int weekendStudyHours,
+                                  Planner::SchedulePlan& plan) {
+        std::vector<WorkItem> items;
+        for (const auto& assignment : assignments)
+            items.push_back({assignment->getRealDuration(), assignment->getDeadline()});
+
+        std::vector<DeadlineEntry> heap;
+        heap.reserve(items.size());
+        for (std::uint32_t i = 0; i < items.size(); ++i) {
+            heap.push_back({std::max(items[i].dueDay, 1), i});
+        }
+        std::make_heap(heap.begin(), heap.end(), laterDeadline);
+
+        std::deque<std::uint32_t> late;
+        const bool canWork = weekdayStudyHours > 0 || weekendStudyHours > 0;
+
+        // Give up on late work after a year without a single free hour
+        constexpr int MaxIdleDays = 366;
+        int idleDays = 0;
+
+        int day = 1;
+        while (!heap.empty() || (canWork && !late.empty() && idleDays < MaxIdleDays)) {
+            int studyHours = (day % 6 == 0 || day % 7 == 0) ? weekendStudyHours : weekdayStudyHours;
+            idleDays = studyHours > 0 ? 0 : idleDays + 1;
+
+            for (int i = 0; i < studyHours; ++i) {
+                bool fromLate = !late.empty();
+                if (!fromLate && heap.empty())
+                    break;
+
+                std::uint32_t current = fromLate ? late.front() : heap.front().index;
+                WorkItem& item = items[current];
+                item.remainingHours -= 1;
+                plan.slots.push_back({current, day, i, Planner::DefaultStudyStartHour + i});
+
+                if (item.remainingHours <= 0) {
+                    if (fromLate) {
+                        late.pop_front();
+                    } else {
+                        std::pop_heap(heap.begin(), heap.end(), laterDeadline);
+                        heap.pop_back();
+                    }
+                }
+            }
+
+            // Only assignments due today are touched
+            while (!heap.empty() && heap.front().deadline <= day) {
+                std::uint32_t index = heap.front().index;
+                std::pop_heap(heap.begin(), heap.end(), laterDeadline);
+                heap.pop_back();
+
+                plan.missed.push_back({index, day});
+                late.push_back(index);
+            }
+
+            ++day;
+        }
+    }
+
+    // 64-bit FNV-1a, as the feed's UIDs use it
+    std::uint64_t fnv1a(const std::string& text, std::uint64_t hash = 14695981039346656037ULL) {
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // A TEXT value with its special characters escaped one by one
+    std::string escaped(const std::string& text) {
+        std::string result;
+        for (char c : text) {
+            if (c == '\n')
+                result += "\\n";
+            else if (c == '\\' || c == ';' || c == ',')
+                result += std::string("\\") + c;
+            else
+                result += c;
+        }
+        return result;
+    }
+
+    // A content line cut every 75 octets, moving each cut back to the start
+    // of a UTF-8 character, with CRLF line ends
+    std::string contentLine(const std::string& name, const std::string& value) {
+        std::string line = name + ":" + value;
+        std::string folded;
+        std::size_t limit = 75;
+        while (line.size() > limit) {
+            std::size_t cut = limit;
+            while ((static_cast<unsigned char>(line[cut]) & 0xC0) == 0x80)
+                --cut;
+            folded += line.substr(0, cut) + "\r\n";
+            line = " " + line.substr(cut);
+            limit = 75;
+        }
+        return folded + line + "\r\n";
+    }
+
+    std::string localTime(int dayNumber, int hour) {
+        int year, month, day;
+        Planner::civilFromDayNumber(dayNumber + hour / 24, year, month, day);
+        char buffer[20];
+        std::snprintf(buffer, sizeof(buffer), "%04d%02d%02dT%02d0000", year, month, day, hour % 24);
+        return buffer;
+    }
+}
+
+Planner::SchedulePlan Reference::schedule(const Planner::AssignmentStore& assignments, int weekdayStudyHours,
+                                          int weekendStudyHours, Planner::SchedulerEngine engine) {
+    Planner::SchedulePlan plan;
+    if (engine == Planner::SchedulerEngine::EarliestDeadline)
+        scheduleEarliestDeadline(copyAssignments(assignments), weekdayStudyHours, weekendStudyHours, plan);
+    else
+        schedulePriority(copyAssignments(assignments), weekdayStudyHours, weekendStudyHours, plan);
+    return plan;
+}
+
+std::string Reference::saveBytes(const Planner::AssignmentStore& assignments) {
+    nlohmann::json records = nlohmann::json::array();
+    for (Planner::AssignmentHandle handle : assignments.handles()) {
+        const Assignment& assignment = assignments[handle];
+        records.push_back({
+            {"subject", assignment.getSubject()},
+            {"name", assignment.getName()},
+            {"deadline", assignment.getDeadline()},
+            {"duration", assignment.getDuration()},
+            {"weight", assignment.getWeight()},
+            {"size", assignment.getSize()},
+            {"group_work", assignment.isGroupWork()},
+            {"group_size", assignment.getGroupSize()}
+        });
+    }
+
+    nlohmann::json jsonData = {
+        {"epoch", assignments.epochDay()},
+        {"assignments", std::move(records)}
+    };
+    return jsonData.dump(4);
+}
+
+std::string Reference::calendarBytes(const Planner::AssignmentStore& assignments, const Planner::SchedulePlan& plan, int startDay,
+                                     const std::string& stamp) {
+    const auto& handles = assignments.handles();
+    std::string feed = contentLine("BEGIN", "VCALENDAR") + contentLine("VERSION", "2.0") + contentLine("PRODID", "-//Planner App//EN");
+    feed += contentLine("X-PLANNER-REVISION", plan.slots.empty() ? "0" : "1");
+
+    std::vector<int> lastDay(handles.size(), -1);
+    std::vector<int> eventsOnDay(handles.size(), 0);
+    for (std::size_t first = 0; first < plan.slots.size();) {
+        // One event per run of consecutive hours of one assignment on one day
+        const Planner::ScheduledSlot& slot = plan.slots[first];
+        std::size_t last = first + 1;
+        while (last < plan.slots.size() && plan.slots[last].assignment == slot.assignment && plan.slots[last].day == slot.day &&
+               plan.slots[last].startHour == plan.slots[last - 1].startHour + 1)
+            ++last;
+        int hours = static_cast<int>(last - first);
+        first = last;
+
+        const Assignment& assignment = assignments[handles[slot.assignment]];
+        int occurrence = 0;
+        for (std::uint32_t i = 0; i < slot.assignment; ++i) {
+            const Assignment& other = assignments[handles[i]];
+            occurrence += other.getSubject() == assignment.getSubject() && other.getName() == assignment.getName();
+        }
+        if (lastDay[slot.assignment] != slot.day) {
+            lastDay[slot.assignment] = slot.day;
+            eventsOnDay[slot.assignment] = 0;
+        }
+
+        std::uint64_t hash = fnv1a(assignment.getSubject());
+        hash = fnv1a("\x1f" + assignment.getName(), hash);
+        hash = fnv1a("\x1f" + std::to_string(occurrence), hash);
+        char uid[80];
+        std::snprintf(uid, sizeof(uid), "%016llx-%s-%d@study-planner", static_cast<unsigned long long>(hash),
+                      localTime(startDay + slot.day, 0).substr(0, 8).c_str(), eventsOnDay[slot.assignment]++);
+
+        feed += contentLine("BEGIN", "VEVENT");
+        feed += contentLine("UID", uid);
+        feed += contentLine("DTSTAMP", stamp);
+        feed += contentLine("SEQUENCE", "1");
+        feed += contentLine("SUMMARY", escaped(assignment.getName()));
+        feed += contentLine("DTSTART", localTime(startDay + slot.day, slot.startHour));
+        feed += contentLine("DTEND", localTime(startDay + slot.day, slot.startHour + hours));
+        feed += contentLine("DESCRIPTION", "Scheduled Assignment");
+        feed += contentLine("STATUS", "CONFIRMED");
+        feed += contentLine("END", "VEVENT");
+    }
+
+    feed += contentLine("END", "VCALENDAR");
+    return feed;
+}
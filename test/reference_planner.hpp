@@ -0,0 +1,28 @@
+#ifndef REFERENCE_PLANNER_HPP
+#define REFERENCE_PLANNER_HPP
+
+#include "../include/simulation.hpp"
+#include <string>
+
+// Frozen reference implementations of the scheduler and the save format.
+// These are the oracle the differential tests hold every faster path to:
+// they are written for obviousness, not speed, and must not be "improved".
+// Change them only together with a deliberate change of planner behavior.
+namespace Reference {
+    // The scheduler's plan for a store on a fixed weekday/weekend budget.
+    // Priority is the original Planner::scheduler loop on copies of the
+    // assignments; earliest deadline first is the heap-based engine as of
+    // day-number deadlines.
+    Planner::SchedulePlan schedule(const Planner::AssignmentStore& assignments, int weekdayStudyHours,
+                                   int weekendStudyHours, Planner::SchedulerEngine engine);
+
+    // The exact bytes saveToFile writes for a store
+    std::string saveBytes(const Planner::AssignmentStore& assignments);
+
+    // The exact bytes of the first calendar feed written for a plan whose
+    // day 0 is the day number startDay, every event stamped with stamp
+    std::string calendarBytes(const Planner::AssignmentStore& assignments, const Planner::SchedulePlan& plan, int startDay,
+                              const std::string& stamp);
+}
+
+#endif // REFERENCE_PLANNER_HPP
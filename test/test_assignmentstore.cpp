@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+#include "../include/assignmentstore.hpp"
+#include <type_traits>
+
+// Test handles are plain 32-bit values
+TEST(AssignmentStoreTest, HandleIsTriviallyCopyable) {
+    EXPECT_TRUE(std::is_trivially_copyable<Planner::AssignmentHandle>::value);
+    EXPECT_EQ(sizeof(Planner::AssignmentHandle), 4);
+}
+
+// Test Planner::AssignmentStore::emplace and lookup
+TEST(AssignmentStoreTest, EmplaceAndGet) {
+    Planner::AssignmentStore store;
+    auto math = store.emplace("Math", "Math Homework", 5, 10, 20.0f, 1, false, 1);
+    auto science = store.emplace("Science", "Science Project", 7, 15, 25.0f, 2, true, 3);
+
+    EXPECT_EQ(store.size(), 2);
+    EXPECT_EQ(store[math].getName(), "Math Homework");
+    EXPECT_EQ(store[science].getRealDuration(), 5);
+    ASSERT_EQ(store.handles().size(), 2);
+    EXPECT_EQ(store.handles()[0], math);
+    EXPECT_EQ(store.handles()[1], science);
+}
+
+// Test Planner::AssignmentStore::remove keeps order and reuses slots
+TEST(AssignmentStoreTest, RemoveAndReuse) {
+    Planner::AssignmentStore store;
+    auto first = store.emplace("Math", "First", 5, 10, 20.0f, 1, false, 1);
+    auto second = store.emplace("Math", "Second", 5, 10, 20.0f, 1, false, 1);
+    auto third = store.emplace("Math", "Third", 5, 10, 20.0f, 1, false, 1);
+
+    store.remove(second);
+    ASSERT_EQ(store.size(), 2);
+    EXPECT_EQ(store.handles()[0], first);
+    EXPECT_EQ(store.handles()[1], third);
+
+    auto fourth = store.emplace("Math", "Fourth", 5, 10, 20.0f, 1, false, 1);
+    EXPECT_EQ(fourth, second);
+    EXPECT_EQ(store[fourth].getName(), "Fourth");
+    EXPECT_EQ(store.handles().back(), fourth);
+}
+
+// Test the store grows across several arena chunks
+TEST(AssignmentStoreTest, ManyAssignments) {
+    Planner::AssignmentStore store;
+    for (int i = 0; i < 1000; ++i) {
+        store.emplace("Math", "Task " + std::to_string(i), i, 1, 5.0f, 1, false, 1);
+    }
+
+    EXPECT_EQ(store.size(), 1000);
+    EXPECT_EQ(store[store.handles()[999]].getName(), "Task 999");
+    EXPECT_EQ(store[store.handles()[500]].getDeadline(), 500);
+
+    store.clear();
+    EXPECT_TRUE(store.empty());
+}
+
+// Test moving a store transfers ownership
+TEST(AssignmentStoreTest, MoveStore) {
+    Planner::AssignmentStore store;
+    auto handle = store.emplace("Math", "Math Homework", 5, 10, 20.0f, 1, false, 1);
+
+    Planner::AssignmentStore moved(std::move(store));
+
+    EXPECT_EQ(moved.size(), 1);
+    EXPECT_EQ(moved[handle].getName(), "Math Homework");
+}
+
+// Test Planner::AssignmentStore::rebase keeps due dates fixed
+TEST(AssignmentStoreTest, Rebase) {
+    Planner::AssignmentStore store;
+    store.setEpochDay(100);
+    auto handle = store.emplace("Math", "Math Homework", 10, 10, 20.0f, 1, false, 1);
+
+    store.rebase(104);
+
+    EXPECT_EQ(store.epochDay(), 104);
+    EXPECT_EQ(store[handle].getDeadline(), 6);
+}
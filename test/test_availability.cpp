@@ -0,0 +1,186 @@
+#include "gtest/gtest.h"
+#include "../include/availability.hpp"
+#include "../include/calendar.hpp"
+#include "../include/simulation.hpp"
+#include <cstdio>
+#include <vector>
+
+// Monday 2024-09-02
+static const int Monday = Planner::dayNumber(2024, 9, 2);
+
+using Planner::minuteAt;
+
+// Test weekdays are counted from Monday
+TEST(AvailabilityTest, WeekdayOf) {
+    EXPECT_EQ(Planner::Availability::weekdayOf(Monday), 0);
+    EXPECT_EQ(Planner::Availability::weekdayOf(Monday + 6), 6);
+    EXPECT_EQ(Planner::Availability::weekdayOf(Planner::dayNumber(1970, 1, 1)), 3);
+}
+
+// Test a weekly commitment blocks every occurrence without expanding them
+TEST(AvailabilityTest, Weekly_RecursEveryWeek) {
+    Planner::Availability availability;
+    availability.addWeekly(0, 18 * 60, 20 * 60);
+
+    EXPECT_EQ(availability.weeklyCount(), 1);
+    for (int week = 0; week < 15; ++week) {
+        EXPECT_FALSE(availability.isFree(minuteAt(Monday + 7 * week, 19), minuteAt(Monday + 7 * week, 20)));
+        EXPECT_TRUE(availability.isFree(minuteAt(Monday + 7 * week + 1, 19), minuteAt(Monday + 7 * week + 1, 20)));
+    }
+    EXPECT_TRUE(availability.isFree(minuteAt(Monday, 20), minuteAt(Monday, 21)));
+}
+
+// Test a commitment past midnight blocks the start of the next day
+TEST(AvailabilityTest, Weekly_Overnight) {
+    Planner::Availability availability;
+    availability.addWeekly(6, 22 * 60, 26 * 60); // Sunday 22:00 to Monday 02:00
+
+    EXPECT_FALSE(availability.isFree(minuteAt(Monday + 6, 23), minuteAt(Monday + 6, 24)));
+    EXPECT_FALSE(availability.isFree(minuteAt(Monday + 7, 1), minuteAt(Monday + 7, 2)));
+    EXPECT_TRUE(availability.isFree(minuteAt(Monday + 7, 2), minuteAt(Monday + 7, 3)));
+}
+
+// Test a semester range limits when a weekly commitment applies
+TEST(AvailabilityTest, Weekly_ValidityRange) {
+    Planner::Availability availability;
+    availability.addWeekly(0, 18 * 60, 20 * 60, Monday, Monday + 13);
+
+    EXPECT_FALSE(availability.isFree(minuteAt(Monday + 7, 18), minuteAt(Monday + 7, 19)));
+    EXPECT_TRUE(availability.isFree(minuteAt(Monday - 7, 18), minuteAt(Monday - 7, 19)));
+    EXPECT_TRUE(availability.isFree(minuteAt(Monday + 14, 18), minuteAt(Monday + 14, 19)));
+}
+
+// Test one-off events overlap by absolute time
+TEST(AvailabilityTest, Busy_OneOff) {
+    Planner::Availability availability;
+    availability.addBusy(minuteAt(Monday, 19), minuteAt(Monday, 21));
+    availability.addBusy(minuteAt(Monday - 3, 8), minuteAt(Monday - 3, 9));
+
+    EXPECT_FALSE(availability.isFree(minuteAt(Monday, 20), minuteAt(Monday, 22)));
+    EXPECT_TRUE(availability.isFree(minuteAt(Monday, 21), minuteAt(Monday, 22)));
+    EXPECT_TRUE(availability.isFree(minuteAt(Monday + 7, 19), minuteAt(Monday + 7, 20)));
+}
+
+// Test a long event is found even when many short ones start after it
+TEST(AvailabilityTest, Busy_LongIntervalBehindShortOnes) {
+    Planner::Availability availability;
+    availability.addBusy(minuteAt(Monday, 0), minuteAt(Monday + 30, 0));
+    for (int day = 0; day < 20; ++day)
+        availability.addBusy(minuteAt(Monday + day, 1), minuteAt(Monday + day, 2));
+
+    EXPECT_FALSE(availability.isFree(minuteAt(Monday + 25, 12), minuteAt(Monday + 25, 13)));
+    EXPECT_TRUE(availability.isFree(minuteAt(Monday + 30, 12), minuteAt(Monday + 30, 13)));
+}
+
+// Test intervals added out of order stay sorted and match a plain scan
+TEST(AvailabilityTest, Busy_OutOfOrder) {
+    Planner::Availability availability;
+    std::vector<std::pair<long long, long long>> busy;
+    for (int i = 0; i < 200; ++i) {
+        long long start = minuteAt(Monday + (i * 37) % 50, (i * 11) % 24);
+        long long end = start + 30 + (i * 53) % 2000;
+        availability.addBusy(start, end);
+        busy.emplace_back(start, end);
+    }
+
+    const auto& stored = availability.busyIntervals();
+    ASSERT_EQ(stored.size(), busy.size());
+    for (std::size_t i = 1; i < stored.size(); ++i)
+        EXPECT_LE(stored[i - 1].start, stored[i].start);
+
+    for (long long start = minuteAt(Monday - 1, 0); start < minuteAt(Monday + 52, 0); start += 45) {
+        bool free = true;
+        for (const auto& interval : busy)
+            free = free && (interval.second <= start || interval.first >= start + 60);
+        EXPECT_EQ(availability.isFree(start, start + 60), free) << start;
+    }
+}
+
+// Test free study hours follow the default window and skip busy time
+TEST(AvailabilityTest, FreeStudyHours) {
+    Planner::Availability availability;
+    std::vector<int> hours;
+
+    EXPECT_EQ(availability.freeStudyHours(Monday, 3, hours), 3);
+    EXPECT_EQ(hours, (std::vector<int>{18, 19, 20}));
+
+    availability.addWeekly(0, 18 * 60, 20 * 60);
+    EXPECT_EQ(availability.freeStudyHours(Monday, 3, hours), 3);
+    EXPECT_EQ(hours, (std::vector<int>{20, 21, 22}));
+
+    availability.setStudyWindow(18, 21);
+    EXPECT_EQ(availability.freeStudyHours(Monday, 3, hours), 1);
+    EXPECT_EQ(hours, (std::vector<int>{20}));
+}
+
+// Test the simulation only places hours into free slots
+TEST(AvailabilityTest, Simulate_UsesFreeSlots) {
+    Planner::Availability availability;
+    for (int weekday = 0; weekday < 7; ++weekday)
+        availability.addWeekly(weekday, 18 * 60, 19 * 60);
+
+    std::vector<Planner::WorkItem> items = {{4, 10, 0, 10.0f, 2}};
+    Planner::ScheduleOptions options;
+    options.weekdayStudyHours = 2;
+    options.weekendStudyHours = 2;
+    options.availability = &availability;
+    options.startDay = Monday;
+
+    Planner::SchedulePlan plan;
+    auto stats = Planner::simulate(items, options, &plan);
+
+    EXPECT_EQ(stats.scheduledHours, 4);
+    ASSERT_EQ(plan.slots.size(), 4);
+    EXPECT_EQ(plan.slots[0].startHour, 19);
+    EXPECT_EQ(plan.slots[1].startHour, 20);
+}
+
+// Test a day with no free time gets no study hours
+TEST(AvailabilityTest, Simulate_BusyDay) {
+    Planner::Availability availability;
+    availability.addBusy(minuteAt(Monday + 1, 0), minuteAt(Monday + 3, 0));
+    availability.setStudyWindow(18, 24);
+
+    std::vector<Planner::WorkItem> items = {{3, 10, 0, 10.0f, 2}};
+    Planner::ScheduleOptions options;
+    options.weekdayStudyHours = 2;
+    options.weekendStudyHours = 2;
+    options.engine = Planner::SchedulerEngine::EarliestDeadline;
+    options.availability = &availability;
+    options.startDay = Monday;
+
+    Planner::SchedulePlan plan;
+    Planner::simulate(items, options, &plan);
+
+    ASSERT_EQ(plan.slots.size(), 3);
+    EXPECT_EQ(plan.slots[0].day, 3);
+    EXPECT_EQ(plan.slots[2].day, 4);
+}
+
+// Test availability survives a save and load
+TEST(AvailabilityTest, SaveAndLoad) {
+    const std::string filename = "test_availability.json";
+    Planner::Availability availability;
+    availability.addWeekly(2, 9 * 60, 11 * 60, Monday, Monday + 100);
+    availability.addWeekly(6, 23 * 60, 25 * 60);
+    availability.addBusy(minuteAt(Monday, 18), minuteAt(Monday, 20));
+    availability.setStudyWindow(17, 23);
+
+    Planner::saveAvailability(filename, availability);
+    auto loaded = Planner::loadAvailability(filename);
+    std::remove(filename.c_str());
+
+    EXPECT_EQ(loaded.weeklyCount(), availability.weeklyCount());
+    EXPECT_EQ(loaded.busyCount(), 1);
+    EXPECT_EQ(loaded.studyWindowStart(), 17);
+    EXPECT_EQ(loaded.studyWindowEnd(), 23);
+    EXPECT_FALSE(loaded.isFree(minuteAt(Monday + 2, 10), minuteAt(Monday + 2, 11)));
+    EXPECT_TRUE(loaded.isFree(minuteAt(Monday + 2 + 105, 10), minuteAt(Monday + 2 + 105, 11)));
+    EXPECT_FALSE(loaded.isFree(minuteAt(Monday + 7, 0), minuteAt(Monday + 7, 1)));
+}
+
+// Test a missing file means no commitments
+TEST(AvailabilityTest, LoadMissingFile) {
+    auto availability = Planner::loadAvailability("no_such_availability.json");
+    EXPECT_TRUE(availability.empty());
+}
@@ -0,0 +1,126 @@
+#include "gtest/gtest.h"
+#include "../include/batchio.hpp"
+#include "../include/planner.hpp"
+#include "../include/gzipstream.hpp"
+#include "../include/icsexport.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const char* BatchDirectory = "test_batchio";
+
+static std::string contentsOf(int file) {
+    return "file " + std::to_string(file) + "\n" + std::string(static_cast<std::size_t>(file) * 37, 'x');
+}
+
+static std::vector<Planner::IoBackend> availableBackends() {
+    std::vector<Planner::IoBackend> backends{Planner::IoBackend::Stream};
+    if (Planner::uringAvailable())
+        backends.push_back(Planner::IoBackend::Uring);
+    return backends;
+}
+
+// Test written files read back through every backend, with missing files reported
+TEST(BatchIoTest, WriteThenRead) {
+    for (Planner::IoBackend backend : availableBackends()) {
+        SCOPED_TRACE(Planner::ioBackendName(backend));
+        std::filesystem::remove_all(BatchDirectory);
+        std::filesystem::create_directory(BatchDirectory);
+
+        // More files than requests in flight, plus one bigger than a buffer
+        std::vector<std::string> paths;
+        {
+            Planner::BatchWriter writer(backend, 4);
+            EXPECT_EQ(writer.backend(), backend);
+            for (int file = 0; file < 20; ++file) {
+                paths.push_back(std::string(BatchDirectory) + "/" + std::to_string(file) + ".txt");
+                writer.add(paths.back(), contentsOf(file));
+            }
+            paths.push_back(std::string(BatchDirectory) + "/large.txt");
+            writer.add(paths.back(), std::string(200000, 'L'));
+            EXPECT_EQ(writer.finish(), 0);
+        }
+        paths.push_back(std::string(BatchDirectory) + "/missing.txt");
+
+        Planner::BatchReader reader(paths, backend, 4);
+        EXPECT_EQ(reader.backend(), backend);
+        std::vector<int> seen(paths.size(), 0);
+        Planner::FileData file;
+        while (reader.next(file)) {
+            ASSERT_LT(file.index, paths.size());
+            ++seen[file.index];
+            EXPECT_EQ(file.path, paths[file.index]);
+            if (file.index < 20) {
+                EXPECT_TRUE(file.ok);
+                EXPECT_EQ(file.data, contentsOf(static_cast<int>(file.index)));
+            } else if (file.index == 20) {
+                EXPECT_TRUE(file.ok);
+                EXPECT_EQ(file.data, std::string(200000, 'L'));
+            } else {
+                EXPECT_FALSE(file.ok);
+            }
+        }
+        EXPECT_EQ(seen, std::vector<int>(paths.size(), 1));
+    }
+    std::filesystem::remove_all(BatchDirectory);
+}
+
+// Test files that cannot be created are reported by the writer
+TEST(BatchIoTest, WriteFailures) {
+    for (Planner::IoBackend backend : availableBackends()) {
+        SCOPED_TRACE(Planner::ioBackendName(backend));
+        Planner::BatchWriter writer(backend);
+        writer.add("no_such_directory/plan.json", "{}");
+        EXPECT_EQ(writer.finish(), 1);
+        EXPECT_EQ(writer.failures(), std::vector<std::string>{"no_such_directory/plan.json"});
+    }
+}
+
+// Test a reader closed with reads in flight cancels them and can be followed by another
+TEST(BatchIoTest, ReaderClosedEarly) {
+    for (Planner::IoBackend backend : availableBackends()) {
+        SCOPED_TRACE(Planner::ioBackendName(backend));
+        std::filesystem::remove_all(BatchDirectory);
+        std::filesystem::create_directory(BatchDirectory);
+        std::vector<std::string> paths;
+        for (int file = 0; file < 40; ++file) {
+            paths.push_back(std::string(BatchDirectory) + "/" + std::to_string(file) + ".txt");
+            std::ofstream(paths.back()) << contentsOf(file);
+        }
+
+        for (int round = 0; round < 2; ++round) {
+            Planner::BatchReader reader(paths, backend, 8);
+            Planner::FileData file;
+            ASSERT_TRUE(reader.next(file));
+            EXPECT_TRUE(file.ok);
+            EXPECT_EQ(file.data, contentsOf(static_cast<int>(file.index)));
+        }
+    }
+    std::filesystem::remove_all(BatchDirectory);
+}
+
+// Test plan and calendar contents match what the file-based functions produce
+TEST(BatchIoTest, PlanAndCalendarContents) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Homework", 3, 4, 20.0f, 2, false, 1);
+    assignments.emplace("Physics", "Lab Report", 5, 6, 25.0f, 1, true, 3);
+
+    std::string contents = Planner::formatPlanFile(assignments);
+    for (const std::string& stored : {contents, Planner::gzipCompress(contents)}) {
+        auto parsed = Planner::parsePlanFile(stored);
+        ASSERT_EQ(parsed.size(), 2);
+        EXPECT_EQ(parsed[parsed.handles()[1]].getName(), "Lab Report");
+        EXPECT_EQ(parsed[parsed.handles()[1]].getDeadline(), 5);
+    }
+    EXPECT_EQ(Planner::gzipDecompress(Planner::gzipCompress(contents)), contents);
+
+    // A rerun against its own feed keeps the revision
+    std::string feed = Planner::scheduleCalendar(assignments, 4, 6, Planner::SchedulerEngine::Priority, "");
+    EXPECT_NE(feed.find("BEGIN:VCALENDAR"), std::string::npos);
+    std::istringstream first(feed);
+    std::istringstream second(Planner::scheduleCalendar(assignments, 4, 6, Planner::SchedulerEngine::Priority, feed));
+    EXPECT_EQ(Planner::readCalendarFeed(second).revision, Planner::readCalendarFeed(first).revision);
+}
@@ -0,0 +1,49 @@
+#include "gtest/gtest.h"
+#include "../include/calendar.hpp"
+
+// Test Planner::dayNumber against known dates
+TEST(CalendarTest, DayNumber) {
+    EXPECT_EQ(Planner::dayNumber(1970, 1, 1), 0);
+    EXPECT_EQ(Planner::dayNumber(2000, 3, 1), 11017);
+    EXPECT_EQ(Planner::dayNumber(2024, 12, 3), 20060);
+    EXPECT_EQ(Planner::dayNumber(1969, 12, 31), -1);
+}
+
+// Test Planner::dayNumber across a leap day
+TEST(CalendarTest, DayNumber_LeapYear) {
+    EXPECT_EQ(Planner::dayNumber(2024, 3, 1) - Planner::dayNumber(2024, 2, 28), 2);
+    EXPECT_EQ(Planner::dayNumber(2023, 3, 1) - Planner::dayNumber(2023, 2, 28), 1);
+}
+
+// Test Planner::dayNumber from a broken-down time
+TEST(CalendarTest, DayNumber_FromTm) {
+    std::tm date{};
+    date.tm_year = 2024 - 1900;
+    date.tm_mon = 11;
+    date.tm_mday = 3;
+
+    EXPECT_EQ(Planner::dayNumber(date), 20060);
+}
+
+// Test Planner::civilFromDayNumber inverts Planner::dayNumber
+TEST(CalendarTest, CivilFromDayNumber_RoundTrip) {
+    for (int day = Planner::dayNumber(1899, 12, 25); day < Planner::dayNumber(2101, 1, 5); day += 13) {
+        int year, month, dayOfMonth;
+        Planner::civilFromDayNumber(day, year, month, dayOfMonth);
+        EXPECT_EQ(Planner::dayNumber(year, month, dayOfMonth), day);
+    }
+
+    int year, month, dayOfMonth;
+    Planner::civilFromDayNumber(20060, year, month, dayOfMonth);
+    EXPECT_EQ(year, 2024);
+    EXPECT_EQ(month, 12);
+    EXPECT_EQ(dayOfMonth, 3);
+}
+
+// Test Planner::daysInMonth on leap and common years
+TEST(CalendarTest, DaysInMonth) {
+    EXPECT_EQ(Planner::daysInMonth(2024, 2), 29);
+    EXPECT_EQ(Planner::daysInMonth(1900, 2), 28);
+    EXPECT_EQ(Planner::daysInMonth(2000, 2), 29);
+    EXPECT_EQ(Planner::daysInMonth(2023, 4), 30);
+}
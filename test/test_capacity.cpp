@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+#include "../include/capacity.hpp"
+#include "../include/calendar.hpp"
+#include "../include/feasibility.hpp"
+#include "../include/simulation.hpp"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+// Test the legacy table reproduces the day-counter rule, inside and past its horizon
+TEST(CapacityTest, LegacyMatchesRule) {
+    auto table = Planner::CapacityTable::legacy(3, 7, 50);
+    EXPECT_EQ(table.horizon(), 50);
+    EXPECT_EQ(table.hoursFor(0), 0);
+
+    long long total = 0;
+    for (int day = 1; day <= 300; ++day) {
+        total += Planner::studyHoursForDay(day, 3, 7);
+        EXPECT_EQ(table.hoursFor(day), Planner::studyHoursForDay(day, 3, 7)) << day;
+        EXPECT_EQ(table.hoursThrough(day), total) << day;
+    }
+    EXPECT_EQ(table.hoursBetween(40, 60), table.hoursThrough(60) - table.hoursThrough(39));
+    EXPECT_EQ(table.hoursBetween(10, 9), 0);
+}
+
+// Test calendar days follow real weekdays, with holidays overriding them
+TEST(CapacityTest, CalendarWeekdaysAndHolidays) {
+    const int friday = Planner::dayNumber(2024, 1, 5);
+    const std::vector<Planner::Holiday> holidays{{friday + 3, 0}, {friday + 9, 6}}; // Monday off, a long Sunday
+    auto table = Planner::calendarCapacity(friday, 2, 5, holidays, 14);
+
+    EXPECT_EQ(table.hoursFor(1), 5); // Saturday
+    EXPECT_EQ(table.hoursFor(2), 5); // Sunday
+    EXPECT_EQ(table.hoursFor(3), 0); // Holiday Monday
+    EXPECT_EQ(table.hoursFor(4), 2); // Tuesday
+    EXPECT_EQ(table.hoursFor(9), 6);
+    EXPECT_EQ(table.hoursFor(8), 5);
+    EXPECT_EQ(table.hoursFor(15), 5); // Past the horizon, still a Saturday
+    EXPECT_EQ(table.hoursFor(17), 2);
+
+    EXPECT_EQ(table.hoursBetween(1, 7), 5 + 5 + 0 + 2 * 4);
+    long long total = 0;
+    for (int day = 1; day <= 100; ++day)
+        total += table.hoursFor(day);
+    EXPECT_EQ(table.hoursThrough(100), total);
+}
+
+// Test feasibility and the scheduler read the table
+TEST(CapacityTest, FeasibilityAndSimulation) {
+    Planner::AssignmentStore assignments;
+    for (int i = 0; i < 30; ++i)
+        assignments.emplace("Math", "Homework " + std::to_string(i), 1 + (i * 7) % 30, 1 + i % 5, 10.0f + i % 15, 1 + i % 3, false, 1);
+
+    auto legacy = Planner::CapacityTable::legacy(3, 4);
+    EXPECT_EQ(Planner::isFeasible(assignments, legacy), Planner::isFeasible(assignments, 3, 4));
+
+    Planner::ScheduleOptions options;
+    options.weekdayStudyHours = 3;
+    options.weekendStudyHours = 4;
+    auto items = Planner::makeWorkItems(assignments);
+    Planner::SchedulePlan expected;
+    Planner::simulate(items, options, &expected);
+
+    options.capacity = &legacy;
+    items = Planner::makeWorkItems(assignments);
+    Planner::SchedulePlan actual;
+    Planner::simulate(items, options, &actual);
+    ASSERT_EQ(actual.slots.size(), expected.slots.size());
+    for (std::size_t i = 0; i < actual.slots.size(); ++i) {
+        EXPECT_EQ(actual.slots[i].assignment, expected.slots[i].assignment);
+        EXPECT_EQ(actual.slots[i].day, expected.slots[i].day);
+    }
+
+    // A fortnight off makes the early deadlines impossible
+    std::vector<Planner::Holiday> holidays;
+    for (int day = 1; day <= 14; ++day)
+        holidays.push_back({Planner::today() + day, 0});
+    auto calendar = Planner::calendarCapacity(Planner::today(), 24, 24, holidays, 30);
+    EXPECT_TRUE(Planner::isFeasible(assignments, Planner::calendarCapacity(Planner::today(), 24, 24, {}, 30)));
+    EXPECT_FALSE(Planner::isFeasible(assignments, calendar));
+}
+
+// Test holidays are read from text, skipping comments and bad lines
+TEST(CapacityTest, LoadHolidays) {
+    const std::string path = "test_holidays.txt";
+    {
+        std::ofstream file(path);
+        file << "# Term breaks\n2024-12-25\n2024-12-31 2\n2024-02-30 1\nnot a date\n";
+    }
+
+    auto holidays = Planner::loadHolidays(path);
+    ASSERT_EQ(holidays.size(), 2u);
+    EXPECT_EQ(holidays[0].day, Planner::dayNumber(2024, 12, 25));
+    EXPECT_EQ(holidays[0].hours, 0);
+    EXPECT_EQ(holidays[1].day, Planner::dayNumber(2024, 12, 31));
+    EXPECT_EQ(holidays[1].hours, 2);
+    std::filesystem::remove(path);
+
+    EXPECT_TRUE(Planner::loadHolidays("missing_holidays.txt").empty());
+}
@@ -0,0 +1,164 @@
+#include "gtest/gtest.h"
+#include "differential.hpp"
+#include "reference_planner.hpp"
+#include "../include/simulation.hpp"
+#include "../include/icsexport.hpp"
+#include "../include/calendar.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+namespace {
+    // Case count and first seed; raise PLANNER_DIFF_CASES for a longer soak
+    int caseCount() {
+        const char* value = std::getenv("PLANNER_DIFF_CASES");
+        return value ? std::atoi(value) : 1000;
+    }
+
+    std::uint64_t firstSeed() {
+        const char* value = std::getenv("PLANNER_DIFF_SEED");
+        return value ? std::strtoull(value, nullptr, 10) : 1;
+    }
+
+    std::string readFile(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    std::string slotText(const Planner::ScheduledSlot& slot) {
+        return "assignment " + std::to_string(slot.assignment) + " day " + std::to_string(slot.day) + " hour " +
+               std::to_string(slot.hour) + " at " + std::to_string(slot.startHour);
+    }
+
+    // The simulation engines against the frozen scheduler
+    std::string compareSchedules(const Differential::Case& testCase) {
+        Planner::AssignmentStore assignments;
+        Differential::fillStore(testCase, assignments);
+
+        Planner::SchedulePlan expected = Reference::schedule(assignments, testCase.weekdayStudyHours,
+                                                             testCase.weekendStudyHours, testCase.engine);
+        Planner::SchedulePlan actual;
+        auto items = Planner::makeWorkItems(assignments);
+        Planner::simulate(items, testCase.weekdayStudyHours, testCase.weekendStudyHours, testCase.engine, &actual);
+
+        for (std::size_t i = 0; i < expected.slots.size() && i < actual.slots.size(); ++i) {
+            const auto& a = expected.slots[i];
+            const auto& b = actual.slots[i];
+            if (a.assignment != b.assignment || a.day != b.day || a.hour != b.hour || a.startHour != b.startHour)
+                return "slot " + std::to_string(i) + ": expected " + slotText(a) + ", got " + slotText(b) + "\n";
+        }
+        if (expected.slots.size() != actual.slots.size())
+            return "expected " + std::to_string(expected.slots.size()) + " slots, got " + std::to_string(actual.slots.size()) + "\n";
+
+        for (std::size_t i = 0; i < expected.missed.size() && i < actual.missed.size(); ++i) {
+            const auto& a = expected.missed[i];
+            const auto& b = actual.missed[i];
+            if (a.assignment != b.assignment || a.day != b.day)
+                return "missed deadline " + std::to_string(i) + ": expected assignment " + std::to_string(a.assignment) +
+                       " on day " + std::to_string(a.day) + ", got " + std::to_string(b.assignment) + " on day " +
+                       std::to_string(b.day) + "\n";
+        }
+        if (expected.missed.size() != actual.missed.size())
+            return "expected " + std::to_string(expected.missed.size()) + " missed deadlines, got " +
+                   std::to_string(actual.missed.size()) + "\n";
+        return "";
+    }
+
+    // The calendar feed of the simulated plan against the frozen feed of the
+    // frozen plan, compared byte for byte
+    std::string compareCalendarBytes(const Differential::Case& testCase) {
+        const int startDay = Planner::dayNumber(2024, 9, 2);
+        const std::string stamp = "20240902T000000Z";
+        Planner::AssignmentStore assignments;
+        Differential::fillStore(testCase, assignments);
+
+        Planner::SchedulePlan expectedPlan = Reference::schedule(assignments, testCase.weekdayStudyHours,
+                                                                 testCase.weekendStudyHours, testCase.engine);
+        const std::string expected = Reference::calendarBytes(assignments, expectedPlan, startDay, stamp);
+
+        Planner::SchedulePlan plan;
+        auto items = Planner::makeWorkItems(assignments);
+        Planner::simulate(items, testCase.weekdayStudyHours, testCase.weekendStudyHours, testCase.engine, &plan);
+        auto events = Planner::planEvents(assignments, plan, startDay);
+        auto delta = Planner::diffCalendar(events, Planner::CalendarFeed(), stamp);
+        std::ostringstream output;
+        Planner::writeCalendar(output, events, delta.revision);
+        const std::string actual = output.str();
+
+        if (actual == expected)
+            return "";
+        std::size_t at = 0;
+        while (at < actual.size() && at < expected.size() && actual[at] == expected[at])
+            ++at;
+        std::size_t line = expected.rfind('\n', at == 0 ? 0 : at - 1);
+        line = line == std::string::npos ? 0 : line + 1;
+        return "feeds differ at byte " + std::to_string(at) + ": expected \"" + expected.substr(line, expected.find('\n', line) - line) +
+               "\", got \"" + actual.substr(line, actual.find('\n', line) - line) + "\"\n";
+    }
+
+    // saveToFile and a save after loadFromFile against the frozen format
+    std::string compareSaveBytes(const Differential::Case& testCase) {
+        Planner::AssignmentStore assignments;
+        Differential::fillStore(testCase, assignments);
+        const std::string expected = Reference::saveBytes(assignments);
+
+        const std::string filename = "test_differential.json";
+        Planner::saveToFile(filename, assignments);
+        std::string saved = readFile(filename);
+        std::string reloaded = Reference::saveBytes(Planner::loadFromFile(filename));
+        std::remove(filename.c_str());
+
+        if (saved != expected)
+            return "saveToFile wrote:\n" + saved + "\nexpected:\n" + expected + "\n";
+        if (reloaded != expected)
+            return "loadFromFile read back:\n" + reloaded + "\nexpected:\n" + expected + "\n";
+        return "";
+    }
+}
+
+// Test both simulation engines reproduce the reference scheduler exactly
+TEST(DifferentialTest, Schedule_MatchesReference) {
+    std::string failure = Differential::run(compareSchedules, firstSeed(), caseCount());
+    EXPECT_TRUE(failure.empty()) << failure;
+}
+
+// Test the written calendar feed reproduces the reference bytes exactly
+TEST(DifferentialTest, Calendar_MatchesReference) {
+    std::string failure = Differential::run(compareCalendarBytes, firstSeed(), caseCount() / 10);
+    EXPECT_TRUE(failure.empty()) << failure;
+}
+
+// Test saving and reloading reproduce the reference bytes exactly
+TEST(DifferentialTest, SaveAndLoad_MatchReference) {
+    std::string failure = Differential::run(compareSaveBytes, firstSeed(), caseCount() / 10, 10);
+    EXPECT_TRUE(failure.empty()) << failure;
+}
+
+// Test a failing case is shrunk to its minimal form
+TEST(DifferentialTest, Shrink_FindsMinimalReproducer) {
+    // Fails whenever two assignments take at least five hours
+    auto check = [](const Differential::Case& testCase) -> std::string {
+        int longOnes = 0;
+        for (const auto& record : testCase.records)
+            longOnes += record.duration >= 5;
+        return longOnes >= 2 ? "two long assignments" : "";
+    };
+
+    Differential::Case failing;
+    for (std::uint64_t seed = 1; check(failing).empty(); ++seed)
+        failing = Differential::randomCase(seed);
+
+    Differential::Case minimal = Differential::shrink(failing, check);
+    ASSERT_EQ(minimal.records.size(), 2u);
+    EXPECT_EQ(minimal.weekdayStudyHours, 0);
+    EXPECT_EQ(minimal.weekendStudyHours, 0);
+    for (const auto& record : minimal.records) {
+        EXPECT_EQ(record.duration, 5);
+        EXPECT_EQ(record.deadline, 1);
+        EXPECT_EQ(record.subject, "S");
+        EXPECT_FALSE(record.groupWork);
+    }
+}
@@ -2,18 +2,11 @@
 #include "../include/displayfunctions.hpp"
 #include "../include/assignment.hpp"
 #include <vector>
-#include <memory>
 #include <sstream>
 
-// Helper function to create shared_ptr<Assignment>
-static std::shared_ptr<Assignment> createAssignment(const std::string& subject, const std::string& name, int deadline,
-                                                    int duration, float weight, int size, bool groupWork, int groupSize) {
-    return std::make_shared<Assignment>(subject, name, deadline, duration, weight, size, groupWork, groupSize);
-}
-
 // Test DisplayFunctions::displayAllAssignments with empty assignments list
 TEST(DisplayFunctionsTest, DisplayAllAssignments_Empty) {
-    std::vector<DisplayFunctions::AssignmentPtr> assignments;
+    Planner::AssignmentStore assignments;
 
     testing::internal::CaptureStdout();
     DisplayFunctions::displayAllAssignments(assignments);
@@ -24,10 +17,9 @@ TEST(DisplayFunctionsTest, DisplayAllAssignments_Empty) {
 
 // Test DisplayFunctions::displayAllAssignments with valid assignments
 TEST(DisplayFunctionsTest, DisplayAllAssignments_NonEmpty) {
-    auto assignment1 = createAssignment("Math", "Math Homework", 5, 10, 20.0, 1, false, 1);
-    auto assignment2 = createAssignment("Science", "Science Project", 7, 15, 25.0, 1, false, 1);
-
-    std::vector<DisplayFunctions::AssignmentPtr> assignments = {assignment1, assignment2};
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 5, 10, 20.0, 1, false, 1);
+    assignments.emplace("Science", "Science Project", 7, 15, 25.0, 1, false, 1);
 
     testing::internal::CaptureStdout();
     DisplayFunctions::displayAllAssignments(assignments);
@@ -63,9 +55,8 @@ TEST(DisplayFunctionsTest, DisplayAllAssignments_NonEmpty) {
 
 // Test DisplayFunctions::displayAssignmentsBySubject with no match
 TEST(DisplayFunctionsTest, DisplayAssignmentsBySubject_NoMatch) {
-    auto assignment = createAssignment("Math", "Math Homework", 5, 10, 20.0, 1, false, 1);
-
-    std::vector<DisplayFunctions::AssignmentPtr> assignments = {assignment};
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 5, 10, 20.0, 1, false, 1);
 
     testing::internal::CaptureStdout();
     DisplayFunctions::displayAssignmentsBySubject(assignments, "Science");
@@ -76,10 +67,9 @@ TEST(DisplayFunctionsTest, DisplayAssignmentsBySubject_NoMatch) {
 
 // Test DisplayFunctions::displayAssignmentsBySubject with a match
 TEST(DisplayFunctionsTest, DisplayAssignmentsBySubject_MatchFound) {
-    auto assignment1 = createAssignment("Math", "Math Homework", 5, 10, 20.0, 1, false, 1);
-    auto assignment2 = createAssignment("Science", "Science Project", 7, 15, 25.0, 1, false, 1);
-
-    std::vector<DisplayFunctions::AssignmentPtr> assignments = {assignment1, assignment2};
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 5, 10, 20.0, 1, false, 1);
+    assignments.emplace("Science", "Science Project", 7, 15, 25.0, 1, false, 1);
 
     testing::internal::CaptureStdout();
     DisplayFunctions::displayAssignmentsBySubject(assignments, "Math");
@@ -104,10 +94,9 @@ TEST(DisplayFunctionsTest, DisplayAssignmentsBySubject_MatchFound) {
 
 // Test DisplayFunctions::displayAssignmentsByShortestDeadline
 TEST(DisplayFunctionsTest, DisplayAssignmentsByShortestDeadline) {
-    auto assignment1 = createAssignment("Math", "Math Homework", 5, 10, 20.0, 1, false, 1);
-    auto assignment2 = createAssignment("Science", "Science Project", 3, 15, 25.0, 1, false, 1);
-
-    std::vector<DisplayFunctions::AssignmentPtr> assignments = {assignment1, assignment2};
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 5, 10, 20.0, 1, false, 1);
+    assignments.emplace("Science", "Science Project", 3, 15, 25.0, 1, false, 1);
 
     testing::internal::CaptureStdout();
     DisplayFunctions::displayAssignmentsByShortestDeadline(assignments);
@@ -143,10 +132,9 @@ TEST(DisplayFunctionsTest, DisplayAssignmentsByShortestDeadline) {
 
 // Test DisplayFunctions::displayAssignmentsByBiggestDuration
 TEST(DisplayFunctionsTest, DisplayAssignmentsByBiggestDuration) {
-    auto assignment1 = createAssignment("Math", "Math Homework", 5, 10, 20.0, 1, false, 1);
-    auto assignment2 = createAssignment("Science", "Science Project", 7, 15, 25.0, 1, false, 1);
-
-    std::vector<DisplayFunctions::AssignmentPtr> assignments = {assignment1, assignment2};
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 5, 10, 20.0, 1, false, 1);
+    assignments.emplace("Science", "Science Project", 7, 15, 25.0, 1, false, 1);
 
     testing::internal::CaptureStdout();
     DisplayFunctions::displayAssignmentsByBiggestDuration(assignments);
@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+#include "../include/feasibility.hpp"
+#include "../include/assignment.hpp"
+#include "../include/calendar.hpp"
+#include <vector>
+#include <string>
+
+// Test Planner::isFeasible with enough capacity
+TEST(FeasibilityTest, IsFeasible_EnoughCapacity) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 2, 4, 20.0, 1, false, 1);
+    assignments.emplace("Science", "Science Project", 3, 6, 25.0, 2, false, 1);
+
+    // Days 1-3 give 9 hours, with 4 needed by day 2
+    EXPECT_TRUE(Planner::isFeasible(assignments, 4, 4));
+}
+
+// Test Planner::isFeasible when an early deadline overflows
+TEST(FeasibilityTest, IsFeasible_EarlyDeadlineOverflows) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 1, 5, 20.0, 1, false, 1);
+    assignments.emplace("Science", "Science Project", 10, 1, 25.0, 2, false, 1);
+
+    EXPECT_FALSE(Planner::isFeasible(assignments, 4, 8));
+    EXPECT_TRUE(Planner::isFeasible(assignments, 5, 8));
+}
+
+// Test Planner::isFeasible uses group-adjusted durations
+TEST(FeasibilityTest, IsFeasible_GroupWork) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Group Project", 1, 12, 20.0, 1, true, 4);
+
+    EXPECT_TRUE(Planner::isFeasible(assignments, 3, 3));
+    EXPECT_FALSE(Planner::isFeasible(assignments, 2, 2));
+}
+
+// Test Planner::minimalBudget finds the boundary
+TEST(FeasibilityTest, MinimalBudget) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 2, 7, 20.0, 1, false, 1);
+    assignments.emplace("Science", "Science Project", 4, 9, 25.0, 2, false, 1);
+
+    int budget = Planner::minimalBudget(assignments);
+
+    EXPECT_EQ(budget, 4);
+    EXPECT_TRUE(Planner::isFeasible(assignments, budget, budget));
+    EXPECT_FALSE(Planner::isFeasible(assignments, budget - 1, budget - 1));
+}
+
+// Test Planner::minimalBudget when nothing fits
+TEST(FeasibilityTest, MinimalBudget_Infeasible) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 1, 30, 20.0, 1, false, 1);
+
+    EXPECT_EQ(Planner::minimalBudget(assignments), -1);
+    EXPECT_EQ(Planner::minimalBudget({}), 0);
+}
+
+// Test Planner::minimalBudget on real dates accounts for holidays
+TEST(FeasibilityTest, MinimalBudget_Holidays) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 2, 7, 20.0, 1, false, 1);
+    assignments.emplace("Science", "Science Project", 4, 9, 25.0, 2, false, 1);
+
+    EXPECT_EQ(Planner::minimalBudget(assignments, Planner::today(), {}), 4);
+
+    // With tomorrow off, the homework must fit into day 2 alone
+    std::vector<Planner::Holiday> holidays{{Planner::today() + 1, 0}};
+    EXPECT_EQ(Planner::minimalBudget(assignments, Planner::today(), holidays), 7);
+}
@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+#include "../include/filter.hpp"
+#include "../include/assignment.hpp"
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static Planner::AssignmentStore makeStore(int count) {
+    static const char* subjects[] = {"Math", "Physics", "History", "Art"};
+    Planner::AssignmentStore assignments;
+    for (int i = 0; i < count; ++i) {
+        // Art is rare, so subject filters on it go through the subject index
+        const char* subject = i % 50 == 0 ? subjects[3] : subjects[i % 3];
+        assignments.emplace(subject, "Task " + std::to_string(i), (i * 37) % 120, 1 + (i * 13) % 20,
+                            static_cast<float>((i * 7) % 30) + 0.5f, 1 + i % 3, i % 4 == 0, 1 + i % 5);
+    }
+    return assignments;
+}
+
+// Test columns hold each field in store order, with subjects numbered in sorted order
+TEST(FilterTest, Columns) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Physics", "Lab", 10, 4, 12.0f, 2, true, 2);
+    assignments.emplace("Math", "Quiz", 3, 1, 5.0f, 1, false, 1);
+    assignments.emplace("Physics", "Essay", 3, 6, 20.0f, 3, false, 1);
+    assignments.rebase(assignments.epochDay() - 2); // Stored two days ago, deadlines still count from today
+
+    auto columns = Planner::makeAssignmentColumns(assignments);
+    ASSERT_EQ(columns.rows(), 3u);
+    EXPECT_EQ(columns.deadline, (std::vector<int>{10, 3, 3}));
+    EXPECT_EQ(columns.realDuration, (std::vector<int>{2, 1, 6}));
+    EXPECT_EQ(columns.subjects, (std::vector<std::string>{"Math", "Physics"}));
+    EXPECT_EQ(columns.subject, (std::vector<std::uint32_t>{1, 0, 1}));
+    EXPECT_EQ(columns.subjectRows[1], (std::vector<std::uint32_t>{0, 2}));
+    EXPECT_EQ(columns.byDeadline, (std::vector<std::uint32_t>{1, 2, 0}));
+}
+
+// Test scans and index lookups agree with testing every assignment directly
+TEST(FilterTest, MatchesDirectEvaluation) {
+    auto assignments = makeStore(5000);
+    auto columns = Planner::makeAssignmentColumns(assignments);
+
+    const std::vector<std::pair<std::string, std::function<bool(const Assignment&)>>> cases = {
+        {"deadline < 7 && weight >= 15 && group_work",
+         [](const Assignment& a) { return a.getDeadline() < 7 && a.getWeight() >= 15 && a.isGroupWork(); }},
+        {"subject == \"Art\" && size != 2",
+         [](const Assignment& a) { return a.getSubject() == "Art" && a.getSize() != 2; }},
+        {"subject == Math || deadline >= 100",
+         [](const Assignment& a) { return a.getSubject() == "Math" || a.getDeadline() >= 100; }},
+        {"!(duration > 10 || real_duration <= 2) && group_size == 3",
+         [](const Assignment& a) { return !(a.getDuration() > 10 || a.getRealDuration() <= 2) && a.getGroupSize() == 3; }},
+        {"deadline == 5 && group_work == false",
+         [](const Assignment& a) { return a.getDeadline() == 5 && !a.isGroupWork(); }},
+        {"deadline > 3 && deadline <= 4",
+         [](const Assignment& a) { return a.getDeadline() > 3 && a.getDeadline() <= 4; }},
+        {"weight < 10.5 && subject != 'Physics'",
+         [](const Assignment& a) { return a.getWeight() < 10.5f && a.getSubject() != "Physics"; }},
+        {"subject == Chemistry", [](const Assignment&) { return false; }},
+        {"deadline < 3 && deadline > 5", [](const Assignment&) { return false; }},
+    };
+
+    const auto& handles = assignments.handles();
+    for (const auto& [expression, predicate] : cases) {
+        std::vector<std::uint32_t> expected;
+        for (std::uint32_t row = 0; row < handles.size(); ++row) {
+            if (predicate(assignments[handles[row]]))
+                expected.push_back(row);
+        }
+        EXPECT_EQ(Planner::AssignmentFilter(expression).select(columns), expected) << expression;
+    }
+}
+
+// Test malformed expressions are rejected when parsed
+TEST(FilterTest, RejectsMalformedExpressions) {
+    for (const char* expression : {"", "deadline <", "colour == 3", "deadline < 7 &&", "(size == 1", "subject < Math",
+                                   "size == 1.5", "group_work == 3", "deadline < 7 ]", "subject == \"Math"}) {
+        EXPECT_THROW(Planner::AssignmentFilter{expression}, std::invalid_argument) << expression;
+    }
+}
+
+// Test an empty plan matches nothing, whichever index the expression could use
+TEST(FilterTest, EmptyStore) {
+    auto columns = Planner::makeAssignmentColumns(Planner::AssignmentStore());
+    for (const char* expression : {"deadline < 7", "subject == Math", "size == 1", "deadline < 7 && subject == Math"})
+        EXPECT_TRUE(Planner::AssignmentFilter(expression).select(columns).empty()) << expression;
+}
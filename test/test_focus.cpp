@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+#include "../include/focus.hpp"
+#include "../include/assignment.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+// Hours per assignment, handing out each hour to the best of every assignment
+static std::map<std::uint32_t, int> referenceFocus(const Planner::AssignmentStore& assignments, int studyHours) {
+    struct Open { int score, dueDay, remaining; float weight; int size; std::uint32_t index; bool done; };
+    std::vector<Open> open;
+    const auto& handles = assignments.handles();
+    for (std::uint32_t i = 0; i < handles.size(); ++i) {
+        const Assignment& a = assignments[handles[i]];
+        open.push_back({Planner::calculatePriority(a.getDeadline(), a.getRealDuration(), a.getWeight(), a.getSize(), studyHours),
+                        a.getDeadline(), a.getRealDuration(), a.getWeight(), a.getSize(), i, false});
+    }
+
+    std::map<std::uint32_t, int> hours;
+    for (int hour = 0; hour < studyHours; ++hour) {
+        Open* best = nullptr;
+        for (Open& item : open) {
+            if (item.done)
+                continue;
+            if (!best || item.score > best->score || (item.score == best->score && item.dueDay < best->dueDay))
+                best = &item;
+        }
+        if (!best)
+            break;
+        ++hours[best->index];
+        if (--best->remaining > 0)
+            best->score = Planner::calculatePriority(best->dueDay, best->remaining, best->weight, best->size, studyHours);
+        else
+            best->done = true;
+    }
+    return hours;
+}
+
+// Test today's hours go where the scheduler puts them on its first day
+TEST(FocusTest, MatchesFirstScheduledDay) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("History", "Essay", 30, 2, 5.0f, 1, false, 1);
+    assignments.emplace("Math", "Exam prep", 1, 3, 25.0f, 3, false, 1);
+    assignments.emplace("Physics", "Lab report", 4, 4, 12.0f, 2, false, 1);
+
+    Planner::ScheduleOptions options;
+    options.weekdayStudyHours = 4;
+    options.weekendStudyHours = 4;
+    auto tasks = Planner::todaysFocus(assignments, options);
+
+    Planner::ScheduleGenerator generator(assignments, options);
+    Planner::ScheduleDay day;
+    ASSERT_TRUE(generator.next(day));
+    std::map<std::uint32_t, int> expected;
+    for (const auto& slot : day.slots)
+        ++expected[slot.assignment];
+
+    std::map<std::uint32_t, int> actual;
+    int total = 0;
+    for (const auto& task : tasks) {
+        actual[task.assignment] = task.hours;
+        total += task.hours;
+    }
+    EXPECT_EQ(actual, expected);
+    EXPECT_EQ(total, 4);
+    ASSERT_FALSE(tasks.empty());
+    EXPECT_EQ(tasks[0].assignment, 1u); // The exam due tomorrow comes first
+}
+
+// Test the top-k selection agrees with handing out every hour over all assignments
+TEST(FocusTest, MatchesExhaustiveSelection) {
+    Planner::AssignmentStore assignments;
+    for (int i = 0; i < 500; ++i)
+        assignments.emplace("Math", "Homework " + std::to_string(i), 1 + (i * 37) % 60, (i * 11) % 7,
+                            5.0f + (i * 13) % 20, 1 + i % 3, i % 4 == 0, 1 + i % 4);
+
+    for (int hours : {1, 3, 8, 24}) {
+        Planner::ScheduleOptions options;
+        options.weekdayStudyHours = hours;
+        options.weekendStudyHours = hours;
+
+        std::map<std::uint32_t, int> actual;
+        for (const auto& task : Planner::todaysFocus(assignments, options))
+            actual[task.assignment] = task.hours;
+        EXPECT_EQ(actual, referenceFocus(assignments, hours)) << hours << " hours";
+    }
+}
+
+// Test a day without study time or without assignments has nothing to do
+TEST(FocusTest, NothingToDo) {
+    Planner::AssignmentStore assignments;
+    Planner::ScheduleOptions options;
+    options.weekdayStudyHours = 3;
+    options.weekendStudyHours = 3;
+    EXPECT_TRUE(Planner::todaysFocus(assignments, options).empty());
+
+    assignments.emplace("Math", "Homework", 3, 2, 10.0f, 1, false, 1);
+    Planner::Availability availability;
+    for (int weekday = 0; weekday < 7; ++weekday)
+        availability.addWeekly(weekday, 0, 24 * 60);
+    options.availability = &availability;
+    options.startDay = Planner::today();
+    EXPECT_TRUE(Planner::todaysFocus(assignments, options).empty());
+
+    options.availability = nullptr;
+    auto tasks = Planner::todaysFocus(assignments, options);
+    ASSERT_EQ(tasks.size(), 1u);
+    EXPECT_EQ(tasks[0].hours, 2); // Finished before the day's hours run out
+}
@@ -0,0 +1,148 @@
+#include "gtest/gtest.h"
+#include "../include/groupslots.hpp"
+#include "../include/calendar.hpp"
+#include "../include/assignment.hpp"
+#include "../include/simulation.hpp"
+#include <vector>
+
+static const int Monday = Planner::dayNumber(2024, 1, 1);
+
+using Planner::minuteAt;
+
+// Test single bits across word and week boundaries
+TEST(GroupSlotsTest, HourMaskBits) {
+    Planner::HourMask mask(Monday, 2);
+    EXPECT_EQ(mask.hours(), 2 * Planner::HoursPerWeek);
+    EXPECT_EQ(mask.count(), 0);
+    EXPECT_EQ(mask.nextFree(0), -1);
+
+    for (int hour : {0, 63, 64, 127, 128, 167, 168, 335})
+        mask.setFree(hour, true);
+    mask.setFree(336, true); // Past the end, ignored
+
+    EXPECT_EQ(mask.count(), 8);
+    EXPECT_EQ(mask.count(64, 168), 4);
+    EXPECT_TRUE(mask.isFree(167));
+    EXPECT_FALSE(mask.isFree(166));
+    EXPECT_EQ(mask.nextFree(1), 63);
+    EXPECT_EQ(mask.nextFree(129), 167);
+    EXPECT_EQ(mask.nextFree(169), 335);
+
+    mask.setFree(63, false);
+    EXPECT_EQ(mask.nextFree(1), 64);
+}
+
+// Test masks built from availabilities keep only the hours everyone has free
+TEST(GroupSlotsTest, CommonFreeHours) {
+    Planner::Availability first, second;
+    first.setStudyWindow(18, 22);
+    second.setStudyWindow(18, 22);
+    first.addWeekly(0, 18 * 60, 20 * 60); // Mondays 18:00-20:00
+    second.addWeekly(0, 20 * 60, 22 * 60); // Mondays 20:00-22:00
+    second.addBusy(minuteAt(Monday + 8, 19), minuteAt(Monday + 8, 20)); // Once, on the second Tuesday
+
+    std::vector<Planner::HourMask> masks{Planner::HourMask::fromAvailability(first, Monday, 2),
+                                         Planner::HourMask::fromAvailability(second, Monday, 2)};
+    EXPECT_EQ(masks[0].count(), 14 * 4 - 2 * 2);
+    EXPECT_EQ(masks[1].count(), 14 * 4 - 2 * 2 - 1);
+
+    auto common = Planner::commonFreeHours(masks);
+    EXPECT_EQ(common.count(), 12 * 4 - 1);
+    EXPECT_EQ(common.count(0, 24), 0); // Nothing shared on Monday
+    EXPECT_EQ(common.nextFree(0), 24 + 18);
+    EXPECT_FALSE(common.isFree(8 * 24 + 19));
+}
+
+// Test group assignments share the earliest common hours, by deadline
+TEST(GroupSlotsTest, PlanGroupSessions) {
+    Planner::Availability first, second;
+    first.setStudyWindow(18, 22);
+    second.setStudyWindow(18, 22);
+    first.addWeekly(0, 18 * 60, 20 * 60);
+    second.addWeekly(0, 20 * 60, 22 * 60);
+
+    Planner::AssignmentStore assignments;
+    assignments.setEpochDay(Monday);
+    assignments.emplace("Physics", "Lab report", 1, 6, 10.0f, 2, true, 2); // 3 hours each, due Tuesday
+    assignments.emplace("Math", "Homework", 0, 4, 10.0f, 1, false, 1); // Individual work
+    assignments.emplace("History", "Poster", 1, 4, 10.0f, 2, true, 2); // 2 hours each, due Tuesday
+    assignments.emplace("Chemistry", "Project", 20, 3, 10.0f, 2, true, 1); // 3 hours, due much later
+
+    auto plan = Planner::planGroupSessions(assignments, {&first, &second}, Monday, 4, 4);
+
+    ASSERT_EQ(plan.sessions.size(), 3u);
+    EXPECT_EQ(plan.sessions[0].assignment, 0u);
+    EXPECT_EQ(plan.sessions[0].day, Monday + 1);
+    EXPECT_EQ(plan.sessions[0].startHour, 18);
+    EXPECT_EQ(plan.sessions[0].hours, 3);
+    EXPECT_EQ(plan.sessions[1].assignment, 2u);
+    EXPECT_EQ(plan.sessions[1].startHour, 21);
+    EXPECT_EQ(plan.sessions[1].hours, 1);
+    EXPECT_EQ(plan.sessions[2].assignment, 3u);
+    EXPECT_EQ(plan.sessions[2].day, Monday + 2);
+    EXPECT_EQ(plan.sessions[2].hours, 3);
+
+    ASSERT_EQ(plan.shortfalls.size(), 1u);
+    EXPECT_EQ(plan.shortfalls[0].assignment, 2u);
+    EXPECT_EQ(plan.shortfalls[0].hours, 1);
+
+    // Reserved sessions are busy time for each member's own plan
+    Planner::reserveGroupSessions(first, assignments, plan.sessions);
+    EXPECT_FALSE(first.isFree(minuteAt(Monday + 1, 20), minuteAt(Monday + 1, 21)));
+    EXPECT_TRUE(first.isFree(minuteAt(Monday + 2, 21), minuteAt(Monday + 2, 22)));
+}
+
+// Test a long group task is spread over study days instead of running through the night
+TEST(GroupSlotsTest, DailyCap) {
+    Planner::Availability first, second; // The default window, 18:00 to 18:00 the next day
+
+    Planner::AssignmentStore assignments;
+    assignments.setEpochDay(Monday);
+    assignments.emplace("Physics", "Project", 10, 12, 10.0f, 1, true, 1);
+
+    auto plan = Planner::planGroupSessions(assignments, {&first, &second}, Monday, 2, 3);
+    ASSERT_EQ(plan.sessions.size(), 4u);
+    for (std::size_t i = 0; i < plan.sessions.size(); ++i) {
+        EXPECT_EQ(plan.sessions[i].day, Monday + static_cast<int>(i));
+        EXPECT_EQ(plan.sessions[i].startHour, 18);
+        EXPECT_EQ(plan.sessions[i].hours, 3);
+    }
+    EXPECT_TRUE(plan.shortfalls.empty());
+}
+
+// Test planning again replaces the earlier sessions, and reserved hours leave the individual plan
+TEST(GroupSlotsTest, ReplanAndCoveredHours) {
+    Planner::Availability first, second;
+    first.setStudyWindow(18, 22);
+    second.setStudyWindow(18, 22);
+
+    Planner::AssignmentStore assignments;
+    assignments.setEpochDay(Planner::today());
+    assignments.emplace("Physics", "Lab report", 5, 4, 10.0f, 2, true, 2); // 2 hours each, all in a session
+    assignments.emplace("History", "Poster", 2, 6, 10.0f, 2, true, 1); // 6 hours, only 4 before it is due
+    assignments.emplace("Math", "Homework", 5, 3, 10.0f, 2, false, 1); // Individual work
+
+    for (int run = 0; run < 2; ++run) {
+        Planner::releaseGroupSessions(first, assignments);
+        Planner::releaseGroupSessions(second, assignments);
+        auto plan = Planner::planGroupSessions(assignments, {&first, &second}, Planner::today() + 1, 1, 2);
+        Planner::reserveGroupSessions(first, assignments, plan.sessions);
+        Planner::reserveGroupSessions(second, assignments, plan.sessions);
+    }
+    EXPECT_EQ(first.reservations().size(), 2u);
+    EXPECT_EQ(Planner::reservedGroupHours(assignments[assignments.handles()[0]], first), 2);
+    EXPECT_EQ(Planner::reservedGroupHours(assignments[assignments.handles()[1]], first), 4);
+
+    auto items = Planner::makeWorkItems(assignments, &first);
+    EXPECT_TRUE(items[0].covered);
+    EXPECT_FALSE(items[1].covered);
+    EXPECT_EQ(items[1].remainingHours, 2);
+    EXPECT_EQ(items[2].remainingHours, 3);
+
+    // Only the hours left outside the sessions are studied alone
+    Planner::ScheduleOptions options;
+    options.weekdayStudyHours = options.weekendStudyHours = 4;
+    auto stats = Planner::simulate(items, options);
+    EXPECT_EQ(stats.scheduledHours, 5);
+    EXPECT_EQ(stats.missedDeadlines, 0);
+}
@@ -0,0 +1,144 @@
+#include "gtest/gtest.h"
+#include "../include/gzipstream.hpp"
+#include "../include/icsexport.hpp"
+#include "../include/planner.hpp"
+#include "../include/json.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+static std::string readAll(std::istream& input) {
+    return std::string((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+}
+
+// Test text spanning several chunks survives a compressed round trip
+TEST(GzipStreamTest, RoundTrip_ManyChunks) {
+    std::string text;
+    for (int i = 0; text.size() < 300 * 1024; ++i)
+        text += "Hour " + std::to_string(i % 8) + ": Assignment " + std::to_string(i) + "\n";
+
+    const std::string filename = "test_gzipstream.txt.gz";
+    {
+        Planner::OutputFile file(filename);
+        ASSERT_TRUE(file.isOpen());
+        file.stream() << text;
+        EXPECT_TRUE(file.close());
+    }
+    EXPECT_LT(std::filesystem::file_size(filename), text.size() / 4);
+
+    {
+        Planner::InputFile file(filename);
+        ASSERT_TRUE(file.isOpen());
+        EXPECT_TRUE(file.isCompressed());
+        EXPECT_EQ(readAll(file.stream()), text);
+    }
+    std::remove(filename.c_str());
+}
+
+// Test files without a .gz name are written and read as plain text
+TEST(GzipStreamTest, PlainFilesPassThrough) {
+    const std::string filename = "test_gzipstream.txt";
+    {
+        Planner::OutputFile file(filename);
+        file.stream() << "plain text\n";
+        EXPECT_TRUE(file.close());
+    }
+
+    std::ifstream raw(filename);
+    EXPECT_EQ(readAll(raw), "plain text\n");
+
+    Planner::InputFile file(filename);
+    EXPECT_FALSE(file.isCompressed());
+    EXPECT_EQ(readAll(file.stream()), "plain text\n");
+    std::remove(filename.c_str());
+
+    EXPECT_FALSE(Planner::InputFile("missing_gzipstream.txt").isOpen());
+}
+
+// Test a compressed user file holds exactly the plain save format
+TEST(GzipStreamTest, SaveAndLoad_Compressed) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Homework 1", 5, 4, 20.0f, 2, false, 1);
+    assignments.emplace("Physics", "Lab \"Report\"", 3, 6, 25.0f, 3, true, 2);
+
+    Planner::saveToFile("test_gzipstream.json", assignments);
+    Planner::saveToFile("test_gzipstream.json.gz", assignments);
+
+    std::ifstream plain("test_gzipstream.json");
+    Planner::InputFile compressed("test_gzipstream.json.gz");
+    EXPECT_TRUE(compressed.isCompressed());
+    EXPECT_EQ(readAll(compressed.stream()), readAll(plain));
+
+    auto loaded = Planner::loadFromFile("test_gzipstream.json.gz");
+    ASSERT_EQ(loaded.size(), 2);
+    EXPECT_EQ(loaded[loaded.handles()[1]].getName(), "Lab \"Report\"");
+    EXPECT_EQ(loaded[loaded.handles()[1]].getGroupSize(), 2);
+
+    std::remove("test_gzipstream.json");
+    std::remove("test_gzipstream.json.gz");
+}
+
+// Test a compressed calendar feed reads back like a plain one
+TEST(GzipStreamTest, CalendarFeed_Compressed) {
+    Planner::CalendarEvent event;
+    event.uid = "a-1@study-planner";
+    event.summary = "Math Homework";
+    event.start = "20240902T180000";
+    event.end = "20240902T190000";
+    event.stamp = "20240901T000000Z";
+    event.sequence = 3;
+
+    const std::string filename = "test_gzipstream.ics.gz";
+    {
+        Planner::OutputFile file(filename);
+        Planner::writeCalendar(file.stream(), {event}, 3);
+        EXPECT_TRUE(file.close());
+    }
+
+    Planner::CalendarFeed feed = Planner::readCalendarFeed(filename);
+    std::remove(filename.c_str());
+    EXPECT_EQ(feed.revision, 3);
+    ASSERT_EQ(feed.events.size(), 1);
+    EXPECT_EQ(feed.events[0].uid, event.uid);
+    EXPECT_EQ(feed.events[0].start, event.start);
+}
+
+// Test a stream cut off before its end is reported, and a whole one is not
+TEST(GzipStreamTest, TruncatedStream) {
+    std::string text(100000, 'a');
+    for (std::size_t i = 0; i < text.size(); i += 7)
+        text[i] = static_cast<char>('a' + i % 26);
+    const std::string compressed = Planner::gzipCompress(text);
+
+    {
+        std::stringbuf source(compressed);
+        Planner::GzipInputBuffer gzip(&source);
+        std::istream input(&gzip);
+        EXPECT_EQ(readAll(input), text);
+        EXPECT_FALSE(gzip.failed());
+    }
+
+    // Missing only the trailer, and missing part of the data
+    for (std::size_t cut : {compressed.size() - 4, compressed.size() / 2}) {
+        std::stringbuf source(compressed.substr(0, cut));
+        Planner::GzipInputBuffer gzip(&source);
+        std::istream input(&gzip);
+        EXPECT_LE(readAll(input).size(), text.size());
+        EXPECT_TRUE(gzip.failed());
+    }
+}
+
+// Test the saved text is exactly what the JSON library prints for it
+TEST(GzipStreamTest, SaveFormat) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Homework 1", 5, 4, 20.5f, 2, false, 1);
+    assignments.emplace("Physics", "Lab \"Report\"\n", 3, 6, 10.1f, 3, true, 2);
+
+    std::string contents = Planner::formatPlanFile(assignments);
+    EXPECT_EQ(contents, nlohmann::json::parse(contents).dump(4));
+    EXPECT_EQ(Planner::formatPlanFile(Planner::AssignmentStore()),
+              nlohmann::json::parse(Planner::formatPlanFile(Planner::AssignmentStore())).dump(4));
+}
@@ -0,0 +1,230 @@
+#include "gtest/gtest.h"
+#include "../include/icsexport.hpp"
+#include "../include/calendar.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+static const int StartDay = Planner::dayNumber(2024, 9, 2);
+
+static Planner::AssignmentStore sampleAssignments() {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 2, 3, 20.0, 1, false, 1);
+    assignments.emplace("Science", "Science Project", 4, 4, 25.0, 2, false, 1);
+    return assignments;
+}
+
+static std::vector<Planner::CalendarEvent> plan(const Planner::AssignmentStore& assignments, int weekdayHours,
+                                                const Planner::CalendarOptions& options = Planner::CalendarOptions()) {
+    auto items = Planner::makeWorkItems(assignments);
+    Planner::SchedulePlan schedule;
+    Planner::simulate(items, weekdayHours, weekdayHours, Planner::SchedulerEngine::EarliestDeadline, &schedule);
+    return Planner::planEvents(assignments, schedule, StartDay, options);
+}
+
+// Test UIDs are deterministic and tell assignments, dates and blocks apart
+TEST(IcsExportTest, StudyEventUid) {
+    EXPECT_EQ(Planner::studyEventUid("Math", "HW", 0, StartDay, 1), Planner::studyEventUid("Math", "HW", 0, StartDay, 1));
+    EXPECT_NE(Planner::studyEventUid("Math", "HW", 0, StartDay, 1), Planner::studyEventUid("Math", "HW", 0, StartDay, 2));
+    EXPECT_NE(Planner::studyEventUid("Math", "HW", 0, StartDay, 1), Planner::studyEventUid("Math", "HW", 0, StartDay + 1, 1));
+    EXPECT_NE(Planner::studyEventUid("Math", "HW", 0, StartDay, 1), Planner::studyEventUid("Math", "HW", 1, StartDay, 1));
+    EXPECT_NE(Planner::studyEventUid("Ma", "thHW", 0, StartDay, 1), Planner::studyEventUid("Math", "HW", 0, StartDay, 1));
+    EXPECT_NE(Planner::studyEventUid("Math", "HW", 0, StartDay, 0).find("-20240902-0@"), std::string::npos);
+}
+
+// Test an event keeps its UID when the plan starts a day later
+TEST(IcsExportTest, PlanEvents_UidFollowsDate) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 5, 3, 20.0, 1, false, 1);
+
+    Planner::SchedulePlan first;
+    first.slots = {{0, 1, 0, 18}, {0, 2, 0, 18}, {0, 2, 1, 20}};
+    Planner::SchedulePlan next;
+    next.slots = {{0, 0, 0, 18}, {0, 1, 0, 18}, {0, 1, 1, 20}};
+
+    auto before = Planner::planEvents(assignments, first, StartDay);
+    auto after = Planner::planEvents(assignments, next, StartDay + 1);
+    ASSERT_EQ(before.size(), 3);
+    ASSERT_EQ(after.size(), 3);
+    for (std::size_t i = 0; i < before.size(); ++i)
+        EXPECT_EQ(before[i].uid, after[i].uid);
+    EXPECT_NE(before[1].uid, before[2].uid);
+}
+
+// Test plan events carry local times from the plan's start day
+TEST(IcsExportTest, PlanEvents_Times) {
+    Planner::CalendarOptions options;
+    options.coalesce = false;
+    auto events = plan(sampleAssignments(), 2, options);
+
+    ASSERT_EQ(events.size(), 7);
+    EXPECT_EQ(events[0].summary, "Math Homework");
+    EXPECT_EQ(events[0].start, "20240903T180000");
+    EXPECT_EQ(events[0].end, "20240903T190000");
+}
+
+// Test consecutive hours of one assignment become a single block
+TEST(IcsExportTest, PlanEvents_Coalesce) {
+    auto events = plan(sampleAssignments(), 2);
+
+    // Math fills day 1 and the first hour of day 2; science the rest
+    ASSERT_EQ(events.size(), 5);
+    EXPECT_EQ(events[0].start, "20240903T180000");
+    EXPECT_EQ(events[0].end, "20240903T200000");
+    EXPECT_EQ(events[1].end, "20240904T190000");
+    EXPECT_EQ(events[2].summary, "Science Project");
+    EXPECT_EQ(events[3].start, "20240905T180000");
+    EXPECT_EQ(events[3].end, "20240905T200000");
+    EXPECT_TRUE(events[0].rule.empty());
+}
+
+// Test identical blocks on consecutive days fold into a daily rule
+TEST(IcsExportTest, PlanEvents_DailyRules) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("History", "Essay", 10, 9, 10.0, 2, false, 1);
+
+    Planner::CalendarOptions options;
+    options.dailyRules = true;
+    auto events = plan(assignments, 3, options);
+
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].start, "20240903T180000");
+    EXPECT_EQ(events[0].end, "20240903T210000");
+    EXPECT_EQ(events[0].rule, "FREQ=DAILY;COUNT=3");
+}
+
+// Test an identical rerun produces no changes and keeps the revision
+TEST(IcsExportTest, Diff_NoChanges) {
+    auto assignments = sampleAssignments();
+    auto first = plan(assignments, 2);
+    auto firstDelta = Planner::diffCalendar(first, Planner::CalendarFeed(), "20240902T000000Z");
+    EXPECT_EQ(firstDelta.revision, 1);
+    EXPECT_EQ(firstDelta.changed.size(), first.size());
+
+    Planner::CalendarFeed previous{firstDelta.revision, first};
+    auto second = plan(assignments, 2);
+    auto delta = Planner::diffCalendar(second, previous, "20240903T000000Z");
+
+    EXPECT_EQ(delta.revision, 1);
+    EXPECT_TRUE(delta.changed.empty());
+    EXPECT_TRUE(delta.cancelled.empty());
+    EXPECT_EQ(delta.unchanged, second.size());
+    EXPECT_EQ(second[0].stamp, "20240902T000000Z");
+}
+
+// Test a small edit only touches the affected events
+TEST(IcsExportTest, Diff_SmallEdit) {
+    auto assignments = sampleAssignments();
+    auto first = plan(assignments, 2);
+    auto firstDelta = Planner::diffCalendar(first, Planner::CalendarFeed(), "20240902T000000Z");
+    Planner::CalendarFeed previous{firstDelta.revision, first};
+
+    // One hour less on the science project cancels its last hour
+    assignments.get(assignments.handles()[1]).decreaseDuration(1);
+    auto second = plan(assignments, 2);
+    auto delta = Planner::diffCalendar(second, previous, "20240903T000000Z");
+
+    EXPECT_EQ(delta.revision, 2);
+    EXPECT_TRUE(delta.changed.empty());
+    ASSERT_EQ(delta.cancelled.size(), 1);
+    EXPECT_EQ(delta.cancelled[0].sequence, 2);
+    EXPECT_EQ(delta.unchanged, 4);
+
+    std::ostringstream output;
+    Planner::writeCalendarDelta(output, delta);
+    std::string text = output.str();
+    std::size_t cancel = text.find("METHOD:CANCEL");
+    ASSERT_NE(cancel, std::string::npos);
+    EXPECT_LT(text.find("METHOD:PUBLISH"), cancel);
+    EXPECT_GT(text.find("UID:" + delta.cancelled[0].uid), cancel);
+    EXPECT_NE(text.find("STATUS:CANCELLED"), std::string::npos);
+    EXPECT_EQ(text.find("STATUS:CONFIRMED"), std::string::npos);
+}
+
+// Test a written feed reads back with the same events
+TEST(IcsExportTest, WriteAndReadFeed) {
+    auto events = plan(sampleAssignments(), 2);
+    auto delta = Planner::diffCalendar(events, Planner::CalendarFeed(), "20240902T000000Z");
+
+    const std::string filename = "test_feed.ics";
+    {
+        std::ofstream file(filename);
+        Planner::writeCalendar(file, events, delta.revision);
+    }
+    auto feed = Planner::readCalendarFeed(filename);
+    std::remove(filename.c_str());
+
+    EXPECT_EQ(feed.revision, 1);
+    ASSERT_EQ(feed.events.size(), events.size());
+    EXPECT_EQ(feed.events[3].uid, events[3].uid);
+    EXPECT_EQ(feed.events[3].start, events[3].start);
+    EXPECT_EQ(feed.events[3].stamp, "20240902T000000Z");
+}
+
+// Test names with TEXT special characters and newlines are escaped, folded
+// and read back unchanged, so an identical rerun stays an empty delta
+TEST(IcsExportTest, EscapedTextRoundTrip) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("English", "Essay; draft, v2\nUID:evil \\ notes", 2, 2, 20.0, 1, false, 1);
+    assignments.emplace("English", "A title long enough that its summary line needs folding, twice over if ünïcode "
+                                   "characters land right on the fold ünïcode ünïcode", 3, 1, 10.0, 1, false, 1);
+    auto events = plan(assignments, 3);
+    auto delta = Planner::diffCalendar(events, Planner::CalendarFeed(), "20240902T000000Z");
+
+    std::ostringstream output;
+    Planner::writeCalendar(output, events, delta.revision);
+    const std::string text = output.str();
+    EXPECT_NE(text.find("SUMMARY:Essay\\; draft\\, v2\\nUID:evil \\\\ notes\r\n"), std::string::npos);
+    EXPECT_EQ(text.find("\nUID:evil"), std::string::npos);
+    EXPECT_NE(text.find("\r\n "), std::string::npos);
+
+    // Every line ends in CRLF and holds at most 75 octets
+    for (std::size_t start = 0; start < text.size();) {
+        std::size_t end = text.find("\r\n", start);
+        ASSERT_NE(end, std::string::npos);
+        EXPECT_LE(end - start, 75u);
+        EXPECT_EQ(text.find('\n', start), end + 1);
+        start = end + 2;
+    }
+
+    std::istringstream input(text);
+    Planner::CalendarFeed previous = Planner::readCalendarFeed(input);
+    ASSERT_EQ(previous.events.size(), events.size());
+    EXPECT_EQ(previous.events[0].summary, "Essay; draft, v2\nUID:evil \\ notes");
+    EXPECT_EQ(previous.events.back().summary, assignments[assignments.handles()[1]].getName());
+
+    auto again = plan(assignments, 3);
+    auto rerun = Planner::diffCalendar(again, previous, "20240903T000000Z");
+    EXPECT_TRUE(rerun.changed.empty());
+    EXPECT_TRUE(rerun.cancelled.empty());
+    EXPECT_EQ(rerun.revision, delta.revision);
+}
+
+// Test the scheduler writes a delta file that is empty on an identical rerun
+TEST(IcsExportTest, Scheduler_DeltaOutput) {
+    auto assignments = sampleAssignments();
+    if (!std::filesystem::exists("Data")) {
+        std::filesystem::create_directory("Data");
+    }
+    std::remove("Data/test_delta_schedule.ics");
+
+    testing::internal::CaptureStdout();
+    Planner::scheduler(assignments, 2, 2, "test_delta", Planner::SchedulerEngine::Priority, nullptr,
+                       Planner::CalendarOutput::Delta);
+    Planner::scheduler(assignments, 2, 2, "test_delta", Planner::SchedulerEngine::Priority, nullptr,
+                       Planner::CalendarOutput::Delta);
+    testing::internal::GetCapturedStdout();
+
+    std::ifstream file("Data/test_delta_schedule_delta.ics");
+    ASSERT_TRUE(file.is_open());
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_NE(content.find("X-PLANNER-REVISION:1"), std::string::npos);
+    EXPECT_EQ(content.find("BEGIN:VEVENT"), std::string::npos);
+    EXPECT_EQ(content.find("METHOD:CANCEL"), std::string::npos);
+
+    file.close();
+    std::remove("Data/test_delta_schedule.ics");
+    std::remove("Data/test_delta_schedule_delta.ics");
+}
@@ -0,0 +1,117 @@
+#include "gtest/gtest.h"
+#include "../include/icsimport.hpp"
+#include "../include/calendar.hpp"
+#include <sstream>
+#include <string>
+
+// Monday 2024-09-02
+static const int Monday = Planner::dayNumber(2024, 9, 2);
+
+using Planner::minuteAt;
+
+static Planner::IcsImportStats import(const std::string& events, Planner::Availability& availability,
+                                      int firstDay = Monday, int lastDay = Monday + 120) {
+    std::istringstream input("BEGIN:VCALENDAR\r\nVERSION:2.0\r\n" + events + "END:VCALENDAR\r\n");
+    return Planner::importICS(input, availability, firstDay, lastDay);
+}
+
+// Test a single event becomes one busy interval
+TEST(IcsImportTest, SingleEvent) {
+    Planner::Availability availability;
+    auto stats = import("BEGIN:VEVENT\r\nSUMMARY:Lab\r\nDTSTART:20240903T090000\r\nDTEND:20240903T110000\r\nEND:VEVENT\r\n",
+                        availability);
+
+    EXPECT_EQ(stats.events, 1);
+    EXPECT_EQ(stats.occurrences, 1);
+    EXPECT_FALSE(availability.isFree(minuteAt(Monday + 1, 10), minuteAt(Monday + 1, 11)));
+    EXPECT_TRUE(availability.isFree(minuteAt(Monday + 1, 11), minuteAt(Monday + 1, 12)));
+}
+
+// Test folded lines are joined before parsing
+TEST(IcsImportTest, FoldedLines) {
+    Planner::Availability availability;
+    auto stats = import("BEGIN:VEVENT\r\nSUMMARY:A very long\r\n  summary\r\nDTSTART:20240903T09\r\n 0000\r\n"
+                        "DURATION:PT1H\r\nEND:VEVENT\r\n",
+                        availability);
+
+    EXPECT_EQ(stats.occurrences, 1);
+    EXPECT_FALSE(availability.isFree(minuteAt(Monday + 1, 9), minuteAt(Monday + 1, 10)));
+}
+
+// Test a weekly rule is stored as a pattern limited by UNTIL
+TEST(IcsImportTest, WeeklyRuleBecomesPattern) {
+    Planner::Availability availability;
+    auto stats = import("BEGIN:VEVENT\r\nDTSTART:20240902T140000\r\nDTEND:20240902T160000\r\n"
+                        "RRULE:FREQ=WEEKLY;BYDAY=MO,WE;UNTIL=20240930T235959Z\r\nEND:VEVENT\r\n",
+                        availability);
+
+    EXPECT_EQ(stats.weeklyPatterns, 1);
+    EXPECT_EQ(stats.occurrences, 0);
+    EXPECT_EQ(availability.weeklyCount(), 2);
+    EXPECT_FALSE(availability.isFree(minuteAt(Monday + 9, 15), minuteAt(Monday + 9, 16)));
+    EXPECT_FALSE(availability.isFree(minuteAt(Monday + 28, 15), minuteAt(Monday + 28, 16)));
+    EXPECT_TRUE(availability.isFree(minuteAt(Monday + 35, 15), minuteAt(Monday + 35, 16)));
+    EXPECT_TRUE(availability.isFree(minuteAt(Monday + 8, 15), minuteAt(Monday + 8, 16)));
+}
+
+// Test a counted daily rule is expanded and exceptions are left out
+TEST(IcsImportTest, DailyRuleWithCountAndExdate) {
+    Planner::Availability availability;
+    auto stats = import("BEGIN:VEVENT\r\nDTSTART:20240902T080000\r\nDTEND:20240902T090000\r\n"
+                        "RRULE:FREQ=DAILY;COUNT=5\r\nEXDATE:20240904T080000\r\nEND:VEVENT\r\n",
+                        availability);
+
+    EXPECT_EQ(stats.occurrences, 4);
+    EXPECT_FALSE(availability.isFree(minuteAt(Monday + 1, 8), minuteAt(Monday + 1, 9)));
+    EXPECT_TRUE(availability.isFree(minuteAt(Monday + 2, 8), minuteAt(Monday + 2, 9)));
+    EXPECT_FALSE(availability.isFree(minuteAt(Monday + 4, 8), minuteAt(Monday + 4, 9)));
+    EXPECT_TRUE(availability.isFree(minuteAt(Monday + 5, 8), minuteAt(Monday + 5, 9)));
+}
+
+// Test an unbounded rule that started long ago only expands inside the horizon
+TEST(IcsImportTest, UnboundedRuleExpandsOnlyInHorizon) {
+    Planner::Availability availability;
+    auto stats = import("BEGIN:VEVENT\r\nDTSTART:19900101T070000\r\nDURATION:PT30M\r\n"
+                        "RRULE:FREQ=DAILY;INTERVAL=2\r\nEND:VEVENT\r\n",
+                        availability, Monday, Monday + 9);
+
+    EXPECT_EQ(stats.occurrences, 5);
+    EXPECT_EQ(availability.busyCount(), 5);
+}
+
+// Test monthly rules skip months without the day
+TEST(IcsImportTest, MonthlyRuleSkipsMissingDays) {
+    Planner::Availability availability;
+    auto stats = import("BEGIN:VEVENT\r\nDTSTART:20240131T100000\r\nDTEND:20240131T110000\r\n"
+                        "RRULE:FREQ=MONTHLY\r\nEND:VEVENT\r\n",
+                        availability, Planner::dayNumber(2024, 1, 1), Planner::dayNumber(2024, 12, 31));
+
+    EXPECT_EQ(stats.occurrences, 7);
+    EXPECT_FALSE(availability.isFree(minuteAt(Planner::dayNumber(2024, 3, 31), 10), minuteAt(Planner::dayNumber(2024, 3, 31), 11)));
+}
+
+// Test free, cancelled and alarm contents do not block time
+TEST(IcsImportTest, SkipsFreeAndCancelledEvents) {
+    Planner::Availability availability;
+    auto stats = import("BEGIN:VEVENT\r\nDTSTART:20240903T090000\r\nDTEND:20240903T100000\r\nTRANSP:TRANSPARENT\r\nEND:VEVENT\r\n"
+                        "BEGIN:VEVENT\r\nDTSTART:20240903T120000\r\nDTEND:20240903T130000\r\nSTATUS:CANCELLED\r\nEND:VEVENT\r\n"
+                        "BEGIN:VEVENT\r\nDTSTART:20240903T150000\r\nDTEND:20240903T160000\r\n"
+                        "BEGIN:VALARM\r\nTRIGGER:-PT15M\r\nDURATION:PT5H\r\nEND:VALARM\r\nEND:VEVENT\r\n",
+                        availability);
+
+    EXPECT_EQ(stats.events, 3);
+    EXPECT_EQ(stats.skipped, 2);
+    EXPECT_EQ(stats.occurrences, 1);
+    EXPECT_TRUE(availability.isFree(minuteAt(Monday + 1, 9), minuteAt(Monday + 1, 10)));
+    EXPECT_TRUE(availability.isFree(minuteAt(Monday + 1, 16), minuteAt(Monday + 1, 17)));
+}
+
+// Test events outside the horizon are dropped
+TEST(IcsImportTest, OutsideHorizon) {
+    Planner::Availability availability;
+    auto stats = import("BEGIN:VEVENT\r\nDTSTART;VALUE=DATE:20230101\r\nEND:VEVENT\r\n", availability);
+
+    EXPECT_EQ(stats.events, 1);
+    EXPECT_EQ(stats.occurrences, 0);
+    EXPECT_TRUE(availability.empty());
+}
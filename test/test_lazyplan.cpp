@@ -0,0 +1,141 @@
+#include "gtest/gtest.h"
+#include "../include/lazyplan.hpp"
+#include "../include/calendar.hpp"
+#include "../include/gzipstream.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static const char* DatabaseFile = "test_lazyplan.db";
+
+static Planner::AssignmentStore samplePlan() {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Physics", "Lab Report", 3, 6, 25.0f, 3, true, 2);
+    assignments.emplace("Math", "Homework 1", 5, 4, 20.0f, 2, false, 1);
+    assignments.emplace("Math", "Homework 2", 9, 2, 10.0f, 1, false, 1);
+    return assignments;
+}
+
+// Test a record round-trips and its header carries count and subjects
+TEST(LazyPlanTest, RecordRoundTrip) {
+    std::string record = Planner::formatPlanRecord(samplePlan());
+    std::string header = record.substr(0, record.find('\n'));
+
+    Planner::PlanSummary summary = Planner::parsePlanHeader(header);
+    EXPECT_EQ(summary.count, 3);
+    EXPECT_EQ(summary.subjects, (std::vector<std::string>{"Math", "Physics"}));
+
+    auto assignments = Planner::parsePlanRecord(record);
+    ASSERT_EQ(assignments.size(), 3);
+    EXPECT_EQ(assignments[assignments.handles()[0]].getName(), "Lab Report");
+    EXPECT_EQ(assignments[assignments.handles()[2]].getDeadline(), 9);
+}
+
+// Test opening a plan answers count and subjects without loading it
+TEST(LazyPlanTest, OpenReadsHeaderOnly) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+    Planner::saveToFile(database, "alice", samplePlan());
+
+    Planner::LazyPlan plan(database, "alice");
+    EXPECT_FALSE(plan.isLoaded());
+    EXPECT_EQ(plan.size(), 3);
+    EXPECT_EQ(plan.subjects(), (std::vector<std::string>{"Math", "Physics"}));
+
+    EXPECT_EQ(plan.assignments().size(), 3);
+    EXPECT_TRUE(plan.isLoaded());
+
+    Planner::LazyPlan nobody(database, "nobody");
+    EXPECT_TRUE(nobody.empty());
+    std::remove(DatabaseFile);
+}
+
+// Test additions to an unloaded plan are appended with deadlines kept from today
+TEST(LazyPlanTest, AddWithoutLoading) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+
+    // Stored three days ago, so stored deadlines count from an older epoch
+    Planner::AssignmentStore stored = samplePlan();
+    stored.rebase(Planner::today() - 3);
+    Planner::saveToFile(database, "alice", stored);
+
+    {
+        Planner::LazyPlan plan(database, "alice");
+        plan.add(Assignment("History", "Essay", 4, 8, 15.0f, 2, false, 1));
+        EXPECT_EQ(plan.size(), 4);
+        EXPECT_EQ(plan.subjects(), (std::vector<std::string>{"History", "Math", "Physics"}));
+        EXPECT_TRUE(plan.save());
+        EXPECT_FALSE(plan.isLoaded());
+    }
+
+    auto assignments = Planner::loadFromFile(database, "alice");
+    ASSERT_EQ(assignments.size(), 4);
+    EXPECT_EQ(assignments[assignments.handles()[0]].getDeadline(), 3);
+    EXPECT_EQ(assignments[assignments.handles()[3]].getName(), "Essay");
+    EXPECT_EQ(assignments[assignments.handles()[3]].getDeadline(), 4);
+    EXPECT_EQ(Planner::LazyPlan(database, "alice").size(), 4);
+    std::remove(DatabaseFile);
+}
+
+// Test additions are not appended to a stored record that fails to read
+TEST(LazyPlanTest, UnreadableRecordIsNotOverwritten) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+
+    // A compressed record cut off halfway
+    std::string compressed = Planner::gzipCompress(Planner::formatPlanRecord(samplePlan()));
+    const std::string truncated = compressed.substr(0, compressed.size() / 2);
+    database.write("alice", truncated);
+    std::string before;
+    EXPECT_FALSE(database.read("alice", before));
+
+    Planner::LazyPlan plan(database, "alice");
+    plan.add(Assignment("History", "Essay", 4, 8, 15.0f, 2, false, 1));
+    EXPECT_FALSE(plan.save());
+
+    std::string after;
+    EXPECT_FALSE(database.read("alice", after));
+    EXPECT_EQ(after, before);
+    EXPECT_TRUE(database.isCompressed("alice"));
+
+    // A user not stored yet still gets a fresh record
+    Planner::LazyPlan fresh(database, "bob");
+    fresh.add(Assignment("History", "Essay", 4, 8, 15.0f, 2, false, 1));
+    EXPECT_TRUE(fresh.save());
+    EXPECT_EQ(Planner::loadFromFile(database, "bob").size(), 1);
+    std::remove(DatabaseFile);
+}
+
+// Test an untouched plan writes nothing on save
+TEST(LazyPlanTest, UntouchedPlanIsNotRewritten) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+    Planner::saveToFile(database, "alice", samplePlan());
+
+    std::string before, after;
+    database.read("alice", before);
+    Planner::LazyPlan plan(database, "alice");
+    EXPECT_TRUE(plan.save());
+    database.read("alice", after);
+    EXPECT_EQ(before, after);
+    std::remove(DatabaseFile);
+}
+
+// Test records written as one JSON object still open and load
+TEST(LazyPlanTest, SingleObjectRecord) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+    database.write("alice", "{\"epoch\":" + std::to_string(Planner::today()) +
+                                ",\"assignments\":[{\"subject\":\"Math\",\"name\":\"HW\",\"deadline\":2,\"duration\":3,"
+                                "\"weight\":10.0,\"size\":1,\"group_work\":false,\"group_size\":1}]}");
+
+    Planner::LazyPlan plan(database, "alice");
+    EXPECT_EQ(plan.size(), 1);
+    EXPECT_EQ(plan.subjects(), std::vector<std::string>{"Math"});
+
+    plan.add(Assignment("History", "Essay", 4, 8, 15.0f, 2, false, 1));
+    EXPECT_TRUE(plan.save());
+    EXPECT_EQ(Planner::loadFromFile(database, "alice").size(), 2);
+    std::remove(DatabaseFile);
+}
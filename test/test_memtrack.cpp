@@ -0,0 +1,105 @@
+#include "gtest/gtest.h"
+#include "../include/memtrack.hpp"
+#include "../include/planner.hpp"
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Test allocations are charged to the innermost scope and freed bytes return to it
+TEST(MemTrackTest, ChargesInnermostScope) {
+    Planner::startMemoryTracking();
+    {
+        PLANNER_MEMORY_SCOPE(Schedule);
+        std::vector<char> outer(1000);
+        {
+            PLANNER_MEMORY_SCOPE(Ics);
+            std::vector<char> inner(300);
+        }
+        std::vector<char> after(200);
+    }
+    Planner::stopMemoryTracking();
+
+    Planner::MemoryUsage schedule = Planner::memoryUsage(Planner::MemoryTag::Schedule);
+    Planner::MemoryUsage ics = Planner::memoryUsage(Planner::MemoryTag::Ics);
+#if PLANNER_MEMORY_TRACKING
+    EXPECT_EQ(schedule.allocations, 2u);
+    EXPECT_EQ(schedule.frees, 2u);
+    EXPECT_EQ(schedule.bytesAllocated, 1200u);
+    EXPECT_EQ(schedule.peakBytes, 1200);
+    EXPECT_EQ(schedule.liveBytes, 0);
+    EXPECT_EQ(ics.allocations, 1u);
+    EXPECT_EQ(ics.peakBytes, 300);
+    EXPECT_EQ(ics.liveBytes, 0);
+#else
+    EXPECT_EQ(schedule.allocations, 0u);
+    EXPECT_EQ(ics.allocations, 0u);
+#endif
+}
+
+// Test a block freed in another phase or thread still returns to its own phase
+TEST(MemTrackTest, FreeReturnsToAllocatingPhase) {
+    Planner::startMemoryTracking();
+    std::unique_ptr<int[]> block;
+    {
+        PLANNER_MEMORY_SCOPE(Load);
+        block.reset(new int[64]);
+    }
+    std::thread worker([&block] {
+        PLANNER_MEMORY_SCOPE(Save);
+        block.reset();
+    });
+    worker.join();
+    Planner::stopMemoryTracking();
+
+    Planner::MemoryUsage load = Planner::memoryUsage(Planner::MemoryTag::Load);
+#if PLANNER_MEMORY_TRACKING
+    EXPECT_EQ(load.frees, 1u);
+    EXPECT_EQ(load.liveBytes, 0);
+    EXPECT_EQ(load.peakBytes, static_cast<std::int64_t>(64 * sizeof(int)));
+    EXPECT_EQ(Planner::memoryUsage(Planner::MemoryTag::Save).frees, 0u);
+#else
+    EXPECT_EQ(load.frees, 0u);
+#endif
+}
+
+// Test blocks allocated before tracking started are never charged when freed
+TEST(MemTrackTest, IgnoresBlocksFromBeforeStart) {
+    auto early = std::make_unique<std::string>(100, 'x');
+    Planner::startMemoryTracking();
+    early.reset();
+    Planner::stopMemoryTracking();
+
+    for (int tag = 0; tag < static_cast<int>(Planner::MemoryTag::Count); ++tag) {
+        Planner::MemoryUsage usage = Planner::memoryUsage(static_cast<Planner::MemoryTag>(tag));
+        EXPECT_EQ(usage.frees, 0u);
+        EXPECT_GE(usage.liveBytes, 0);
+    }
+}
+
+// Test the planner phases show up in the report
+TEST(MemTrackTest, Report_PlannerPhases) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Homework 1", 5, 4, 20.0f, 2, false, 1);
+    assignments.emplace("Physics", "Lab Report", 3, 6, 25.0f, 3, false, 1);
+
+    const std::string filename = "test_memtrack.json";
+    Planner::startMemoryTracking();
+    Planner::saveToFile(filename, assignments);
+    auto loaded = Planner::loadFromFile(filename);
+    Planner::stopMemoryTracking();
+    std::remove(filename.c_str());
+    ASSERT_EQ(loaded.size(), 2u);
+
+    std::ostringstream report;
+    Planner::writeMemoryReport(report);
+#if PLANNER_MEMORY_TRACKING
+    EXPECT_GT(Planner::memoryUsage(Planner::MemoryTag::Load).allocations, 0u);
+    EXPECT_GT(Planner::memoryUsage(Planner::MemoryTag::Save).allocations, 0u);
+    EXPECT_NE(report.str().find("load"), std::string::npos);
+    EXPECT_NE(report.str().find("save"), std::string::npos);
+#endif
+    EXPECT_NE(report.str().find("Peak bytes"), std::string::npos);
+}
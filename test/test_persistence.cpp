@@ -0,0 +1,199 @@
+#include "gtest/gtest.h"
+#include "../include/persistence.hpp"
+#include "../include/calendar.hpp"
+#include "../include/gzipstream.hpp"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+static const char* DatabaseFile = "test_persistence.db";
+
+// A window no test outlasts, so only wait() and drain() end a burst
+static const std::chrono::milliseconds LongWindow(60000);
+
+static Planner::AssignmentStore planOf(int count) {
+    Planner::AssignmentStore assignments;
+    for (int i = 0; i < count; ++i)
+        assignments.emplace("Math", "Homework " + std::to_string(i), i + 1, 2, 10.0f, 2, false, 1);
+    return assignments;
+}
+
+// Test a saved snapshot reaches the database
+TEST(PersistenceTest, SavePlan) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+    Planner::PersistenceWriter writer(database, std::chrono::milliseconds(0));
+
+    writer.savePlan("alice", planOf(3));
+    writer.wait();
+    EXPECT_EQ(Planner::loadFromFile(database, "alice").size(), 3);
+    EXPECT_EQ(writer.writeCount(), 1);
+    EXPECT_TRUE(writer.drain());
+    std::remove(DatabaseFile);
+}
+
+// Test a burst of snapshots becomes one write of the last one
+TEST(PersistenceTest, CoalescesSnapshots) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+    Planner::PersistenceWriter writer(database, LongWindow);
+
+    for (int count = 1; count <= 10; ++count)
+        writer.savePlan("alice", planOf(count));
+    writer.wait();
+
+    EXPECT_EQ(writer.writeCount(), 1);
+    EXPECT_EQ(writer.coalescedCount(), 9);
+    EXPECT_EQ(Planner::loadFromFile(database, "alice").size(), 10);
+    std::remove(DatabaseFile);
+}
+
+// Test queued additions fold into one append, and into a queued snapshot
+TEST(PersistenceTest, CoalescesAdditions) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+    Planner::saveToFile(database, "alice", planOf(2));
+    Planner::PersistenceWriter writer(database, LongWindow);
+
+    Planner::PlanSummary summary{Planner::today(), 2, {"Math"}};
+    for (int i = 0; i < 3; ++i) {
+        ++summary.count;
+        writer.appendToPlan("alice", summary, {Assignment("History", "Essay", 4, 8, 15.0f, 2, false, 1)});
+    }
+    writer.wait();
+    EXPECT_EQ(writer.writeCount(), 1);
+    EXPECT_EQ(Planner::loadFromFile(database, "alice").size(), 5);
+
+    writer.savePlan("bob", planOf(1));
+    writer.appendToPlan("bob", summary, {Assignment("History", "Essay", 4, 8, 15.0f, 2, false, 1)});
+    writer.wait();
+    EXPECT_EQ(writer.writeCount(), 2);
+    EXPECT_EQ(Planner::loadFromFile(database, "bob").size(), 2);
+    std::remove(DatabaseFile);
+}
+
+// Test failed writes are reported back, and drain writes what is queued
+TEST(PersistenceTest, ErrorsAndDrain) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+    Planner::PersistenceWriter writer(database, LongWindow);
+
+    bool written = false;
+    writer.submit("good", [&written] { return written = true; });
+    writer.submit("bad", [] { return false; });
+    EXPECT_FALSE(writer.drain());
+    EXPECT_TRUE(written);
+    EXPECT_EQ(writer.takeErrors(), std::vector<std::string>{"Could not save bad"});
+    EXPECT_TRUE(writer.takeErrors().empty());
+
+    // After draining, changes are written on the caller's thread
+    writer.savePlan("alice", planOf(2));
+    EXPECT_EQ(Planner::loadFromFile(database, "alice").size(), 2);
+    EXPECT_TRUE(writer.drain());
+    std::remove(DatabaseFile);
+}
+
+// Test a write that throws is reported as failed and later writes still run
+TEST(PersistenceTest, ThrowingWriteIsReported) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+    Planner::PersistenceWriter writer(database, LongWindow);
+
+    // A name that is not valid UTF-8 cannot be written as JSON
+    Planner::AssignmentStore invalid;
+    invalid.emplace("French", "Caf\xe9 essay", 3, 2, 10.0f, 1, false, 1);
+    writer.savePlan("alice", invalid);
+    writer.savePlan("bob", planOf(2));
+    writer.wait();
+
+    auto errors = writer.takeErrors();
+    ASSERT_EQ(errors.size(), 1u);
+    EXPECT_EQ(errors[0].rfind("Could not save alice: ", 0), 0u);
+    EXPECT_EQ(Planner::loadFromFile(database, "bob").size(), 2);
+
+    // The same failure on the caller's thread after draining
+    EXPECT_TRUE(writer.drain());
+    writer.appendToPlan("bob", Planner::PlanSummary{Planner::today(), 3, {"French"}},
+                        {Assignment("French", "Caf\xe9 essay", 3, 2, 10.0f, 1, false, 1)});
+    EXPECT_EQ(writer.takeErrors().size(), 1u);
+    EXPECT_EQ(Planner::loadFromFile(database, "bob").size(), 2);
+    std::remove(DatabaseFile);
+}
+
+// Test additions are not appended to a stored record that fails to read
+TEST(PersistenceTest, UnreadableRecordIsNotOverwritten) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+    std::string compressed = Planner::gzipCompress(Planner::formatPlanRecord(planOf(3)));
+    database.write("alice", compressed.substr(0, compressed.size() / 2));
+    std::string before;
+    EXPECT_FALSE(database.read("alice", before));
+
+    Planner::PersistenceWriter writer(database, LongWindow);
+    writer.appendToPlan("alice", Planner::PlanSummary{Planner::today(), 4, {"Math"}},
+                        {Assignment("Math", "Homework 9", 3, 2, 10.0f, 1, false, 1)});
+    EXPECT_FALSE(writer.drain());
+    EXPECT_EQ(writer.takeErrors(), std::vector<std::string>{"Could not save alice"});
+
+    std::string after;
+    EXPECT_FALSE(database.read("alice", after));
+    EXPECT_EQ(after, before);
+    std::remove(DatabaseFile);
+}
+
+// Test a lazy plan saved through a writer reads its own queued changes
+TEST(PersistenceTest, LazyPlanThroughWriter) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+    Planner::saveToFile(database, "alice", planOf(2));
+    Planner::PersistenceWriter writer(database, LongWindow);
+
+    Planner::LazyPlan plan(database, "alice", &writer);
+    plan.add(Assignment("History", "Essay", 4, 8, 15.0f, 2, false, 1));
+    EXPECT_TRUE(plan.save());
+    EXPECT_EQ(plan.assignments().size(), 3);
+
+    plan.assignments().remove(plan.assignments().handles()[0]);
+    EXPECT_TRUE(plan.save());
+    EXPECT_TRUE(writer.drain());
+    EXPECT_EQ(Planner::LazyPlan(database, "alice").size(), 2);
+    std::remove(DatabaseFile);
+}
+
+// Test a termination signal drains the writer before the program exits
+TEST(PersistenceTest, SignalDrainsWriter) {
+    std::remove(DatabaseFile);
+    EXPECT_EXIT(
+        {
+            Planner::UserDatabase database(DatabaseFile);
+            Planner::PersistenceWriter writer(database, LongWindow);
+            Planner::SignalDrain signalDrain(writer);
+            writer.savePlan("alice", planOf(3));
+            kill(getpid(), SIGTERM);
+            for (;;)
+                pause();
+        },
+        testing::ExitedWithCode(128 + SIGTERM), "every change was saved");
+
+    Planner::UserDatabase database(DatabaseFile);
+    EXPECT_EQ(Planner::loadFromFile(database, "alice").size(), 3u);
+    std::remove(DatabaseFile);
+}
+
+// Test the signal thread stops when its owner goes away, leaving the writer usable
+TEST(PersistenceTest, SignalDrainStops) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+    Planner::PersistenceWriter writer(database, std::chrono::milliseconds(0));
+    {
+        Planner::SignalDrain signalDrain(writer);
+    }
+
+    writer.savePlan("alice", planOf(2));
+    EXPECT_TRUE(writer.drain());
+    EXPECT_EQ(Planner::loadFromFile(database, "alice").size(), 2u);
+    std::remove(DatabaseFile);
+}
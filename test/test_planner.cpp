@@ -5,15 +5,10 @@
 #include <fstream>
 #include <vector>
 #include <string>
-#include <memory>
+#include <filesystem>
 
 using json = nlohmann::json;
 
-static std::shared_ptr<Assignment> createAssignment(const std::string& subject, const std::string& name, int deadline,
-                                                    int duration, float weight, int size, bool groupWork, int groupSize) {
-    return std::make_shared<Assignment>(subject, name, deadline, duration, weight, size, groupWork, groupSize);
-}
-
 // Test Planner::loadFromFile for valid input
 TEST(PlannerTest, LoadFromFile_ValidFile) {
     // Create a temporary JSON file
@@ -30,15 +25,38 @@ TEST(PlannerTest, LoadFromFile_ValidFile) {
 
     // Validate the results
     EXPECT_EQ(assignments.size(), 2);
-    EXPECT_EQ(assignments[0]->getSubject(), "Math");
-    EXPECT_EQ(assignments[0]->getName(), "Math Homework");
-    EXPECT_EQ(assignments[1]->getSubject(), "Science");
-    EXPECT_EQ(assignments[1]->getName(), "Science Project");
+    const auto& handles = assignments.handles();
+    EXPECT_EQ(assignments[handles[0]].getSubject(), "Math");
+    EXPECT_EQ(assignments[handles[0]].getName(), "Math Homework");
+    EXPECT_EQ(assignments[handles[1]].getSubject(), "Science");
+    EXPECT_EQ(assignments[handles[1]].getName(), "Science Project");
 
     // Clean up
     std::remove("temp.json");
 }
 
+// Test Planner::loadFromFile counts stored deadlines from the plan epoch
+TEST(PlannerTest, LoadFromFile_EpochRebase) {
+    // Saved three days ago with a deadline ten days after that
+    std::ofstream tempFile("temp.json");
+    json testData = {
+        {"epoch", Planner::today() - 3},
+        {"assignments", json::array({
+            {{"subject", "Math"}, {"name", "Math Homework"}, {"deadline", 10}, {"duration", 10}, {"weight", 20.0}, {"size", 1}, {"group_work", false}, {"group_size", 1}}
+        })}
+    };
+    tempFile << testData.dump(4);
+    tempFile.close();
+
+    auto assignments = Planner::loadFromFile("temp.json");
+
+    ASSERT_EQ(assignments.size(), 1);
+    EXPECT_EQ(assignments.epochDay(), Planner::today());
+    EXPECT_EQ(assignments[assignments.handles()[0]].getDeadline(), 7);
+
+    std::remove("temp.json");
+}
+
 // Test Planner::loadFromFile for invalid input
 TEST(PlannerTest, LoadFromFile_InvalidFile) {
     auto assignments = Planner::loadFromFile("nonexistent.json");
@@ -50,10 +68,9 @@ TEST(PlannerTest, LoadFromFile_InvalidFile) {
 // Test Planner::saveToFile
 TEST(PlannerTest, SaveToFile) {
     // Create assignments
-    std::vector<Planner::AssignmentPtr> assignments = {
-        createAssignment("Math", "Math Homework", 5, 10, 20.0, 1, false, 1),
-        createAssignment("Science", "Science Project", 7, 15, 25.0, 2, true, 3)
-    };
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 5, 10, 20.0, 1, false, 1);
+    assignments.emplace("Science", "Science Project", 7, 15, 25.0, 2, true, 3);
 
     // Save assignments to file
     Planner::saveToFile("temp.json", assignments);
@@ -65,9 +82,10 @@ TEST(PlannerTest, SaveToFile) {
     json savedData;
     file >> savedData;
 
-    EXPECT_EQ(savedData.size(), 2);
-    EXPECT_EQ(savedData[0]["subject"], "Math");
-    EXPECT_EQ(savedData[1]["name"], "Science Project");
+    EXPECT_EQ(savedData["epoch"], assignments.epochDay());
+    EXPECT_EQ(savedData["assignments"].size(), 2);
+    EXPECT_EQ(savedData["assignments"][0]["subject"], "Math");
+    EXPECT_EQ(savedData["assignments"][1]["name"], "Science Project");
 
     // Clean up
     std::remove("temp.json");
@@ -92,9 +110,9 @@ TEST(PlannerTest, AddToICSFile) {
 
 // Test Planner::calculatePriority
 TEST(PlannerTest, CalculatePriority) {
-    auto assignment = createAssignment("Math", "Math Homework", 3, 10, 20.0, 1, false, 1);
+    Assignment assignment("Math", "Math Homework", 3, 10, 20.0, 1, false, 1);
 
-    int priority = Planner::calculatePriority(*assignment, 5);
+    int priority = Planner::calculatePriority(assignment, 5);
 
     // Validate the calculated priority
     EXPECT_GT(priority, 0); // Ensure priority is greater than 0
@@ -103,10 +121,9 @@ TEST(PlannerTest, CalculatePriority) {
 
 TEST(PlannerTest, Scheduler_Simple) {
     // Create valid assignments
-    std::vector<Planner::AssignmentPtr> assignments = {
-        createAssignment("Math", "Math Homework", 2, 4, 20.0, 1, false, 1),
-        createAssignment("Science", "Science Project", 3, 6, 25.0, 2, true, 3)
-    };
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 2, 4, 20.0, 1, false, 1);
+    assignments.emplace("Science", "Science Project", 3, 6, 25.0, 2, true, 3);
 
     // Ensure Data directory exists
     #include <filesystem>
@@ -131,3 +148,59 @@ TEST(PlannerTest, Scheduler_Simple) {
     file.close();
     std::remove("Data/test_user_schedule.ics");
 }
+
+// Test Planner::scheduler with the earliest-deadline-first engine
+TEST(PlannerTest, Scheduler_EarliestDeadline) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 2, 4, 20.0, 1, false, 1);
+    assignments.emplace("Science", "Science Project", 3, 6, 25.0, 2, true, 3);
+
+    if (!std::filesystem::exists("Data")) {
+        std::filesystem::create_directory("Data");
+    }
+
+    testing::internal::CaptureStdout();
+    Planner::scheduler(assignments, 3, 5, "test_user_edf", Planner::SchedulerEngine::EarliestDeadline);
+    std::string output = testing::internal::GetCapturedStdout();
+
+    EXPECT_NE(output.find("Day 1:\nHour 1: Math Homework"), std::string::npos);
+
+    std::ifstream file("Data/test_user_edf_schedule.ics");
+    ASSERT_TRUE(file.is_open()) << "ICS file could not be created or opened.";
+
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_NE(content.find("BEGIN:VCALENDAR"), std::string::npos);
+    EXPECT_NE(content.find("END:VCALENDAR"), std::string::npos);
+    EXPECT_NE(content.find("SUMMARY:Math Homework"), std::string::npos);
+    EXPECT_NE(content.find("SUMMARY:Science Project"), std::string::npos);
+
+    file.close();
+    std::remove("Data/test_user_edf_schedule.ics");
+}
+
+// Test Planner::scheduler leaves the assignments untouched and is repeatable
+TEST(PlannerTest, Scheduler_DoesNotMutate) {
+    Planner::AssignmentStore assignments;
+    auto math = assignments.emplace("Math", "Math Homework", 2, 4, 20.0, 1, false, 1);
+    auto science = assignments.emplace("Science", "Science Project", 3, 6, 25.0, 2, true, 3);
+
+    if (!std::filesystem::exists("Data")) {
+        std::filesystem::create_directory("Data");
+    }
+
+    testing::internal::CaptureStdout();
+    Planner::scheduler(assignments, 3, 5, "test_user_repeat");
+    std::string firstRun = testing::internal::GetCapturedStdout();
+
+    EXPECT_EQ(assignments[math].getRealDuration(), 4);
+    EXPECT_EQ(assignments[math].getDeadline(), 2);
+    EXPECT_EQ(assignments[science].getRealDuration(), 2);
+    EXPECT_EQ(assignments[science].getDeadline(), 3);
+
+    testing::internal::CaptureStdout();
+    Planner::scheduler(assignments, 3, 5, "test_user_repeat");
+    std::string secondRun = testing::internal::GetCapturedStdout();
+
+    EXPECT_EQ(firstRun, secondRun);
+    std::remove("Data/test_user_repeat_schedule.ics");
+}
@@ -0,0 +1,184 @@
+#include "gtest/gtest.h"
+#include "../include/simulation.hpp"
+#include "../include/assignment.hpp"
+#include <filesystem>
+#include <vector>
+#include <string>
+
+// Count occurrences of a substring in the scheduler's console output
+static int countOccurrences(const std::string& text, const std::string& needle) {
+    int count = 0;
+    for (auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + needle.size()))
+        ++count;
+    return count;
+}
+
+// Test Planner::makeWorkItems copies the scheduling fields
+TEST(SimulationTest, MakeWorkItems) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 5, 10, 20.0, 1, false, 1);
+    assignments.emplace("Science", "Science Project", 7, 15, 25.0, 2, true, 3);
+
+    auto items = Planner::makeWorkItems(assignments);
+
+    ASSERT_EQ(items.size(), 2);
+    EXPECT_EQ(items[0].remainingHours, 10);
+    EXPECT_EQ(items[0].dueDay, 5);
+    EXPECT_EQ(items[1].remainingHours, 5);
+    EXPECT_EQ(items[1].size, 2);
+}
+
+// Test Planner::simulate leaves the user's assignments untouched
+TEST(SimulationTest, Simulate_DoesNotMutateAssignments) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 2, 4, 20.0, 1, false, 1);
+
+    auto items = Planner::makeWorkItems(assignments);
+    auto stats = Planner::simulate(items, 3, 5);
+
+    EXPECT_EQ(stats.missedDeadlines, 0);
+    EXPECT_EQ(stats.scheduledHours, 4);
+    const Assignment& assignment = assignments[assignments.handles()[0]];
+    EXPECT_EQ(assignment.getRealDuration(), 4);
+    EXPECT_EQ(assignment.getDeadline(), 2);
+}
+
+// Test Planner::simulate reports missed deadlines and outstanding hours
+TEST(SimulationTest, Simulate_MissedDeadline) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 1, 10, 20.0, 1, false, 1);
+
+    auto items = Planner::makeWorkItems(assignments);
+    auto stats = Planner::simulate(items, 3, 5);
+
+    EXPECT_EQ(stats.days, 1);
+    EXPECT_EQ(stats.missedDeadlines, 1);
+    EXPECT_EQ(stats.totalLateness, 7);
+}
+
+// Test Planner::simulate agrees with Planner::scheduler
+TEST(SimulationTest, Simulate_MatchesScheduler) {
+    Planner::AssignmentStore assignments;
+    for (int i = 0; i < 12; ++i) {
+        assignments.emplace("Math", "Task " + std::to_string(i), 1 + i % 5, 2 + (i * 7) % 9,
+                            5.0f + i * 2, 1 + i % 3, false, 1);
+    }
+
+    auto items = Planner::makeWorkItems(assignments);
+    auto stats = Planner::simulate(items, 3, 5);
+
+    if (!std::filesystem::exists("Data")) {
+        std::filesystem::create_directory("Data");
+    }
+
+    testing::internal::CaptureStdout();
+    Planner::scheduler(assignments, 3, 5, "test_simulation");
+    std::string output = testing::internal::GetCapturedStdout();
+    std::remove("Data/test_simulation_schedule.ics");
+
+    EXPECT_EQ(countOccurrences(output, "Missed deadline"), stats.missedDeadlines);
+    EXPECT_EQ(countOccurrences(output, "Hour "), stats.scheduledHours);
+    EXPECT_EQ(countOccurrences(output, "\nDay "), stats.days);
+}
+
+// Test the earliest-deadline-first engine meets every deadline of a feasible plan
+TEST(SimulationTest, EarliestDeadline_FeasiblePlan) {
+    // Priority ladder favours the heavy, long assignment and misses the short one
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Long Project", 4, 6, 30.0, 1, false, 1);
+    assignments.emplace("Science", "Quick Quiz", 1, 2, 5.0, 3, false, 1);
+
+    auto items = Planner::makeWorkItems(assignments);
+    Planner::SchedulePlan plan;
+    auto stats = Planner::simulate(items, 2, 2, Planner::SchedulerEngine::EarliestDeadline, &plan);
+
+    EXPECT_EQ(stats.missedDeadlines, 0);
+    EXPECT_EQ(stats.scheduledHours, 8);
+    ASSERT_EQ(plan.slots.size(), 8);
+    EXPECT_EQ(plan.slots[0].assignment, 1);
+    EXPECT_EQ(plan.slots[1].assignment, 1);
+    EXPECT_EQ(plan.slots[2].assignment, 0);
+    EXPECT_TRUE(plan.missed.empty());
+}
+
+// Test the earliest-deadline-first engine finishes overdue work first
+TEST(SimulationTest, EarliestDeadline_LateWork) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 1, 3, 20.0, 1, false, 1);
+    assignments.emplace("Science", "Science Project", 5, 2, 25.0, 2, false, 1);
+
+    auto items = Planner::makeWorkItems(assignments);
+    Planner::SchedulePlan plan;
+    auto stats = Planner::simulate(items, 2, 2, Planner::SchedulerEngine::EarliestDeadline, &plan);
+
+    EXPECT_EQ(stats.missedDeadlines, 1);
+    EXPECT_EQ(stats.totalLateness, 1);
+    EXPECT_EQ(stats.maxLateness, 1);
+    ASSERT_EQ(plan.missed.size(), 1);
+    EXPECT_EQ(plan.missed[0].assignment, 0);
+    EXPECT_EQ(plan.slots[2].assignment, 0);
+    EXPECT_EQ(plan.slots[2].day, 2);
+}
+
+// Test pulling every day from the generator reproduces simulate() for both engines
+TEST(SimulationTest, Generator_MatchesSimulate) {
+    Planner::AssignmentStore assignments;
+    for (int i = 0; i < 40; ++i)
+        assignments.emplace("Math", "Homework " + std::to_string(i), 1 + (i * 7) % 30, 1 + i % 5, 10.0f + i % 15, 1 + i % 3, false, 1);
+
+    for (auto engine : {Planner::SchedulerEngine::Priority, Planner::SchedulerEngine::EarliestDeadline}) {
+        Planner::ScheduleOptions options;
+        options.weekdayStudyHours = 2;
+        options.weekendStudyHours = 3;
+        options.engine = engine;
+
+        auto items = Planner::makeWorkItems(assignments);
+        Planner::SchedulePlan expected;
+        auto expectedStats = Planner::simulate(items, options, &expected);
+
+        Planner::ScheduleGenerator generator(assignments, options);
+        Planner::ScheduleDay day;
+        std::size_t slot = 0, missed = 0;
+        int days = 0;
+        while (generator.next(day)) {
+            EXPECT_EQ(day.day, ++days);
+            for (const auto& current : day.slots) {
+                ASSERT_LT(slot, expected.slots.size());
+                EXPECT_EQ(current.assignment, expected.slots[slot].assignment);
+                EXPECT_EQ(current.day, day.day);
+                EXPECT_EQ(expected.slots[slot++].day, day.day);
+            }
+            for (const auto& current : day.missed) {
+                ASSERT_LT(missed, expected.missed.size());
+                EXPECT_EQ(current.assignment, expected.missed[missed++].assignment);
+            }
+        }
+
+        EXPECT_EQ(slot, expected.slots.size());
+        EXPECT_EQ(missed, expected.missed.size());
+        EXPECT_TRUE(generator.done());
+        EXPECT_EQ(generator.stats().days, expectedStats.days);
+        EXPECT_EQ(generator.stats().scheduledHours, expectedStats.scheduledHours);
+        EXPECT_EQ(generator.stats().missedDeadlines, expectedStats.missedDeadlines);
+        EXPECT_EQ(generator.stats().maxLateness, expectedStats.maxLateness);
+    }
+}
+
+// Test a consumer can stop after a week of a much longer plan
+TEST(SimulationTest, Generator_StopsEarly) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("History", "Thesis", 120, 200, 30.0f, 1, false, 1);
+
+    Planner::ScheduleOptions options;
+    options.weekdayStudyHours = 2;
+    options.weekendStudyHours = 2;
+    Planner::ScheduleGenerator generator(assignments, options);
+    Planner::ScheduleDay day;
+    for (int i = 0; i < 7; ++i)
+        ASSERT_TRUE(generator.next(day));
+
+    EXPECT_EQ(day.day, 7);
+    EXPECT_FALSE(generator.done());
+    EXPECT_EQ(generator.stats().days, 7);
+    EXPECT_EQ(generator.stats().scheduledHours, 14);
+}
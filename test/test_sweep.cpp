@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+#include "../include/sweep.hpp"
+#include "../include/assignment.hpp"
+#include "../include/calendar.hpp"
+#include <vector>
+#include <string>
+
+static Planner::AssignmentStore sampleAssignments() {
+    Planner::AssignmentStore assignments;
+    for (int i = 0; i < 20; ++i) {
+        assignments.emplace("Math", "Task " + std::to_string(i), 5 + i % 9, 1 + (i * 5) % 7,
+                            5.0f + i, 1 + i % 3, false, 1);
+    }
+    return assignments;
+}
+
+// Test the sweep covers the whole grid in weekday-major order
+TEST(SweepTest, SweepStudyHours_GridShape) {
+    auto result = Planner::sweepStudyHours(sampleAssignments(), 4, 3);
+
+    ASSERT_EQ(result.cells.size(), 12);
+    EXPECT_EQ(result.cells[0].weekdayStudyHours, 1);
+    EXPECT_EQ(result.cells[0].weekendStudyHours, 1);
+    EXPECT_EQ(result.cells[5].weekdayStudyHours, 2);
+    EXPECT_EQ(result.cells[5].weekendStudyHours, 3);
+}
+
+// Test every parallel cell matches a serial simulation
+TEST(SweepTest, SweepStudyHours_MatchesSerialSimulation) {
+    auto assignments = sampleAssignments();
+    auto result = Planner::sweepStudyHours(assignments, 6, 6, Planner::SchedulerEngine::Priority, 4);
+
+    for (const auto& cell : result.cells) {
+        auto items = Planner::makeWorkItems(assignments);
+        auto stats = Planner::simulate(items, cell.weekdayStudyHours, cell.weekendStudyHours);
+        EXPECT_EQ(cell.stats.missedDeadlines, stats.missedDeadlines);
+        EXPECT_EQ(cell.stats.totalLateness, stats.totalLateness);
+    }
+}
+
+// Test the cheapest budget has no misses and nothing cheaper does
+TEST(SweepTest, SweepStudyHours_Cheapest) {
+    auto result = Planner::sweepStudyHours(sampleAssignments(), 12, 12);
+
+    ASSERT_GE(result.cheapest, 0);
+    const auto& best = result.cells[result.cheapest];
+    EXPECT_EQ(best.stats.missedDeadlines, 0);
+
+    int bestCost = Planner::weeklyStudyHours(best.weekdayStudyHours, best.weekendStudyHours);
+    for (const auto& cell : result.cells) {
+        if (Planner::weeklyStudyHours(cell.weekdayStudyHours, cell.weekendStudyHours) < bestCost) {
+            EXPECT_GT(cell.stats.missedDeadlines, 0);
+        }
+    }
+}
+
+// Test an impossible plan reports no cheapest budget
+TEST(SweepTest, SweepStudyHours_NoFeasibleBudget) {
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Math Homework", 1, 50, 20.0, 1, false, 1);
+
+    auto result = Planner::sweepStudyHours(assignments, 3, 3);
+
+    EXPECT_EQ(result.cheapest, -1);
+}
+
+// Test a sweep on real dates matches the calendar simulation and sees holidays
+TEST(SweepTest, SweepStudyHours_Calendar) {
+    auto assignments = sampleAssignments();
+    Planner::ScheduleOptions options;
+    options.startDay = Planner::today();
+    std::vector<Planner::Holiday> holidays;
+    for (int day = 1; day <= 5; ++day)
+        holidays.push_back({Planner::today() + day, 0});
+
+    auto result = Planner::sweepStudyHours(assignments, 4, 4, options, holidays, 60, 2);
+    ASSERT_EQ(result.cells.size(), 16u);
+    for (const auto& cell : result.cells) {
+        auto capacity = Planner::calendarCapacity(options.startDay, cell.weekdayStudyHours, cell.weekendStudyHours,
+                                                  holidays, 60);
+        Planner::ScheduleOptions cellOptions = options;
+        cellOptions.capacity = &capacity;
+        auto items = Planner::makeWorkItems(assignments);
+        auto stats = Planner::simulate(items, cellOptions);
+        EXPECT_EQ(cell.stats.missedDeadlines, stats.missedDeadlines);
+        EXPECT_EQ(cell.stats.totalLateness, stats.totalLateness);
+    }
+
+    // The first deadlines fall inside the break, so no budget can meet them
+    EXPECT_EQ(result.cheapest, -1);
+}
@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+#include "../include/textindex.hpp"
+#include "../include/assignment.hpp"
+#include <string>
+#include <vector>
+
+using Ids = std::vector<std::uint32_t>;
+
+// Test substring search ignores case and checks the fragment is there in one piece
+TEST(TextIndexTest, Substring) {
+    Planner::TextIndex index;
+    index.add(0, "Lab 3 write-up");
+    index.add(1, "Final Project");
+    index.add(2, "Lab 12");
+    index.add(3, "Project proposal");
+
+    EXPECT_EQ(index.size(), 4u);
+    EXPECT_EQ(index.search("proj"), (Ids{1, 3}));
+    EXPECT_EQ(index.search("LAB 3"), (Ids{0}));
+    EXPECT_EQ(index.search("lab"), (Ids{0, 2}));
+    EXPECT_EQ(index.search("ab"), (Ids{0, 2})); // Shorter than a trigram
+    EXPECT_EQ(index.search("projectx"), Ids{});
+    EXPECT_EQ(index.search("proposal final"), Ids{}); // Every trigram exists, the phrase does not
+}
+
+// Test removed and replaced texts stop matching, and ids can be reused in any order
+TEST(TextIndexTest, AddAndRemove) {
+    Planner::TextIndex index;
+    index.add(5, "Essay on Rome");
+    index.add(2, "Essay on Greece"); // Out of order
+    index.add(9, "Lab report");
+    EXPECT_EQ(index.search("essay"), (Ids{2, 5}));
+
+    index.remove(5);
+    EXPECT_FALSE(index.contains(5));
+    EXPECT_EQ(index.search("essay"), (Ids{2}));
+
+    index.add(5, "Lab notes"); // The id comes back with new text
+    EXPECT_EQ(index.search("lab"), (Ids{5, 9}));
+    EXPECT_EQ(index.search("rome"), Ids{});
+
+    index.add(9, "Poster"); // Replacing text in place
+    EXPECT_EQ(index.search("lab"), (Ids{5}));
+    EXPECT_EQ(index.search("post"), (Ids{9}));
+    EXPECT_EQ(index.size(), 3u);
+}
+
+// Test many removals compact the postings without losing the rest
+TEST(TextIndexTest, Compaction) {
+    Planner::TextIndex index;
+    for (std::uint32_t id = 0; id < 1000; ++id)
+        index.add(id, "Homework " + std::to_string(id));
+    const std::size_t before = index.postingBytes();
+
+    for (std::uint32_t id = 0; id < 1000; ++id) {
+        if (id % 10 != 0)
+            index.remove(id);
+    }
+    EXPECT_EQ(index.size(), 100u);
+    EXPECT_LT(index.postingBytes(), before);
+
+    auto found = index.search("homework");
+    ASSERT_EQ(found.size(), 100u);
+    for (std::size_t i = 0; i < found.size(); ++i)
+        EXPECT_EQ(found[i], i * 10);
+    EXPECT_EQ(index.search("work 990"), (Ids{990}));
+}
+
+// Test misspelt queries find the closest texts, best first
+TEST(TextIndexTest, Fuzzy) {
+    Planner::TextIndex index;
+    index.add(0, "Project proposal");
+    index.add(1, "Lab report");
+    index.add(2, "Final project");
+    index.add(3, "History essay");
+
+    auto found = index.searchFuzzy("projcet");
+    ASSERT_GE(found.size(), 2u);
+    EXPECT_EQ(found[0].id, 2u); // Shorter text wins a tie
+    EXPECT_EQ(found[1].id, 0u);
+    for (const auto& match : found)
+        EXPECT_NE(match.id, 3u);
+
+    EXPECT_TRUE(index.searchFuzzy("zzzz").empty());
+    EXPECT_EQ(index.searchFuzzy("lab reprot", 1).size(), 1u);
+    EXPECT_EQ(index.searchFuzzy("lab reprot", 1)[0].id, 1u);
+}
+
+// Test assignments are found by name and by subject under their handles
+TEST(TextIndexTest, Assignments) {
+    Planner::AssignmentStore assignments;
+    auto lab = assignments.emplace("Physics", "Lab 3", 5, 2, 10.0f, 2, false, 1);
+    auto essay = assignments.emplace("History", "Essay", 5, 2, 10.0f, 2, false, 1);
+
+    Planner::TextIndex index;
+    Planner::indexAssignments(index, assignments);
+    EXPECT_EQ(index.search("lab 3"), (Ids{lab}));
+    EXPECT_EQ(index.search("history"), (Ids{essay}));
+
+    // Name and subject are separate texts
+    EXPECT_TRUE(index.search("3 / phys").empty());
+    EXPECT_TRUE(index.search("3 p").empty());
+}
@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+#include "../include/trace.hpp"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+// Test spans are only recorded while tracing is on
+TEST(TraceTest, RecordsOnlyWhenEnabled) {
+    Planner::startTracing();
+    Planner::stopTracing();
+    {
+        PLANNER_TRACE_SCOPE("ignored");
+    }
+    EXPECT_EQ(Planner::traceEventCount(), 0);
+
+    Planner::startTracing();
+    {
+        PLANNER_TRACE_SCOPE("outer");
+        PLANNER_TRACE_SCOPE("inner");
+    }
+    Planner::stopTracing();
+
+#if PLANNER_TRACING
+    EXPECT_EQ(Planner::traceEventCount(), 2);
+#else
+    EXPECT_EQ(Planner::traceEventCount(), 0);
+#endif
+}
+
+// Test spans from several threads end up in one Chrome trace
+TEST(TraceTest, WriteTrace_ChromeFormat) {
+    Planner::startTracing();
+    {
+        PLANNER_TRACE_SCOPE("mainPhase");
+    }
+    std::thread worker([] { PLANNER_TRACE_SCOPE("workerPhase"); });
+    worker.join();
+    Planner::stopTracing();
+
+    const std::string filename = "test_trace.json";
+    ASSERT_TRUE(Planner::writeTrace(filename));
+
+    std::ifstream file(filename);
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::remove(filename.c_str());
+
+    EXPECT_NE(content.find("\"traceEvents\""), std::string::npos);
+#if PLANNER_TRACING
+    EXPECT_NE(content.find("\"name\":\"mainPhase\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(content.find("\"name\":\"workerPhase\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(content.find("\"tid\":2"), std::string::npos);
+#endif
+}
@@ -0,0 +1,171 @@
+#include "gtest/gtest.h"
+#include "../include/userdatabase.hpp"
+#include "../include/planner.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static const char* DatabaseFile = "test_userdatabase.db";
+
+// Test records survive reopening and can grow and shrink in place
+TEST(UserDatabaseTest, WriteReadReopen) {
+    std::remove(DatabaseFile);
+    {
+        Planner::UserDatabase database(DatabaseFile);
+        ASSERT_TRUE(database.isOpen());
+        EXPECT_TRUE(database.write("alice", "short"));
+        EXPECT_TRUE(database.write("bob", std::string(10000, 'b')));
+        EXPECT_TRUE(database.write("alice", std::string(9000, 'a')));
+        EXPECT_TRUE(database.write("bob", "tiny"));
+        EXPECT_FALSE(database.contains("carol"));
+    }
+
+    Planner::UserDatabase database(DatabaseFile);
+    ASSERT_TRUE(database.isOpen());
+    EXPECT_EQ(database.userCount(), 2);
+
+    std::string record;
+    ASSERT_TRUE(database.read("alice", record));
+    EXPECT_EQ(record, std::string(9000, 'a'));
+    ASSERT_TRUE(database.read("bob", record));
+    EXPECT_EQ(record, "tiny");
+    EXPECT_FALSE(database.read("carol", record));
+    std::remove(DatabaseFile);
+}
+
+// Test thousands of users split the tree and still come back in name order
+TEST(UserDatabaseTest, ManyUsers_SortedScan) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+
+    std::vector<std::string> names;
+    for (int i = 0; i < 5000; ++i) {
+        std::string name = "user_" + std::to_string((i * 7919) % 5000);
+        names.push_back(name);
+        ASSERT_TRUE(database.write(name, "record of " + name));
+    }
+    std::sort(names.begin(), names.end());
+
+    EXPECT_EQ(database.userCount(), 5000);
+    EXPECT_EQ(database.userNames(), names);
+
+    std::size_t visited = 0;
+    database.forEachUser([&](const std::string& name, const std::string& record) {
+        EXPECT_EQ(name, names[visited]);
+        EXPECT_EQ(record, "record of " + name);
+        ++visited;
+    });
+    EXPECT_EQ(visited, names.size());
+
+    std::string record;
+    ASSERT_TRUE(database.read("user_4321", record));
+    EXPECT_EQ(record, "record of user_4321");
+    std::remove(DatabaseFile);
+}
+
+// Test rewriting a user reuses the pages freed by earlier commits instead of growing the file
+TEST(UserDatabaseTest, UpdatesReusePages) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+    database.write("alice", std::string(20000, 'x'));
+    database.write("alice", std::string(20000, 'x')); // The first copy is still in use until this commits
+    std::uint32_t pages = database.pageCount();
+
+    for (int i = 0; i < 50; ++i)
+        database.write("alice", std::string(i % 2 ? 20000 : 3000, 'y'));
+    EXPECT_EQ(database.pageCount(), pages);
+
+    EXPECT_FALSE(database.write("", "nameless"));
+    EXPECT_FALSE(database.write(std::string(Planner::UserDatabase::MaxUserNameLength + 1, 'n'), "too long"));
+    std::remove(DatabaseFile);
+}
+
+// Test a torn header slot falls back to the previous commit, whose pages a later write left alone
+TEST(UserDatabaseTest, TornHeaderKeepsPreviousCommit) {
+    std::remove(DatabaseFile);
+    {
+        Planner::UserDatabase database(DatabaseFile);
+        ASSERT_TRUE(database.write("alice", std::string(9000, 'a')));
+        ASSERT_TRUE(database.write("alice", std::string(5000, 'b')));
+    }
+
+    // Slots alternate, so the newest commit is in the slot the previous one did not use
+    std::vector<unsigned char> header(Planner::UserDatabase::PageSize);
+    std::FILE* file = std::fopen(DatabaseFile, "r+b");
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(std::fread(header.data(), 1, header.size(), file), header.size());
+    int newest = header[128 + 32] > header[32] ? 1 : 0;
+    std::fseek(file, newest * 128 + 20, SEEK_SET);
+    std::fputs("torn", file);
+    std::fclose(file);
+
+    Planner::UserDatabase database(DatabaseFile);
+    ASSERT_TRUE(database.isOpen());
+    std::string record;
+    ASSERT_TRUE(database.read("alice", record));
+    EXPECT_EQ(record, std::string(9000, 'a'));
+
+    ASSERT_TRUE(database.write("bob", "after recovery"));
+    ASSERT_TRUE(database.read("alice", record));
+    EXPECT_EQ(record, std::string(9000, 'a'));
+    std::remove(DatabaseFile);
+}
+
+// Test compressed records read back as written and stay compressed when rewritten
+TEST(UserDatabaseTest, CompressedRecords) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+
+    std::string record = "{\"epoch\":0}\n";
+    for (int i = 0; i < 2000; ++i)
+        record += "{\"name\":\"Homework " + std::to_string(i) + "\",\"subject\":\"Math\"}\n";
+    ASSERT_TRUE(database.write("alice", record, true));
+    ASSERT_TRUE(database.write("bob", record));
+    EXPECT_TRUE(database.isCompressed("alice"));
+    EXPECT_FALSE(database.isCompressed("bob"));
+
+    std::string read;
+    ASSERT_TRUE(database.read("alice", read));
+    EXPECT_EQ(read, record);
+    ASSERT_TRUE(database.readPrefix("alice", '\n', read));
+    EXPECT_EQ(read, "{\"epoch\":0}");
+
+    // A plain write keeps a compressed record compressed
+    std::uint32_t pages = database.pageCount();
+    ASSERT_TRUE(database.write("alice", record + "{}\n"));
+    EXPECT_TRUE(database.isCompressed("alice"));
+    ASSERT_TRUE(database.read("alice", read));
+    EXPECT_EQ(read, record + "{}\n");
+    EXPECT_LT(database.pageCount(), pages + record.size() / Planner::UserDatabase::PageSize);
+    std::remove(DatabaseFile);
+}
+
+// Test a plan saved to the database loads back like a plan file
+TEST(UserDatabaseTest, PlannerLoadSave) {
+    std::remove(DatabaseFile);
+    Planner::UserDatabase database(DatabaseFile);
+
+    Planner::AssignmentStore assignments;
+    assignments.emplace("Math", "Homework 1", 5, 4, 20.0f, 2, false, 1);
+    assignments.emplace("Physics", "Lab Report", 3, 6, 25.0f, 3, true, 2);
+    Planner::saveToFile(database, "alice", assignments);
+
+    auto loaded = Planner::loadFromFile(database, "alice");
+    ASSERT_EQ(loaded.size(), 2);
+    EXPECT_EQ(loaded[loaded.handles()[0]].getName(), "Homework 1");
+    EXPECT_EQ(loaded[loaded.handles()[0]].getDeadline(), 5);
+    EXPECT_EQ(loaded[loaded.handles()[1]].getGroupSize(), 2);
+
+    EXPECT_TRUE(Planner::loadFromFile(database, "nobody").empty());
+    std::remove(DatabaseFile);
+}
+
+// Test a file that is not a database is refused
+TEST(UserDatabaseTest, RejectsForeignFile) {
+    Planner::AssignmentStore assignments;
+    Planner::saveToFile(DatabaseFile, assignments);
+    Planner::UserDatabase database(DatabaseFile);
+    EXPECT_FALSE(database.isOpen());
+    std::remove(DatabaseFile);
+}
@@ -0,0 +1,192 @@
+// Moves users between the single-file database and the legacy layout of
+// one JSON file per user.
+//
+//   planner_db import DB FILE...          add or replace users from user files
+//   planner_db export DB DIR [--compress] write every user to DIR/<name>.json(.gz)
+//   planner_db list DB                    print every user name in order
+//   planner_db query DB EXPR              print every assignment matching a filter
+//   planner_db search DB TEXT             find assignments by part of their name or subject
+//
+// A user's name is their file name without .json or .json.gz.
+
+#include "../include/planner.hpp"
+#include "../include/batchio.hpp"
+#include "../include/gzipstream.hpp"
+#include "../include/filter.hpp"
+#include "../include/lazyplan.hpp"
+#include "../include/textindex.hpp"
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    // User name of a legacy user file
+    std::string userNameOf(const std::string& path) {
+        std::string name = std::filesystem::path(path).filename().string();
+        for (const char* suffix : {".json.gz", ".json"}) {
+            std::size_t length = std::strlen(suffix);
+            if (name.size() > length && name.compare(name.size() - length, length, suffix) == 0)
+                return name.substr(0, name.size() - length);
+        }
+        return name;
+    }
+
+    // User files are read in batches, and each is parsed as soon as it is in
+    int importUsers(Planner::UserDatabase& database, int count, char** files) {
+        int failures = 0;
+        std::vector<std::string> paths;
+        for (int i = 0; i < count; ++i) {
+            if (userNameOf(files[i]).size() > Planner::UserDatabase::MaxUserNameLength) {
+                std::cerr << "Skipping " << files[i] << "\n";
+                ++failures;
+                continue;
+            }
+            paths.push_back(files[i]);
+        }
+
+        Planner::BatchReader reader(std::move(paths));
+        Planner::FileData file;
+        while (reader.next(file)) {
+            if (!file.ok) {
+                std::cerr << "Skipping " << file.path << "\n";
+                ++failures;
+                continue;
+            }
+            std::string userName = userNameOf(file.path);
+            if (!database.write(userName, Planner::formatPlanRecord(Planner::parsePlanFile(file.data)))) {
+                std::cerr << "Error: Could not save " << userName << " to the database.\n";
+                ++failures;
+            }
+        }
+        std::cout << "Imported " << (count - failures) << " users, database holds " << database.userCount() << "\n";
+        return failures == 0 ? 0 : 1;
+    }
+
+    int exportUsers(Planner::UserDatabase& database, const std::string& directory, bool compress) {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+
+        // Files are written in batches while the next users are formatted
+        Planner::BatchWriter writer;
+        std::size_t exported = 0;
+        for (const std::string& name : database.userNames()) {
+            std::string contents = Planner::formatPlanFile(Planner::loadFromFile(database, name));
+            writer.add(directory + "/" + name + (compress ? ".json.gz" : ".json"),
+                       compress ? Planner::gzipCompress(contents) : std::move(contents));
+            ++exported;
+        }
+        std::size_t failures = writer.finish();
+        for (const std::string& path : writer.failures())
+            std::cerr << "Error: Could not write " << path << "\n";
+        std::cout << "Exported " << (exported - failures) << " users to " << directory << "\n";
+        return failures == 0 ? 0 : 1;
+    }
+
+    // The filter is parsed once and run over each user's plan in turn
+    int queryUsers(Planner::UserDatabase& database, const std::string& expression) {
+        Planner::AssignmentFilter filter(expression);
+        std::size_t matches = 0;
+        database.forEachUser([&](const std::string& userName, const std::string& record) {
+            Planner::AssignmentStore assignments = Planner::parsePlanRecord(record);
+            const auto& handles = assignments.handles();
+            for (std::uint32_t row : filter.select(Planner::makeAssignmentColumns(assignments))) {
+                const Assignment& assignment = assignments[handles[row]];
+                std::cout << userName << "\t" << assignment.getSubject() << "\t" << assignment.getName() << "\n";
+                ++matches;
+            }
+        });
+        std::cerr << matches << " matching assignments\n";
+        return 0;
+    }
+
+    std::string lowercase(std::string text) {
+        for (char& c : text)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return text;
+    }
+
+    // Every record is parsed anyway, so one pass comparing the text beats
+    // building an index that is used once. Only when nothing matches are
+    // the assignments indexed, to find similar ones.
+    int searchUsers(Planner::UserDatabase& database, const std::string& text) {
+        const std::string fragment = lowercase(text);
+        std::size_t matches = 0;
+        database.forEachUser([&](const std::string& userName, const std::string& record) {
+            Planner::AssignmentStore assignments = Planner::parsePlanRecord(record);
+            for (Planner::AssignmentHandle handle : assignments.handles()) {
+                const Assignment& assignment = assignments[handle];
+                if (lowercase(assignment.getName()).find(fragment) == std::string::npos &&
+                    lowercase(assignment.getSubject()).find(fragment) == std::string::npos)
+                    continue;
+                std::cout << userName << "\t" << assignment.getSubject() << "\t" << assignment.getName() << "\n";
+                ++matches;
+            }
+        });
+
+        if (matches == 0) {
+            struct Found {
+                std::string userName;
+                std::string subject;
+                std::string name;
+            };
+            std::vector<Found> corpus;
+            Planner::TextIndex index;
+            database.forEachUser([&](const std::string& userName, const std::string& record) {
+                Planner::AssignmentStore assignments = Planner::parsePlanRecord(record);
+                for (Planner::AssignmentHandle handle : assignments.handles()) {
+                    const Assignment& assignment = assignments[handle];
+                    index.add(static_cast<std::uint32_t>(corpus.size()), Planner::searchableFields(assignment));
+                    corpus.push_back({userName, assignment.getSubject(), assignment.getName()});
+                }
+            });
+            for (const auto& match : index.searchFuzzy(text)) {
+                const Found& found = corpus[match.id];
+                std::cout << found.userName << "\t" << found.subject << "\t" << found.name << "\t(similar)\n";
+            }
+        }
+        std::cerr << matches << " matching assignments\n";
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: planner_db import DB FILE...\n"
+                     "       planner_db export DB DIR [--compress]\n"
+                     "       planner_db list DB\n"
+                     "       planner_db query DB EXPR\n"
+                     "       planner_db search DB TEXT\n";
+        return 1;
+    }
+
+    std::string command = argv[1];
+    Planner::UserDatabase database(argv[2]);
+    if (!database.isOpen())
+        return 1;
+
+    if (command == "import")
+        return importUsers(database, argc - 3, argv + 3);
+    if (command == "export" && argc >= 4)
+        return exportUsers(database, argv[3], argc >= 5 && !std::strcmp(argv[4], "--compress"));
+    if (command == "query" && argc >= 4) {
+        try {
+            return queryUsers(database, argv[3]);
+        } catch (const std::invalid_argument& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+    if (command == "search" && argc >= 4)
+        return searchUsers(database, argv[3]);
+    if (command == "list") {
+        for (const std::string& name : database.userNames())
+            std::cout << name << "\n";
+        return 0;
+    }
+
+    std::cerr << "Unknown command: " << command << "\n";
+    return 1;
+}
@@ -0,0 +1,226 @@
+// Synthetic dataset generator: writes user files in the planner's save
+// format with configurable sizes and distributions, deterministic from a seed.
+//
+//   planner_gen [--out DIR] [--users N] [--prefix NAME] [--assignments N]
+//               [--seed S] [--epoch DAY] [--subjects Math:3,Physics:1,...]
+//               [--deadline MIN:MAX] [--duration MIN:MAX] [--weight MIN:MAX]
+//               [--size MIN:MAX] [--group-prob P] [--group-size MIN:MAX]
+//
+// With one user the file is DIR/NAME.json, otherwise DIR/NAME_<i>.json.
+// The epoch defaults to today; pass --epoch to make the files byte-identical
+// across days.
+
+#include "../include/calendar.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    // splitmix64: tiny, fast, and identical on every platform, unlike the
+    // standard library distributions
+    class Random {
+    public:
+        explicit Random(std::uint64_t seed) : state(seed) {}
+
+        std::uint64_t next() {
+            std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        // Uniform integer in [low, high]
+        long long between(long long low, long long high) {
+            return low + static_cast<long long>(next() % static_cast<std::uint64_t>(high - low + 1));
+        }
+
+        // Uniform real in [0, 1)
+        double unit() {
+            return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+    private:
+        std::uint64_t state;
+    };
+
+    struct Range {
+        long long low;
+        long long high;
+    };
+
+    struct Subject {
+        std::string name;
+        long long weight;
+    };
+
+    struct Options {
+        std::string out = "Data";
+        std::string prefix = "user";
+        long long users = 1;
+        long long assignments = 100;
+        std::uint64_t seed = 1;
+        int epoch = Planner::today();
+        std::vector<Subject> subjects = {{"Math", 1}, {"Physics", 1}, {"Chemistry", 1},
+                                         {"History", 1}, {"Programming", 1}, {"Literature", 1}};
+        Range deadline = {1, 60};
+        Range duration = {1, 20};
+        Range weight = {5, 30};
+        Range size = {1, 3};
+        double groupProbability = 0.2;
+        Range groupSize = {2, 5};
+    };
+
+    bool parseRange(const char* text, Range& range) {
+        char* end;
+        range.low = std::strtoll(text, &end, 10);
+        if (*end != ':')
+            return false;
+        range.high = std::strtoll(end + 1, &end, 10);
+        return *end == '\0' && range.low <= range.high;
+    }
+
+    bool parseSubjects(const std::string& text, std::vector<Subject>& subjects) {
+        subjects.clear();
+        std::size_t start = 0;
+        while (start <= text.size()) {
+            std::size_t comma = text.find(',', start);
+            std::string item = text.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+            std::size_t colon = item.find(':');
+
+            Subject subject{item.substr(0, colon), 1};
+            if (colon != std::string::npos)
+                subject.weight = std::atoll(item.c_str() + colon + 1);
+            if (subject.name.empty() || subject.name.find_first_of("\"\\") != std::string::npos || subject.weight <= 0)
+                return false;
+            subjects.push_back(subject);
+
+            if (comma == std::string::npos)
+                break;
+            start = comma + 1;
+        }
+        return !subjects.empty();
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const char* flag = argv[i];
+            if (i + 1 >= argc)
+                return false;
+            const char* value = argv[++i];
+
+            bool ok = true;
+            if (!std::strcmp(flag, "--out"))
+                options.out = value;
+            else if (!std::strcmp(flag, "--prefix"))
+                options.prefix = value;
+            else if (!std::strcmp(flag, "--users"))
+                ok = (options.users = std::atoll(value)) > 0;
+            else if (!std::strcmp(flag, "--assignments"))
+                ok = (options.assignments = std::atoll(value)) >= 0;
+            else if (!std::strcmp(flag, "--seed"))
+                options.seed = std::strtoull(value, nullptr, 10);
+            else if (!std::strcmp(flag, "--epoch"))
+                options.epoch = std::atoi(value);
+            else if (!std::strcmp(flag, "--subjects"))
+                ok = parseSubjects(value, options.subjects);
+            else if (!std::strcmp(flag, "--deadline"))
+                ok = parseRange(value, options.deadline);
+            else if (!std::strcmp(flag, "--duration"))
+                ok = parseRange(value, options.duration) && options.duration.low >= 1;
+            else if (!std::strcmp(flag, "--weight"))
+                ok = parseRange(value, options.weight);
+            else if (!std::strcmp(flag, "--size"))
+                ok = parseRange(value, options.size);
+            else if (!std::strcmp(flag, "--group-prob"))
+                options.groupProbability = std::atof(value);
+            else if (!std::strcmp(flag, "--group-size"))
+                ok = parseRange(value, options.groupSize) && options.groupSize.low >= 1;
+            else
+                ok = false;
+
+            if (!ok) {
+                std::cerr << "Invalid option: " << flag << " " << value << "\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Write one user file without building it in memory, so ten million
+    // assignments need no more memory than ten
+    bool writeUser(const Options& options, const std::string& path, std::uint64_t seed) {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            std::cerr << "Error: Could not open file " << path << " for writing.\n";
+            return false;
+        }
+
+        long long totalWeight = 0;
+        for (const Subject& subject : options.subjects)
+            totalWeight += subject.weight;
+
+        Random random(seed);
+        std::fprintf(file, "{\n    \"epoch\": %d,\n    \"assignments\": [", options.epoch);
+
+        for (long long i = 0; i < options.assignments; ++i) {
+            long long pick = random.between(0, totalWeight - 1);
+            const Subject* subject = &options.subjects.back();
+            for (const Subject& candidate : options.subjects) {
+                if (pick < candidate.weight) {
+                    subject = &candidate;
+                    break;
+                }
+                pick -= candidate.weight;
+            }
+
+            long long deadline = random.between(options.deadline.low, options.deadline.high);
+            long long duration = random.between(options.duration.low, options.duration.high);
+            double weight = options.weight.low + random.unit() * static_cast<double>(options.weight.high - options.weight.low);
+            long long size = random.between(options.size.low, options.size.high);
+            bool groupWork = random.unit() < options.groupProbability;
+            long long groupSize = groupWork ? random.between(options.groupSize.low, options.groupSize.high) : 1;
+
+            std::fprintf(file,
+                         "%s\n        {\"subject\": \"%s\", \"name\": \"Assignment %lld\", \"deadline\": %lld, "
+                         "\"duration\": %lld, \"weight\": %.2f, \"size\": %lld, \"group_work\": %s, \"group_size\": %lld}",
+                         i == 0 ? "" : ",", subject->name.c_str(), i, deadline, duration, weight, size,
+                         groupWork ? "true" : "false", groupSize);
+        }
+
+        std::fprintf(file, "\n    ]\n}\n");
+        bool ok = std::ferror(file) == 0;
+        ok = std::fclose(file) == 0 && ok;
+        if (!ok)
+            std::cerr << "Error: Failed writing " << path << "\n";
+        return ok;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: planner_gen [--out DIR] [--users N] [--prefix NAME] [--assignments N] [--seed S]\n"
+                     "                   [--epoch DAY] [--subjects A:w,B:w] [--deadline MIN:MAX] [--duration MIN:MAX]\n"
+                     "                   [--weight MIN:MAX] [--size MIN:MAX] [--group-prob P] [--group-size MIN:MAX]\n";
+        return 1;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(options.out, error);
+
+    for (long long user = 0; user < options.users; ++user) {
+        std::string name = options.users == 1 ? options.prefix : options.prefix + "_" + std::to_string(user);
+
+        // Each user has its own stream, so any one file can be regenerated alone
+        std::uint64_t seed = options.seed * 0x9E3779B97F4A7C15ULL + static_cast<std::uint64_t>(user);
+        if (!writeUser(options, options.out + "/" + name + ".json", seed))
+            return 1;
+    }
+
+    return 0;
+}
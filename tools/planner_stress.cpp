@@ -0,0 +1,189 @@
+// Stress driver: runs load -> schedule -> save -> ICS for generated users
+// and fails when the run exceeds its time or peak memory budget.
+//
+//   planner_stress [--prefix NAME] [--users N] [--engine priority|edf]
+//                  [--io stream|batch|batch-stream] [--max-seconds S]
+//                  [--max-rss-mb M] [--trace FILE] [--mem-report]
+//
+// User files are read from Data/ in the working directory, named like
+// planner_gen names them. Schedules go to Data/<user>_schedule.ics.
+//
+// --io batch reads every user file and previous calendar through a
+// BatchReader and writes through a BatchWriter (io_uring where available),
+// scheduling each user as soon as both of their files are in; the plan
+// listing is not printed. batch-stream does the same over iostreams.
+
+#include "../include/planner.hpp"
+#include "../include/batchio.hpp"
+#include "../include/trace.hpp"
+#include "../include/memtrack.hpp"
+#include <sys/resource.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    // Peak resident set size of this process in megabytes
+    double peakRssMegabytes() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<double>(usage.ru_maxrss) / 1024.0; // ru_maxrss is in kilobytes on Linux
+    }
+
+    std::string userName(const std::string& prefix, long long users, long long user) {
+        return users == 1 ? prefix : prefix + "_" + std::to_string(user);
+    }
+
+    // A user's files as they come in from the batch reader
+    struct UserFiles {
+        std::string plan;
+        std::string feed;
+        int arrived = 0;
+    };
+
+    // Load, schedule and save every user with batched file I/O
+    std::size_t runBatch(const std::string& prefix, long long users, Planner::SchedulerEngine engine,
+                         Planner::IoBackend backend) {
+        // Plan file of user i at 2i, their previous calendar at 2i + 1
+        std::vector<std::string> paths;
+        paths.reserve(static_cast<std::size_t>(users) * 2);
+        for (long long user = 0; user < users; ++user) {
+            std::string name = userName(prefix, users, user);
+            paths.push_back("Data/" + name + ".json");
+            paths.push_back("Data/" + name + "_schedule.ics");
+        }
+
+        Planner::BatchReader reader(paths, backend);
+        Planner::BatchWriter writer(backend);
+        std::cerr << "Batch I/O through " << Planner::ioBackendName(reader.backend()) << "\n";
+
+        std::vector<UserFiles> pending(static_cast<std::size_t>(users));
+        std::size_t assignmentCount = 0;
+        Planner::FileData file;
+        while (reader.next(file)) {
+            std::size_t user = file.index / 2;
+            UserFiles& files = pending[user];
+            if (file.index % 2 == 0) {
+                if (!file.ok)
+                    std::cerr << "Error: Could not open file " << file.path << " for reading.\n";
+                files.plan = std::move(file.data);
+            } else {
+                files.feed = std::move(file.data); // A first run has no previous calendar
+            }
+            if (++files.arrived < 2)
+                continue;
+
+            // Taken out of pending so their buffers are freed with this user
+            std::string plan = std::move(files.plan);
+            std::string feed = std::move(files.feed);
+            auto assignments = Planner::parsePlanFile(plan);
+            assignmentCount += assignments.size();
+            writer.add(paths[2 * user + 1], Planner::scheduleCalendar(assignments, 6, 8, engine, feed));
+            writer.add(paths[2 * user], Planner::formatPlanFile(assignments));
+        }
+
+        if (writer.finish() != 0)
+            std::cerr << "Error: " << writer.failures().size() << " files could not be written\n";
+        return assignmentCount;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string prefix = "user";
+    long long users = 1;
+    double maxSeconds = 60.0;
+    double maxRssMegabytes = 1024.0;
+    auto engine = Planner::SchedulerEngine::Priority;
+    std::string tracePath;
+    bool memoryReport = false;
+    std::string io = "stream";
+
+    for (int i = 1; i < argc; ++i) {
+        const char* flag = argv[i];
+        if (!std::strcmp(flag, "--mem-report")) {
+            memoryReport = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for option: " << flag << "\n";
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (!std::strcmp(flag, "--prefix"))
+            prefix = value;
+        else if (!std::strcmp(flag, "--users"))
+            users = std::atoll(value);
+        else if (!std::strcmp(flag, "--engine"))
+            engine = std::strcmp(value, "edf") ? Planner::SchedulerEngine::Priority : Planner::SchedulerEngine::EarliestDeadline;
+        else if (!std::strcmp(flag, "--max-seconds"))
+            maxSeconds = std::atof(value);
+        else if (!std::strcmp(flag, "--max-rss-mb"))
+            maxRssMegabytes = std::atof(value);
+        else if (!std::strcmp(flag, "--trace"))
+            tracePath = value;
+        else if (!std::strcmp(flag, "--io"))
+            io = value;
+        else {
+            std::cerr << "Unknown option: " << flag << "\n";
+            return 1;
+        }
+    }
+
+    // The per-hour console listing is not what is being measured
+    std::ofstream sink("/dev/null");
+    std::streambuf* console = std::cout.rdbuf(sink.rdbuf());
+
+    if (!tracePath.empty())
+        Planner::startTracing();
+    if (memoryReport)
+        Planner::startMemoryTracking();
+
+    auto start = std::chrono::steady_clock::now();
+    std::size_t assignmentCount = 0;
+    if (io == "batch" || io == "batch-stream") {
+        assignmentCount = runBatch(prefix, users, engine, io == "batch" ? Planner::IoBackend::Auto : Planner::IoBackend::Stream);
+    } else {
+        for (long long user = 0; user < users; ++user) {
+            std::string name = userName(prefix, users, user);
+            std::string userFile = "Data/" + name + ".json";
+
+            auto assignments = Planner::loadFromFile(userFile);
+            assignmentCount += assignments.size();
+            Planner::scheduler(assignments, 6, 8, name, engine);
+            Planner::saveToFile(userFile, assignments);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout.rdbuf(console);
+    if (!tracePath.empty()) {
+        Planner::stopTracing();
+        if (!Planner::writeTrace(tracePath))
+            std::cerr << "Could not write trace to " << tracePath << "\n";
+    }
+
+    double rss = peakRssMegabytes();
+    std::cout << users << " users, " << assignmentCount << " assignments: " << seconds << " s, peak RSS " << rss << " MB\n";
+    if (memoryReport) {
+        Planner::stopMemoryTracking();
+        Planner::writeMemoryReport(std::cout);
+    }
+
+    if (assignmentCount == 0) {
+        std::cerr << "No assignments were loaded\n";
+        return 1;
+    }
+    if (seconds > maxSeconds) {
+        std::cerr << "Time budget exceeded: " << seconds << " s > " << maxSeconds << " s\n";
+        return 1;
+    }
+    if (rss > maxRssMegabytes) {
+        std::cerr << "Memory budget exceeded: " << rss << " MB > " << maxRssMegabytes << " MB\n";
+        return 1;
+    }
+    return 0;
+}